@@ -18,7 +18,7 @@
 
 #	include "custom_array.hpp"
 
-#<array>
+#include <array>
 
 template <typename DATA_T, size_t size>
 using SimpleArray = std::array<DATA_T, size>;
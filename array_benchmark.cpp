@@ -0,0 +1,108 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Times appending to ManagedArray and the SIMD kernels behind Fill, Sum, Max and Find (with and without
+// SIMD, see arraykernels.hpp). Build it twice to compare the custom ManagedArray with the
+// std::vector based one from std_array.hpp, e.g. with:
+//   c++ -O2 -std=c++20 array_benchmark.cpp
+//   c++ -O2 -std=c++20 -DUSE_STD_VECTOR=1 array_benchmark.cpp
+// "exact growth" grows the buffer by one item per append, which is what resizing to the
+// required capacity every time amounts to; it runs on fewer items because it is quadratic.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "array.hpp"
+
+// =================================================================================================
+
+struct Payload {
+    int32_t values[8];
+
+    Payload(int32_t v = 0) {
+        std::fill(values, values + 8, v);
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+class Timer {
+    std::chrono::steady_clock::time_point   m_start;
+
+public:
+    Timer() : m_start(std::chrono::steady_clock::now()) {}
+
+    double Elapsed(void) const { // ms
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+template <typename DATA_T>
+static void BenchmarkAppend(const char* name, int n, bool reserve, bool exactGrowth)
+{
+    ManagedArray<DATA_T> a;
+    Timer timer;
+    if (reserve)
+        a.Reserve(n);
+    for (int i = 0; i < n; i++) {
+        if (exactGrowth)
+            a.Reserve(a.Length() + 1);
+        a.Append(DATA_T(i));
+    }
+    double tAppend = timer.Elapsed();
+    long long sum = 0;
+    for (int i = 0; i < a.Length(); i++)
+        sum += *reinterpret_cast<int32_t*>(a.Data(i));
+    Timer shrinkTimer;
+    for (int i = n / 2; i; i--)
+        a.Pop();
+    a.ShrinkToFit();
+    double tShrink = shrinkTimer.Elapsed();
+    fprintf(stderr, "%-24s %9d items: append %8.2f ms, pop half + shrink %8.2f ms (capacity %d, sum %lld)\n", name, n, tAppend, tShrink, a.Capacity(), sum);
+}
+
+//-----------------------------------------------------------------------------
+
+template <typename DATA_T>
+static void BenchmarkKernels(const char* name, int n, int rounds)
+{
+    ManagedArray<DATA_T> a;
+    a.Resize(n);
+    for (int simd = 1; simd >= 0; simd--) {
+        CpuFeatures::EnableSIMD(simd != 0);
+        Timer timer;
+        double result = 0;
+        for (int r = 0; r < rounds; r++) {
+            a.Fill(DATA_T(r & 63));
+            result += double(a.Sum()) + double(a.Max()) + a.Find(DATA_T(127)); // not found: scans all items
+        }
+        fprintf(stderr, "%-24s %9d items: fill + sum + max + find %8.2f ms %s (%g)\n", name, n, timer.Elapsed(), simd ? "SIMD" : "scalar", result);
+    }
+    CpuFeatures::EnableSIMD(true);
+}
+
+// =================================================================================================
+
+int main(int argc, char** argv)
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 10000000;
+#if (USE_STD || USE_STD_VECTOR)
+    fprintf(stderr, "std::vector based ManagedArray\n");
+#else
+    fprintf(stderr, "custom ManagedArray\n");
+#endif
+    BenchmarkAppend<int32_t>("int, geometric growth", n, false, false);
+    BenchmarkAppend<int32_t>("int, reserved", n, true, false);
+    BenchmarkAppend<Payload>("32 bytes, geometric", n / 4, false, false);
+    BenchmarkAppend<int32_t>("int, exact growth", std::min(n, 20000), false, true);
+    BenchmarkKernels<int32_t>("int kernels", 1 << 20, 100);
+    BenchmarkKernels<float>("float kernels", 1 << 20, 100);
+    return 0;
+}
+
+// =================================================================================================
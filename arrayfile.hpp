@@ -0,0 +1,435 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+#pragma once
+
+#include <bit>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#endif
+
+#include "array.hpp"
+
+// =================================================================================================
+// Persistence for arrays of trivially copyable items. An array file holds an ArrayFileHeader followed
+// by the items exactly as they are laid out in memory, so they can be used without conversion:
+// - ArrayFile writes an array to a file and reads it back into an array,
+// - MappedArray maps (a range of) the items of a file into memory and presents them as a read-only
+//   ManagedArray with a static buffer, without copying them,
+// - ArrayFileReader reads a file in chunks, for files that don't fit into memory.
+// The header records the item size and the byte order of the machine that wrote the file. Reading a
+// file with a different item size fails; ArrayFileReader (and thus ArrayFile::Read) swaps the bytes
+// of arithmetic items written with the other byte order, MappedArray can't and refuses such files.
+
+class ArrayFileHeader {
+public:
+	static constexpr uint8_t	currentVersion = 1;
+	static constexpr uint8_t	littleEndian = 1;
+	static constexpr uint8_t	bigEndian = 2;
+	static constexpr uint16_t	dataOffset = 64; // the items start here, so mapped items are aligned
+
+	char		magic[4];
+	uint8_t		version;
+	uint8_t		byteOrder;
+	uint16_t	headerSize;	// offset of the first item
+	uint32_t	itemSize;
+	uint32_t	reserved;
+	uint64_t	count;
+
+public:
+	ArrayFileHeader(uint32_t _itemSize = 0, uint64_t _count = 0)
+		: magic{ 'M', 'A', 'R', 'R' }, version(currentVersion), byteOrder(NativeByteOrder()), headerSize(dataOffset)
+		, itemSize(_itemSize), reserved(0), count(_count)
+	{
+	}
+
+
+	static inline uint8_t NativeByteOrder(void) {
+		return (std::endian::native == std::endian::little) ? littleEndian : bigEndian;
+	}
+
+
+	template <typename T>
+	static T SwapBytes(T value) {
+		uint8_t* bytes = reinterpret_cast<uint8_t*>(&value);
+		std::reverse(bytes, bytes + sizeof(T));
+		return value;
+	}
+
+
+	inline bool IsForeign(void) const {
+		return byteOrder != NativeByteOrder();
+	}
+
+
+	// check a header read from a file and bring its fields into native byte order
+	bool Validate(void) {
+		if (memcmp(magic, "MARR", 4) or (version != currentVersion) or ((byteOrder != littleEndian) and (byteOrder != bigEndian)))
+			return false;
+		if (IsForeign()) {
+			headerSize = SwapBytes(headerSize);
+			itemSize = SwapBytes(itemSize);
+			count = SwapBytes(count);
+		}
+		return headerSize >= sizeof(ArrayFileHeader);
+	}
+
+
+	// size a file needs to hold the header and all items; -1 if that doesn't fit into an int64_t
+	int64_t FileSize(void) const {
+		if (itemSize and (count > uint64_t(std::numeric_limits<int64_t>::max() - headerSize) / itemSize))
+			return -1;
+		return int64_t(headerSize) + int64_t(count * itemSize);
+	}
+};
+
+// =================================================================================================
+// Reads the items of an array file in chunks of a size chosen by the caller.
+
+template <typename DATA_T>
+class ArrayFileReader {
+	static_assert(std::is_trivially_copyable_v<DATA_T>, "array files can only hold trivially copyable items");
+
+private:
+	FILE*				m_file;
+	ArrayFileHeader		m_header;
+	int64_t				m_position;	// index of the next item to read
+	bool				m_swapBytes;
+
+	static inline bool SeekFile(FILE* file, int64_t offset) {
+#ifdef _WIN32
+		return _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+		return fseeko(file, off_t(offset), SEEK_SET) == 0;
+#endif
+	}
+
+public:
+	ArrayFileReader()
+		: m_file(nullptr), m_position(0), m_swapBytes(false)
+	{
+	}
+
+
+	~ArrayFileReader() {
+		Close();
+	}
+
+
+	ArrayFileReader(const ArrayFileReader&) = delete;
+	ArrayFileReader& operator=(const ArrayFileReader&) = delete;
+
+
+	bool Open(const char* filename) {
+		Close();
+#ifdef _WIN32
+		if (fopen_s(&m_file, filename, "rb"))
+			m_file = nullptr;
+#else
+		m_file = fopen(filename, "rb");
+#endif
+		if (not m_file)
+			return false;
+		if ((fread(&m_header, sizeof(m_header), 1, m_file) != 1) or not m_header.Validate() or (m_header.itemSize != sizeof(DATA_T)) or not SeekFile(m_file, m_header.headerSize)) {
+			Close();
+			return false;
+		}
+		if (m_header.IsForeign()) {
+			if constexpr (not std::is_arithmetic_v<DATA_T>) {
+				Close();
+				return false;
+			}
+			m_swapBytes = true;
+		}
+		return true;
+	}
+
+
+	void Close(void) {
+		if (m_file) {
+			fclose(m_file);
+			m_file = nullptr;
+		}
+		m_header = ArrayFileHeader();
+		m_position = 0;
+		m_swapBytes = false;
+	}
+
+
+	inline bool IsOpen(void) const {
+		return m_file != nullptr;
+	}
+
+
+	// number of items in the file
+	inline int64_t Count(void) const {
+		return m_file ? int64_t(m_header.count) : 0;
+	}
+
+
+	inline int64_t Position(void) const {
+		return m_position;
+	}
+
+
+	inline bool AtEnd(void) const {
+		return m_position >= Count();
+	}
+
+
+	// continue reading at item i
+	bool Seek(int64_t i) {
+		if (not m_file or (i < 0) or (i > Count()) or not SeekFile(m_file, m_header.headerSize + i * int64_t(sizeof(DATA_T))))
+			return false;
+		m_position = i;
+		return true;
+	}
+
+
+	// replace the contents of chunk with the next (up to) count items. Returns the number of items
+	// read, 0 at the end of the file and -1 on failure (including a file shorter than its header says).
+	int32_t Read(ManagedArray<DATA_T>& chunk, int32_t count) {
+		if (not m_file or (count < 0))
+			return -1;
+		count = int32_t(std::min(int64_t(count), Count() - m_position));
+		if (not chunk.Resize(count))
+			return count ? -1 : 0;
+		if (not count)
+			return 0;
+		int32_t n = int32_t(fread(chunk.Data(), sizeof(DATA_T), size_t(count), m_file));
+		if (m_swapBytes) {
+			DATA_T* items = chunk.Data();
+			for (int32_t i = 0; i < n; i++)
+				items[i] = ArrayFileHeader::SwapBytes(items[i]);
+		}
+		m_position += n;
+		if (n < count) {
+			chunk.Resize(n);
+			return -1;
+		}
+		return n;
+	}
+};
+
+// =================================================================================================
+
+template <typename DATA_T>
+class ArrayFile {
+	static_assert(std::is_trivially_copyable_v<DATA_T>, "array files can only hold trivially copyable items");
+
+public:
+	static bool Write(const char* filename, const DATA_T* data, int64_t count) {
+		if ((count < 0) or (count and not data))
+			return false;
+		FILE* file;
+#ifdef _WIN32
+		if (fopen_s(&file, filename, "wb"))
+			return false;
+#else
+		if (not (file = fopen(filename, "wb")))
+			return false;
+#endif
+		uint8_t header[ArrayFileHeader::dataOffset] = {};
+		ArrayFileHeader info(uint32_t(sizeof(DATA_T)), uint64_t(count));
+		memcpy(header, &info, sizeof(info));
+		bool ok = (fwrite(header, sizeof(header), 1, file) == 1) and (not count or (fwrite(data, sizeof(DATA_T), size_t(count), file) == size_t(count)));
+		return (fclose(file) == 0) and ok;
+	}
+
+
+	static inline bool Write(const char* filename, ManagedArray<DATA_T>& a) {
+		return Write(filename, a.Data(), a.Length());
+	}
+
+
+	// read all items of the file into a copy in a
+	static bool Read(const char* filename, ManagedArray<DATA_T>& a) {
+		ArrayFileReader<DATA_T> reader;
+		if (not reader.Open(filename) or (reader.Count() > std::numeric_limits<int32_t>::max()))
+			return false;
+		return reader.Read(a, int32_t(reader.Count())) == reader.Count();
+	}
+};
+
+// =================================================================================================
+// ManagedArray presenting items of an array file that is mapped into memory. The items are neither
+// copied nor loaded until they are accessed, and pages that haven't been written to can be dropped
+// by the system at any time, so this also works for files bigger than the memory available.
+// The mapping is read-only: writing to an item crashes. Reserve, Resize and Append move the items to
+// an ordinary buffer first (see ManagedArray::Reserve), which makes the array writable. Copying
+// or moving a MappedArray to another ManagedArray copies the items, so the copy outlives Close.
+// The std::vector based ManagedArray has no static buffers; with it, Open reads a copy of the items.
+
+template <typename DATA_T>
+class MappedArray : public ManagedArray<DATA_T> {
+	static_assert(std::is_trivially_copyable_v<DATA_T>, "array files can only hold trivially copyable items");
+	static_assert(ArrayFileHeader::dataOffset % alignof(DATA_T) == 0, "mapped items must be aligned");
+
+private:
+	void*		m_view;
+	size_t		m_viewSize;
+	int64_t		m_fileCount;
+
+public:
+	MappedArray()
+		: m_view(nullptr), m_viewSize(0), m_fileCount(0)
+	{
+	}
+
+
+	~MappedArray() {
+		Close();
+	}
+
+
+	MappedArray(const MappedArray&) = delete;
+	MappedArray& operator=(const MappedArray&) = delete;
+
+
+	// number of items in the file (the array may present only some of them)
+	inline int64_t FileCount(void) const {
+		return m_fileCount;
+	}
+
+
+	inline bool IsMapped(void) const {
+		return m_view != nullptr;
+	}
+
+
+	// present items [first, first + count) of the file; count == 0 presents all items from first on
+	bool Open(const char* filename, int64_t first = 0, int32_t count = 0) {
+		Close();
+#if (USE_STD || USE_STD_VECTOR)
+		ArrayFileReader<DATA_T> reader;
+		if (not reader.Open(filename))
+			return false;
+		m_fileCount = reader.Count();
+		if ((count = Range(m_fileCount, first, count)) < 0)
+			return false;
+		if (reader.Seek(first) and (reader.Read(*this, count) == count))
+			return true;
+		Close();
+		return false;
+#else
+		ArrayFileHeader header;
+#	ifdef _WIN32
+		HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		DWORD bytesRead;
+		LARGE_INTEGER fileSize;
+		bool ok = ReadFile(file, &header, sizeof(header), &bytesRead, nullptr) and (bytesRead == sizeof(header)) and GetFileSizeEx(file, &fileSize);
+		int64_t size = ok ? int64_t(fileSize.QuadPart) : 0;
+#	else
+		int file = open(filename, O_RDONLY);
+		if (file < 0)
+			return false;
+		struct stat fileInfo;
+		bool ok = (pread(file, &header, sizeof(header), 0) == ssize_t(sizeof(header))) and (fstat(file, &fileInfo) == 0);
+		int64_t size = ok ? int64_t(fileInfo.st_size) : 0;
+#	endif
+		// accessing mapped items beyond the end of a truncated file would crash, so such files are rejected
+		if (ok and header.Validate() and not header.IsForeign() and (header.itemSize == sizeof(DATA_T)) and (header.FileSize() >= 0) and (size >= header.FileSize())) {
+			m_fileCount = int64_t(header.count);
+			count = Range(m_fileCount, first, count);
+			ok = (count == 0) or ((count > 0) and Map(file, header.headerSize + first * int64_t(sizeof(DATA_T)), count));
+		}
+		else
+			ok = false;
+#	ifdef _WIN32
+		CloseHandle(file); // the view keeps the file open
+#	else
+		close(file);
+#	endif
+		if (not ok)
+			Close();
+		return ok;
+#endif
+	}
+
+
+	// release the array and the mapping
+	void Close(void) {
+		ManagedArray<DATA_T>::Destroy();
+		if (m_view) {
+#ifdef _WIN32
+			UnmapViewOfFile(m_view);
+#else
+			munmap(m_view, m_viewSize);
+#endif
+			m_view = nullptr;
+			m_viewSize = 0;
+		}
+		m_fileCount = 0;
+	}
+
+private:
+	// clip [first, first + count) to the items of the file; -1 if first is outside the file
+	static int32_t Range(int64_t fileCount, int64_t first, int32_t count) {
+		if ((first < 0) or (first > fileCount) or (count < 0))
+			return -1;
+		int64_t available = fileCount - first;
+		if (count and (count < available))
+			return count;
+		return (available > std::numeric_limits<int32_t>::max()) ? -1 : int32_t(available);
+	}
+
+
+#if !(USE_STD || USE_STD_VECTOR)
+	// map count items starting at byte offset of the file. Views have to start at a multiple of the
+	// allocation granularity, so the view may begin a little before the items.
+#	ifdef _WIN32
+	bool Map(HANDLE file, int64_t offset, int32_t count) {
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		int64_t start = offset - offset % int64_t(info.dwAllocationGranularity);
+		size_t viewSize = size_t(offset - start) + size_t(count) * sizeof(DATA_T);
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (not mapping)
+			return false;
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, DWORD(uint64_t(start) >> 32), DWORD(uint64_t(start) & 0xFFFFFFFF), viewSize);
+		CloseHandle(mapping); // the view keeps the mapping alive
+		if (not view)
+			return false;
+		return SetView(view, viewSize, offset - start, count);
+	}
+#	else
+	bool Map(int file, int64_t offset, int32_t count) {
+		int64_t start = offset - offset % int64_t(sysconf(_SC_PAGESIZE));
+		size_t viewSize = size_t(offset - start) + size_t(count) * sizeof(DATA_T);
+		void* view = mmap(nullptr, viewSize, PROT_READ, MAP_SHARED, file, off_t(start));
+		if (view == MAP_FAILED)
+			return false;
+		return SetView(view, viewSize, offset - start, count);
+	}
+#	endif
+
+
+	bool SetView(void* view, size_t viewSize, int64_t offset, int32_t count) {
+		m_view = view;
+		m_viewSize = viewSize;
+		this->SetBuffer(reinterpret_cast<DATA_T*>(static_cast<uint8_t*>(view) + offset), count, false);
+		return true;
+	}
+#endif
+};
+
+// =================================================================================================
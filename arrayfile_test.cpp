@@ -0,0 +1,190 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Checks array files (see arrayfile.hpp): writing an array and reading it back, mapping all items
+// or a range of them, reading a file in chunks, files with a foreign byte order, copies of a mapped
+// array that outlive the mapping, and truncated or damaged files, which must be rejected instead
+// of crashing when the missing items are accessed. Returns 0 if all checks pass. Build e.g. with:
+//   c++ -O2 -std=c++20 arrayfile_test.cpp
+
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+
+#include "arrayfile.hpp"
+
+// =================================================================================================
+
+static int failures = 0;
+
+static void Check(bool condition, const char* what) {
+    if (not condition) {
+        fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static std::string TempName(const char* name)
+{
+    const char* dir = getenv("TMPDIR");
+    return std::string((dir and *dir) ? dir : ".") + "/" + name;
+}
+
+//-----------------------------------------------------------------------------
+
+template <typename DATA_T>
+static bool Matches(ManagedArray<DATA_T>& a, int64_t first, int32_t count)
+{
+    if (a.Length() != count)
+        return false;
+    for (int32_t i = 0; i < count; i++)
+        if (a[i] != DATA_T(3 * (first + i) + 1))
+            return false;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+// copies the first size bytes of a file to another file
+static bool CopyFile(const std::string& from, const std::string& to, long size)
+{
+    FILE* in = fopen(from.c_str(), "rb");
+    FILE* out = fopen(to.c_str(), "wb");
+    bool ok = in and out;
+    for (int c; ok and (size-- > 0) and ((c = fgetc(in)) != EOF); )
+        ok = fputc(c, out) != EOF;
+    if (in)
+        fclose(in);
+    if (out)
+        ok = (fclose(out) == 0) and ok;
+    return ok;
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestReadWrite(const std::string& filename, int32_t n)
+{
+    ManagedArray<int64_t> a;
+    a.Resize(n);
+    for (int32_t i = 0; i < n; i++)
+        a[i] = 3 * i + 1;
+    Check(ArrayFile<int64_t>::Write(filename.c_str(), a), "ArrayFile::Write");
+
+    ManagedArray<int64_t> b;
+    Check(ArrayFile<int64_t>::Read(filename.c_str(), b) and Matches(b, 0, n), "ArrayFile::Read");
+    ManagedArray<int32_t> c;
+    Check(not ArrayFile<int32_t>::Read(filename.c_str(), c), "ArrayFile::Read rejects another item size");
+
+    ArrayFileReader<int64_t> reader;
+    bool chunksOk = reader.Open(filename.c_str()) and (reader.Count() == n);
+    ManagedArray<int64_t> chunk;
+    for (int64_t first = 0; chunksOk and not reader.AtEnd(); first += 1000)
+        chunksOk = (reader.Read(chunk, 1000) == std::min(int64_t(1000), n - first)) and Matches(chunk, first, chunk.Length());
+    Check(chunksOk and (reader.Read(chunk, 1000) == 0), "ArrayFileReader reads all chunks");
+    Check(reader.Seek(n / 2) and (reader.Read(chunk, 3) == 3) and Matches(chunk, n / 2, 3), "ArrayFileReader::Seek");
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestMapped(const std::string& filename, int32_t n)
+{
+    MappedArray<int64_t> m;
+    Check(m.Open(filename.c_str()) and (m.FileCount() == n) and Matches(m, 0, n), "MappedArray maps all items");
+    Check(m.Open(filename.c_str(), n - 10, 5) and Matches(m, n - 10, 5), "MappedArray maps a range");
+    Check(m.Open(filename.c_str(), n - 3, 10) and Matches(m, n - 3, 3), "MappedArray clips a range to the file");
+    Check(m.Open(filename.c_str(), n) and (m.Length() == 0), "MappedArray maps an empty range at the end");
+    Check(not m.Open(filename.c_str(), n + 1), "MappedArray rejects a range beyond the end");
+    MappedArray<int32_t> wrongType;
+    Check(not wrongType.Open(filename.c_str()), "MappedArray rejects another item size");
+
+    // copies must not refer to the view, which is gone after Close
+    Check(m.Open(filename.c_str(), 7, 100), "MappedArray maps a range to copy");
+    ManagedArray<int64_t> copy(m), assigned;
+    assigned = m;
+    ManagedArray<int64_t> moved(std::move(m));
+    m.Close();
+    Check(Matches(copy, 7, 100) and Matches(assigned, 7, 100) and Matches(moved, 7, 100), "copies of a MappedArray outlive Close");
+    copy[0] = 0; // would crash if copy still pointed into the read-only view
+    Check(copy[0] == 0, "copies of a MappedArray are writable");
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestForeignByteOrder(const std::string& filename)
+{
+    int32_t items[] = { 1, -2, 0x01020304 };
+    Check(ArrayFile<int32_t>::Write(filename.c_str(), items, 3), "ArrayFile::Write from a buffer");
+    // flip the byte order the header claims and the items' bytes
+    FILE* file = fopen(filename.c_str(), "r+b");
+    ArrayFileHeader header;
+    bool ok = file and (fread(&header, sizeof(header), 1, file) == 1);
+    if (ok) {
+        header.byteOrder = (header.byteOrder == ArrayFileHeader::littleEndian) ? ArrayFileHeader::bigEndian : ArrayFileHeader::littleEndian;
+        header.headerSize = ArrayFileHeader::SwapBytes(header.headerSize);
+        header.itemSize = ArrayFileHeader::SwapBytes(header.itemSize);
+        header.count = ArrayFileHeader::SwapBytes(header.count);
+        for (auto& item : items)
+            item = ArrayFileHeader::SwapBytes(item);
+        ok = (fseek(file, 0, SEEK_SET) == 0) and (fwrite(&header, sizeof(header), 1, file) == 1)
+             and (fseek(file, ArrayFileHeader::dataOffset, SEEK_SET) == 0) and (fwrite(items, sizeof(items), 1, file) == 1);
+    }
+    if (file)
+        ok = (fclose(file) == 0) and ok;
+    Check(ok, "foreign byte order file written");
+
+    ManagedArray<int32_t> a;
+    Check(ArrayFile<int32_t>::Read(filename.c_str(), a) and (a.Length() == 3) and (a[0] == 1) and (a[1] == -2) and (a[2] == 0x01020304),
+          "ArrayFile::Read swaps foreign bytes");
+#if !(USE_STD || USE_STD_VECTOR)
+    MappedArray<int32_t> m;
+    Check(not m.Open(filename.c_str()), "MappedArray rejects a foreign byte order");
+#endif
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestDamaged(const std::string& filename, const std::string& damaged, int32_t n)
+{
+    long fullSize = long(ArrayFileHeader::dataOffset + n * sizeof(int64_t));
+    MappedArray<int64_t> m;
+    ManagedArray<int64_t> a;
+    for (long size : { fullSize - 1, fullSize - long(sizeof(int64_t)) * (n / 2), long(ArrayFileHeader::dataOffset), long(sizeof(ArrayFileHeader)) - 1, 0L }) {
+        if (not CopyFile(filename, damaged, size)) {
+            Check(false, "truncated file written");
+            continue;
+        }
+        Check(not m.Open(damaged.c_str()) and (m.Length() == 0), "MappedArray rejects a truncated file");
+        Check(not m.Open(damaged.c_str(), 0, 1) or (size >= long(ArrayFileHeader::dataOffset + sizeof(int64_t))), "MappedArray rejects a range of a truncated file");
+        Check(not ArrayFile<int64_t>::Read(damaged.c_str(), a), "ArrayFile::Read rejects a truncated file");
+    }
+
+    CopyFile(filename, damaged, fullSize);
+    FILE* file = fopen(damaged.c_str(), "r+b");
+    bool ok = file and (fputc('X', file) != EOF);
+    if (file)
+        ok = (fclose(file) == 0) and ok;
+    Check(ok and not m.Open(damaged.c_str()) and not ArrayFile<int64_t>::Read(damaged.c_str(), a), "a file without the magic is rejected");
+    Check(not m.Open(TempName("arrayfile_test_missing.arr").c_str()), "MappedArray fails on a missing file");
+}
+
+// =================================================================================================
+
+int main()
+{
+    constexpr int32_t n = 10000;
+    std::string filename = TempName("arrayfile_test.arr");
+    std::string damaged = TempName("arrayfile_test_damaged.arr");
+    TestReadWrite(filename, n);
+    TestMapped(filename, n);
+    TestDamaged(filename, damaged, n);
+    TestForeignByteOrder(filename);
+    remove(filename.c_str());
+    remove(damaged.c_str());
+    fprintf(stderr, "%s\n", failures ? "arrayfile_test failed" : "arrayfile_test passed");
+    return failures ? 1 : 0;
+}
+
+// =================================================================================================
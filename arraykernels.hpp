@@ -0,0 +1,397 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+#pragma once
+
+#include <bit>
+#include <algorithm>
+#include <type_traits>
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#	define ARRAY_KERNELS_X86 1
+#	include <immintrin.h>
+#	ifdef _MSC_VER
+#		include <intrin.h>
+#		define AVX2_TARGET
+#	else
+#		define AVX2_TARGET __attribute__((target("avx2")))
+#	endif
+#else
+#	define ARRAY_KERNELS_X86 0
+#endif
+
+// =================================================================================================
+// Runtime detection of the instruction sets the array kernels can use. SIMD can be switched off,
+// e.g. to compare the kernels with their scalar fallbacks.
+
+class CpuFeatures {
+private:
+	static inline bool m_enableSIMD = true;
+
+	static bool DetectAVX2(void) {
+#if !ARRAY_KERNELS_X86
+		return false;
+#elif defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+		__cpuid(info, 1);
+		bool osSavesYmm = (info[2] & (1 << 27)) and (info[2] & (1 << 28)) and ((_xgetbv(0) & 6) == 6); // OSXSAVE, AVX, XMM and YMM state
+		if (not osSavesYmm)
+			return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+
+public:
+	static bool HasAVX2(void) {
+		static const bool hasAVX2 = DetectAVX2();
+		return hasAVX2;
+	}
+
+
+	static inline bool UseAVX2(void) {
+		return m_enableSIMD and HasAVX2();
+	}
+
+
+	static inline void EnableSIMD(bool enable) {
+		m_enableSIMD = enable;
+	}
+};
+
+// =================================================================================================
+// Fill, linear search, minimum/maximum, sum and comparison of arrays of arithmetic items.
+// Each kernel checks at runtime whether the CPU supports AVX2 and uses 256 bit vectors then;
+// otherwise (and on other architectures) it runs a plain loop, which the compiler vectorizes for
+// the baseline instruction set (SSE2 on x86-64) where it can.
+// Kernels without an AVX2 version for some item types (e.g. minimum and maximum of 64 bit integers)
+// always take the plain loop for them.
+// Floating point items are compared by value, so -0.0 equals 0.0 and NaN equals nothing. Min and
+// max of arrays containing NaN are unspecified. Sums of floating point items are accumulated in
+// double (in several lanes), so they can differ from a sequential sum in the last bits.
+
+template <typename DATA_T>
+class ArrayKernels {
+public:
+	// sums of integers are accumulated in 64 bits, sums of float in double
+	using SUM_T = std::conditional_t<std::is_floating_point_v<DATA_T>, std::common_type_t<DATA_T, double>, std::conditional_t<std::is_signed_v<DATA_T>, int64_t, uint64_t>>;
+
+private:
+	static constexpr bool isFloat = std::is_same_v<DATA_T, float>;
+	static constexpr bool isDouble = std::is_same_v<DATA_T, double>;
+	static constexpr bool isInteger = std::is_integral_v<DATA_T> and not std::is_same_v<DATA_T, bool>;
+	static constexpr bool hasVectors = isFloat or isDouble or isInteger;
+	static constexpr bool hasVectorMinMax = isFloat or isDouble or (isInteger and (sizeof(DATA_T) <= 4));
+	static constexpr bool hasVectorSum = isFloat or isDouble or (isInteger and ((sizeof(DATA_T) >= 4) or std::is_same_v<DATA_T, uint8_t>));
+	static constexpr int32_t lanes = 32 / int32_t(sizeof(DATA_T));
+
+	// ----------------------------------------
+
+	static void FillScalar(DATA_T* data, int32_t count, DATA_T value) {
+		std::fill(data, data + count, value);
+	}
+
+
+	static int32_t FindScalar(const DATA_T* data, int32_t count, DATA_T value) {
+		for (int32_t i = 0; i < count; i++)
+			if (data[i] == value)
+				return i;
+		return -1;
+	}
+
+
+	static bool EqualScalar(const DATA_T* a, const DATA_T* b, int32_t count) {
+		for (int32_t i = 0; i < count; i++)
+			if (a[i] != b[i])
+				return false;
+		return true;
+	}
+
+
+	static void MinMaxScalar(const DATA_T* data, int32_t count, DATA_T& minValue, DATA_T& maxValue) {
+		for (int32_t i = 0; i < count; i++) {
+			if (data[i] < minValue)
+				minValue = data[i];
+			if (data[i] > maxValue)
+				maxValue = data[i];
+		}
+	}
+
+
+	static SUM_T SumScalar(const DATA_T* data, int32_t count) {
+		SUM_T sum = SUM_T(0);
+		for (int32_t i = 0; i < count; i++)
+			sum += SUM_T(data[i]);
+		return sum;
+	}
+
+	// ----------------------------------------
+
+#if ARRAY_KERNELS_X86
+	AVX2_TARGET static inline __m256i Load(const DATA_T* p) {
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+	}
+
+
+	AVX2_TARGET static inline __m256i Broadcast(DATA_T value) {
+		if constexpr (sizeof(DATA_T) == 1)
+			return _mm256_set1_epi8(std::bit_cast<char>(value));
+		else if constexpr (sizeof(DATA_T) == 2)
+			return _mm256_set1_epi16(std::bit_cast<int16_t>(value));
+		else if constexpr (sizeof(DATA_T) == 4)
+			return _mm256_set1_epi32(std::bit_cast<int32_t>(value));
+		else
+			return _mm256_set1_epi64x(std::bit_cast<int64_t>(value));
+	}
+
+
+	// bits set for the items at p equal to value: one bit per item for floating point items, one bit
+	// per byte (in w, value broadcast to all lanes) for integers
+	AVX2_TARGET static inline uint32_t EqualMask(const DATA_T* p, DATA_T value, __m256i w) {
+		if constexpr (isFloat)
+			return uint32_t(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p), _mm256_set1_ps(value), _CMP_EQ_OQ)));
+		else if constexpr (isDouble)
+			return uint32_t(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(p), _mm256_set1_pd(value), _CMP_EQ_OQ)));
+		else if constexpr (sizeof(DATA_T) == 1)
+			return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Load(p), w)));
+		else if constexpr (sizeof(DATA_T) == 2)
+			return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi16(Load(p), w)));
+		else if constexpr (sizeof(DATA_T) == 4)
+			return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi32(Load(p), w)));
+		else
+			return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi64(Load(p), w)));
+	}
+
+
+	AVX2_TARGET static inline __m256i Min(__m256i a, __m256i b) {
+		if constexpr (std::is_same_v<DATA_T, int8_t> or (std::is_same_v<DATA_T, char> and std::is_signed_v<char>))
+			return _mm256_min_epi8(a, b);
+		else if constexpr (sizeof(DATA_T) == 1)
+			return _mm256_min_epu8(a, b);
+		else if constexpr ((sizeof(DATA_T) == 2) and std::is_signed_v<DATA_T>)
+			return _mm256_min_epi16(a, b);
+		else if constexpr (sizeof(DATA_T) == 2)
+			return _mm256_min_epu16(a, b);
+		else if constexpr (std::is_signed_v<DATA_T>)
+			return _mm256_min_epi32(a, b);
+		else
+			return _mm256_min_epu32(a, b);
+	}
+
+
+	AVX2_TARGET static inline __m256i Max(__m256i a, __m256i b) {
+		if constexpr (std::is_same_v<DATA_T, int8_t> or (std::is_same_v<DATA_T, char> and std::is_signed_v<char>))
+			return _mm256_max_epi8(a, b);
+		else if constexpr (sizeof(DATA_T) == 1)
+			return _mm256_max_epu8(a, b);
+		else if constexpr ((sizeof(DATA_T) == 2) and std::is_signed_v<DATA_T>)
+			return _mm256_max_epi16(a, b);
+		else if constexpr (sizeof(DATA_T) == 2)
+			return _mm256_max_epu16(a, b);
+		else if constexpr (std::is_signed_v<DATA_T>)
+			return _mm256_max_epi32(a, b);
+		else
+			return _mm256_max_epu32(a, b);
+	}
+
+	// ----------------------------------------
+
+	AVX2_TARGET static void FillAVX2(DATA_T* data, int32_t count, DATA_T value) {
+		__m256i v = Broadcast(value);
+		int32_t i = 0;
+		for (; i + lanes <= count; i += lanes)
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), v);
+		FillScalar(data + i, count - i, value);
+	}
+
+
+	AVX2_TARGET static int32_t FindAVX2(const DATA_T* data, int32_t count, DATA_T value) {
+		__m256i v = Broadcast(value);
+		int32_t i = 0;
+		for (; i + lanes <= count; i += lanes) {
+			uint32_t mask = EqualMask(data + i, value, v);
+			if (mask) {
+				if constexpr (isFloat or isDouble)
+					return i + std::countr_zero(mask);
+				else
+					return i + std::countr_zero(mask) / int32_t(sizeof(DATA_T));
+			}
+		}
+		int32_t j = FindScalar(data + i, count - i, value);
+		return (j < 0) ? -1 : i + j;
+	}
+
+
+	AVX2_TARGET static bool EqualAVX2(const DATA_T* a, const DATA_T* b, int32_t count) {
+		int32_t i = 0;
+		for (; i + lanes <= count; i += lanes) {
+			if constexpr (isFloat) {
+				if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), _CMP_EQ_OQ)) != 0xFF)
+					return false;
+			}
+			else if constexpr (isDouble) {
+				if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), _CMP_EQ_OQ)) != 0xF)
+					return false;
+			}
+			else if (uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Load(a + i), Load(b + i)))) != 0xFFFFFFFFu) // integers are equal if all their bytes are
+				return false;
+		}
+		return EqualScalar(a + i, b + i, count - i);
+	}
+
+
+	// count must be at least lanes
+	AVX2_TARGET static void MinMaxAVX2(const DATA_T* data, int32_t count, DATA_T& minValue, DATA_T& maxValue) {
+		alignas(32) DATA_T minLanes[lanes], maxLanes[lanes];
+		int32_t i = lanes;
+		if constexpr (isFloat) {
+			__m256 vMin = _mm256_loadu_ps(data), vMax = vMin;
+			for (; i + lanes <= count; i += lanes) {
+				__m256 v = _mm256_loadu_ps(data + i);
+				vMin = _mm256_min_ps(vMin, v);
+				vMax = _mm256_max_ps(vMax, v);
+			}
+			_mm256_store_ps(minLanes, vMin);
+			_mm256_store_ps(maxLanes, vMax);
+		}
+		else if constexpr (isDouble) {
+			__m256d vMin = _mm256_loadu_pd(data), vMax = vMin;
+			for (; i + lanes <= count; i += lanes) {
+				__m256d v = _mm256_loadu_pd(data + i);
+				vMin = _mm256_min_pd(vMin, v);
+				vMax = _mm256_max_pd(vMax, v);
+			}
+			_mm256_store_pd(minLanes, vMin);
+			_mm256_store_pd(maxLanes, vMax);
+		}
+		else {
+			__m256i vMin = Load(data), vMax = vMin;
+			for (; i + lanes <= count; i += lanes) {
+				__m256i v = Load(data + i);
+				vMin = Min(vMin, v);
+				vMax = Max(vMax, v);
+			}
+			_mm256_store_si256(reinterpret_cast<__m256i*>(minLanes), vMin);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(maxLanes), vMax);
+		}
+		minValue = *std::min_element(minLanes, minLanes + lanes);
+		maxValue = *std::max_element(maxLanes, maxLanes + lanes);
+		MinMaxScalar(data + i, count - i, minValue, maxValue);
+	}
+
+
+	AVX2_TARGET static SUM_T SumAVX2(const DATA_T* data, int32_t count) {
+		int32_t i = 0;
+		SUM_T sum;
+		if constexpr (isFloat or isDouble) {
+			__m256d acc = _mm256_setzero_pd();
+			for (; i + lanes <= count; i += lanes) {
+				if constexpr (isFloat) {
+					__m256 v = _mm256_loadu_ps(data + i);
+					acc = _mm256_add_pd(acc, _mm256_add_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(v)), _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1))));
+				}
+				else
+					acc = _mm256_add_pd(acc, _mm256_loadu_pd(data + i));
+			}
+			alignas(32) double partial[4];
+			_mm256_store_pd(partial, acc);
+			sum = SUM_T((partial[0] + partial[1]) + (partial[2] + partial[3]));
+		}
+		else {
+			__m256i acc = _mm256_setzero_si256(); // four 64 bit sums
+			for (; i + lanes <= count; i += lanes) {
+				__m256i v = Load(data + i);
+				if constexpr (sizeof(DATA_T) == 1) // sum of absolute differences to 0 adds up groups of eight bytes
+					acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, _mm256_setzero_si256()));
+				else if constexpr (sizeof(DATA_T) == 8) // wraps around like the scalar sum
+					acc = _mm256_add_epi64(acc, v);
+				else if constexpr (std::is_signed_v<DATA_T>)
+					acc = _mm256_add_epi64(acc, _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1))));
+				else
+					acc = _mm256_add_epi64(acc, _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(v)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1))));
+			}
+			alignas(32) uint64_t partial[4];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(partial), acc);
+			sum = SUM_T(partial[0] + partial[1] + partial[2] + partial[3]);
+		}
+		return sum + SumScalar(data + i, count - i);
+	}
+#endif
+
+	// ----------------------------------------
+
+public:
+	static void Fill(DATA_T* data, int32_t count, DATA_T value) {
+#if ARRAY_KERNELS_X86
+		if constexpr (hasVectors) {
+			if (CpuFeatures::UseAVX2())
+				return FillAVX2(data, count, value);
+		}
+#endif
+		FillScalar(data, count, value);
+	}
+
+
+	// index of the first item equal to value, or -1
+	static int32_t Find(const DATA_T* data, int32_t count, DATA_T value) {
+#if ARRAY_KERNELS_X86
+		if constexpr (hasVectors) {
+			if (CpuFeatures::UseAVX2())
+				return FindAVX2(data, count, value);
+		}
+#endif
+		return FindScalar(data, count, value);
+	}
+
+
+	static bool Equal(const DATA_T* a, const DATA_T* b, int32_t count) {
+#if ARRAY_KERNELS_X86
+		if constexpr (hasVectors) {
+			if (CpuFeatures::UseAVX2())
+				return EqualAVX2(a, b, count);
+		}
+#endif
+		return EqualScalar(a, b, count);
+	}
+
+
+	// false for an empty array
+	static bool MinMax(const DATA_T* data, int32_t count, DATA_T& minValue, DATA_T& maxValue) {
+		if (count <= 0)
+			return false;
+#if ARRAY_KERNELS_X86
+		if constexpr (hasVectorMinMax) {
+			if ((count >= lanes) and CpuFeatures::UseAVX2()) {
+				MinMaxAVX2(data, count, minValue, maxValue);
+				return true;
+			}
+		}
+#endif
+		minValue = maxValue = data[0];
+		MinMaxScalar(data + 1, count - 1, minValue, maxValue);
+		return true;
+	}
+
+
+	static SUM_T Sum(const DATA_T* data, int32_t count) {
+#if ARRAY_KERNELS_X86
+		if constexpr (hasVectorSum) {
+			if (CpuFeatures::UseAVX2())
+				return SumAVX2(data, count);
+		}
+#endif
+		return SumScalar(data, count);
+	}
+};
+
+// =================================================================================================
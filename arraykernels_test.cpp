@@ -0,0 +1,200 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Checks the array kernels (see arraykernels.hpp) with and without AVX2 against plain loops over
+// the same items: Fill, Find, Equal, MinMax and Sum for all arithmetic item types, with lengths
+// that aren't multiples of the vector size and items that don't start at a vector boundary, plus
+// the ManagedArray and Stack members built on them. Without AVX2 both runs take the scalar path.
+// Returns 0 if all checks pass. Build e.g. with:
+//   c++ -O2 -std=c++20 arraykernels_test.cpp
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+
+#include "array.hpp"
+#include "arraykernels.hpp"
+#if !(USE_STD || USE_STD_VECTOR)
+#   include "stack.hpp" // Stack requires the custom ManagedArray
+#endif
+
+// =================================================================================================
+
+static int failures = 0;
+
+static bool Check(bool condition, const char* what, const char* type = "", bool simd = false) {
+    if (not condition) {
+        fprintf(stderr, "FAILED: %s (%s%s)\n", what, type, simd ? ", AVX2" : "");
+        ++failures;
+    }
+    return condition;
+}
+
+static std::mt19937_64 rng(7);
+
+//-----------------------------------------------------------------------------
+
+// random items from a small range, so Find has something to find and sums of small types don't overflow
+template <typename DATA_T>
+static DATA_T RandomItem(void)
+{
+    if constexpr (std::is_floating_point_v<DATA_T>)
+        return DATA_T(int(rng() % 2001) - 1000) / DATA_T(8);
+    else if constexpr (sizeof(DATA_T) == 1)
+        return DATA_T(rng() % 100);
+    else if constexpr (std::is_signed_v<DATA_T> and (sizeof(DATA_T) == 8))
+        return DATA_T(int64_t(rng()) >> 12); // sums of 64 bit items are 64 bit; signed ones must not overflow
+    else
+        return DATA_T(rng());
+}
+
+//-----------------------------------------------------------------------------
+
+template <typename DATA_T>
+static bool SameSum(typename ArrayKernels<DATA_T>::SUM_T a, typename ArrayKernels<DATA_T>::SUM_T b)
+{
+    if constexpr (std::is_floating_point_v<DATA_T>)
+        return std::fabs(double(a) - double(b)) <= 1e-9 * (1.0 + std::fabs(double(b)));
+    else
+        return a == b;
+}
+
+//-----------------------------------------------------------------------------
+
+template <typename DATA_T>
+static void TestKernels(const char* type)
+{
+    using Kernels = ArrayKernels<DATA_T>;
+    for (int round = 0; round < 500; round++) {
+        int32_t count = int32_t(rng() % 300), start = int32_t(rng() % 4);
+        std::vector<DATA_T> buffer(start + count + 1), other;
+        for (auto& v : buffer)
+            v = RandomItem<DATA_T>();
+        other = buffer;
+        DATA_T* data = buffer.data() + start;
+        DATA_T value = count ? data[rng() % count] : DATA_T(1);
+
+        typename Kernels::SUM_T sum = 0;
+        for (int32_t i = 0; i < count; i++)
+            sum += data[i];
+        int32_t found = int32_t(std::find(data, data + count, value) - data);
+
+        for (bool simd : { false, true }) {
+            CpuFeatures::EnableSIMD(simd);
+            if (not Check(Kernels::Find(data, count, value) == ((found < count) ? found : -1), "Find", type, simd)
+                or not Check(SameSum<DATA_T>(Kernels::Sum(data, count), sum), "Sum", type, simd)
+                or not Check(Kernels::Equal(data, other.data() + start, count), "Equal of equal items", type, simd))
+                return;
+            if (count) {
+                DATA_T minValue, maxValue;
+                auto expected = std::minmax_element(data, data + count);
+                if (not Check(Kernels::MinMax(data, count, minValue, maxValue) and (minValue == *expected.first) and (maxValue == *expected.second), "MinMax", type, simd))
+                    return;
+                int32_t i = int32_t(rng() % count);
+                other[start + i] = DATA_T(other[start + i] + 1);
+                bool differs = not Kernels::Equal(data, other.data() + start, count);
+                other[start + i] = data[i];
+                if (not Check(differs, "Equal of different items", type, simd))
+                    return;
+            }
+            std::vector<DATA_T> filled(buffer);
+            Kernels::Fill(filled.data() + start, count, DATA_T(5));
+            bool fillOk = (filled.back() == buffer.back()) and std::equal(filled.begin(), filled.begin() + start, buffer.begin());
+            for (int32_t i = 0; fillOk and (i < count); i++)
+                fillOk = filled[start + i] == DATA_T(5);
+            if (not Check(fillOk, "Fill", type, simd))
+                return;
+        }
+    }
+    CpuFeatures::EnableSIMD(true);
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestSpecialValues(void)
+{
+    for (bool simd : { false, true }) {
+        CpuFeatures::EnableSIMD(simd);
+        float zeros[9] = {}, negativeZeros[9], nans[9];
+        std::fill_n(negativeZeros, 9, -0.0f);
+        std::fill_n(nans, 9, std::numeric_limits<float>::quiet_NaN());
+        Check(ArrayKernels<float>::Equal(zeros, negativeZeros, 9), "-0.0 equals 0.0", "float", simd);
+        Check(not ArrayKernels<float>::Equal(nans, nans, 9), "NaN equals nothing", "float", simd);
+        Check(ArrayKernels<float>::Find(negativeZeros, 9, 0.0f) == 0, "Find 0.0 among -0.0", "float", simd);
+
+        int32_t extremes[17];
+        std::fill_n(extremes, 17, 0);
+        extremes[3] = std::numeric_limits<int32_t>::min();
+        extremes[16] = std::numeric_limits<int32_t>::max();
+        int32_t minValue, maxValue;
+        Check(ArrayKernels<int32_t>::MinMax(extremes, 17, minValue, maxValue) and (minValue == extremes[3]) and (maxValue == extremes[16]), "MinMax of extreme values", "int32_t", simd);
+        Check(not ArrayKernels<int32_t>::MinMax(extremes, 0, minValue, maxValue), "MinMax of no items", "int32_t", simd);
+    }
+    CpuFeatures::EnableSIMD(true);
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestMembers(void)
+{
+    ManagedArray<int32_t> a;
+    for (int32_t i = 0; i < 1000; i++)
+        a.Append(i - 500);
+    ManagedArray<int32_t> b(a);
+    Check((a == b) and not (a != b), "ManagedArray::operator== of copies");
+    b[999] = 7;
+    Check(not (a == b), "ManagedArray::operator== of different arrays");
+    Check((a.Find(17) == 517) and (a.Find(9999) == -1), "ManagedArray::Find");
+    Check((a.Min() == -500) and (a.Max() == 499) and (a.Sum() == -500), "ManagedArray::Min, Max and Sum");
+    a.Fill(3);
+    Check(a.Sum() == 3000, "ManagedArray::Fill");
+
+    ManagedArray<std::string> s;
+    s.Append("b");
+    s.Append("a");
+    Check((s.Find("a") == 1) and (s.Min() == "a"), "ManagedArray members of non-arithmetic items");
+
+#if !(USE_STD || USE_STD_VECTOR)
+    Stack<int> stack(8, 8);
+    for (int i = 0; i < 20; i++)
+        stack.Push(i);
+    Check((stack.Find(13) == 13) and (stack.Find(99) == 20), "Stack::Find");
+    stack.Delete(2);
+    Check((stack.ToS() == 19) and (*stack.GetRef(2) == 3) and (*stack.GetRef(18) == 19), "Stack::Delete");
+    Stack<int> reordering(8, 8, true);
+    for (int i = 0; i < 20; i++)
+        reordering.Push(i);
+    reordering.Delete(2);
+    Check((reordering.ToS() == 19) and (*reordering.GetRef(2) == 19), "Stack::Delete with reordering");
+#endif
+}
+
+// =================================================================================================
+
+int main()
+{
+    if (not CpuFeatures::HasAVX2())
+        fprintf(stderr, "no AVX2 support, checking the scalar kernels only\n");
+    TestKernels<int8_t>("int8_t");
+    TestKernels<uint8_t>("uint8_t");
+    TestKernels<char>("char");
+    TestKernels<int16_t>("int16_t");
+    TestKernels<uint16_t>("uint16_t");
+    TestKernels<int32_t>("int32_t");
+    TestKernels<uint32_t>("uint32_t");
+    TestKernels<int64_t>("int64_t");
+    TestKernels<uint64_t>("uint64_t");
+    TestKernels<float>("float");
+    TestKernels<double>("double");
+    TestSpecialValues();
+    TestMembers();
+    fprintf(stderr, "%s\n", failures ? "arraykernels_test failed" : "arraykernels_test passed");
+    return failures ? 1 : 0;
+}
+
+// =================================================================================================
@@ -24,41 +24,50 @@ public:
     AVLNodePtr      left;
     AVLNodePtr      right;
     char		    balance;
-    int             visited;
+    int             size;       // number of nodes in the subtree rooted at this node
 #if DEBUG_MALLOC
     int             poolIndex;
 #endif
 
         AVLNode()
-            : left(nullptr), right(nullptr), balance(0), visited(0)
+            : left(nullptr), right(nullptr), balance(0), size(1)
 #if DEBUG_MALLOC
             , poolIndex(-1)
 #endif
         {
 #if !DEBUG_MALLOC
-            if constexpr (not std::is_trivially_constructible<DATA_T>::value)
+            // key and data of class types have already been default constructed; only plain types need clearing
+            if constexpr (std::is_trivially_constructible<DATA_T>::value)
                 memset(&data, 0, sizeof(DATA_T));
-            else
-                new(&data) DATA_T();
-            if constexpr (not std::is_trivially_constructible<KEY_T>::value)
+            if constexpr (std::is_trivially_constructible<KEY_T>::value)
                 memset(&key, 0, sizeof(KEY_T));
-            else
-                new(&key) DATA_T();
 #endif
         }
 
         AVLNode(KEY_T key, DATA_T data)
-            : key(key), data(data), balance(0), visited(0)
+            : key(key), data(data), left(nullptr), right(nullptr), balance(0), size(1)
 #if DEBUG_MALLOC
             , poolIndex(-1)
 #endif
         {
  }
 
+    static inline int SizeOf(AVLNodePtr node) {
+        return node ? node->size : 0;
+    }
+
+
+    inline void UpdateSize(void) {
+        size = SizeOf(left) + SizeOf(right) + 1;
+    }
+
+
     AVLNodePtr RotateSingleLL(bool isBalanced) {
         AVLNodePtr child = left;
         left = child->right;
         child->right = this;
+        UpdateSize();
+        child->UpdateSize();
         if (isBalanced) { // always true for insertions
             balance =
             child->balance = AVL_BALANCED;
@@ -75,13 +84,15 @@ public:
         AVLNodePtr child = right;
         right = child->left;
         child->left = this;
+        UpdateSize();
+        child->UpdateSize();
         if (isBalanced) { // always true for insertions
             balance =
             child->balance = AVL_BALANCED;
         }
         else {
             balance = AVL_OVERFLOW;
-            right->balance = AVL_UNDERFLOW;
+            child->balance = AVL_UNDERFLOW;
         }
         return child;
     }
@@ -94,6 +105,9 @@ public:
         pivot->left = child;
         left = pivot->right;
         pivot->right = this;
+        UpdateSize();
+        child->UpdateSize();
+        pivot->UpdateSize();
         char b = pivot->balance;
         balance = (b == AVL_UNDERFLOW) ? AVL_OVERFLOW : AVL_BALANCED;
         child->balance = (b == AVL_OVERFLOW) ? AVL_UNDERFLOW : AVL_BALANCED;
@@ -109,6 +123,9 @@ public:
         pivot->right = child;
         right = pivot->left;
         pivot->left = this;
+        UpdateSize();
+        child->UpdateSize();
+        pivot->UpdateSize();
         char b = pivot->balance;
         balance = (b == AVL_OVERFLOW) ? AVL_UNDERFLOW : AVL_BALANCED;
         child->balance = (b == AVL_UNDERFLOW) ? AVL_OVERFLOW : AVL_BALANCED;
@@ -140,7 +157,7 @@ public:
     inline AVLNodePtr BalanceLeftShrink(bool& heightHasChanged)
     {
         char b = right->balance;
-        if (b != AVL_BALANCED)
+        if (b == AVL_BALANCED)
             heightHasChanged = false;
         return RotateRight(b != AVL_UNDERFLOW, b != AVL_BALANCED);
     }
@@ -149,7 +166,7 @@ public:
     inline AVLNodePtr BalanceRightShrink(bool& heightHasChanged)
     {
         char b = left->balance;
-        if (b != AVL_BALANCED)
+        if (b == AVL_BALANCED)
             heightHasChanged = false;
         return RotateLeft(b != AVL_OVERFLOW, b != AVL_BALANCED);
     }
@@ -6,11 +6,14 @@
 // as pointers to data buffers (records). Each data packet is assumed to contain data
 // that forms a unique key for the record. The user has to supply a compare function
 // that can compare two data packets stored in the avl tree using the packets' keys.
-// For two record a and b, the compare function has to return -1 if a < b, +1 if a > b,
-// and 0 if their keys are equal.
+// For two record a and b, the compare function has to return a negative value if a < b,
+// a positive value if a > b, and 0 if their keys are equal.
 // When queried for data records, the avl tree returns void* pointers to these records;
 // these have to by cast to the proper types by the application defining and providing
 // these data records.
+// Insertion and removal are iterative: the path from the root to the affected node is
+// recorded on a fixed size stack and retraced for rebalancing, so no operation recurses
+// or allocates memory apart from the tree nodes themselves.
 
 #include <stdint.h>
 #include <stdlib.h>
@@ -25,20 +28,36 @@
 #define AVL_UNDERFLOW  3
 
 //-----------------------------------------------------------------------------
-// Internal function to search a value in an avl tree. The value (key) pointer is 
+// Pool blocks start with a link to the next block, followed by the nodes.
+
+typedef struct avlNodeBlock {
+    struct avlNodeBlock*    next;
+    avlTreeNode_t           nodes[];
+} avlNodeBlock_t;
+
+//-----------------------------------------------------------------------------
+// Path from the root to a node: the links (pointers to the child pointers) leading
+// to each node on the path and the direction taken from there (0: left, 1: right).
+
+typedef struct {
+    avlTreeNode_t**     links[AVL_MAX_DEPTH];
+    bool                isRight[AVL_MAX_DEPTH];
+    int                 depth;
+} avlTreePath_t;
+
+//-----------------------------------------------------------------------------
+// Internal function to search a value in an avl tree. The value (key) pointer is
 // passed in avlTree->value.
 
 static void* find_value(avlTreeDescriptor_t* avlTree)
 {
     for (avlTreeNode_t* node = avlTree->root; node; ) {
-        switch (avlTree->comparator(avlTree->value, node->value)) {
-        case -1:
+        int rel = avlTree->comparator(avlTree->value, node->value);
+        if (rel < 0)
             node = node->left;
-            break;
-        case 1:
+        else if (rel > 0)
             node = node->right;
-            break;
-        default:
+        else {
             avlTree->current = node;
             return node->value;
         }
@@ -47,116 +66,106 @@ static void* find_value(avlTreeDescriptor_t* avlTree)
 }
 
 //-----------------------------------------------------------------------------
-// Allocate a new avl tree node.
+// Allocate a new avl tree node. Pooled trees take it from the free list, carving
+// a new block into free nodes when the list is empty.
 
 static avlTreeNode_t* avltree_alloc_node(avlTreeDescriptor_t* avlTree, void* value)
 {
-    if (!(avlTree->current = (avlTreeNode_t*)malloc(sizeof (avlTreeNode_t)))) {
-        return NULL;
+    avlTreeNode_t* node = avlTree->freeNodes;
+    if (node)
+        avlTree->freeNodes = node->right;
+    else if (avlTree->poolBlockSize <= 0) {
+        if (!(node = (avlTreeNode_t*)malloc(sizeof(avlTreeNode_t))))
+            return NULL;
     }
-    avlTree->current->value = value;
-    avlTree->branchHasChanged = true;
-    return avlTree->current;
+    else {
+        avlNodeBlock_t* block = (avlNodeBlock_t*)malloc(sizeof(avlNodeBlock_t) + avlTree->poolBlockSize * sizeof(avlTreeNode_t));
+        if (!block)
+            return NULL;
+        block->next = (avlNodeBlock_t*)avlTree->nodeBlocks;
+        avlTree->nodeBlocks = block;
+        for (int i = avlTree->poolBlockSize - 1; i > 0; i--) {
+            block->nodes[i].right = avlTree->freeNodes;
+            avlTree->freeNodes = block->nodes + i;
+        }
+        node = block->nodes;
+    }
+    node->left = node->right = NULL;
+    node->balance = AVL_BALANCED;
+    node->value = value;
+    avlTree->current = node;
+    avlTree->nodeCount++;
+    return node;
 }
 
 //-----------------------------------------------------------------------------
-// Internal function to insert a value in the avl tree. The value pointer is 
-// passed in avlTree->value.
+// Release an avl tree node, either to the pool or to the heap.
 
-static bool insert_value(avlTreeDescriptor_t* avlTree, avlTreeNode_t* root)
+static void avltree_free_node(avlTreeDescriptor_t* avlTree, avlTreeNode_t* node)
 {
-    avlTreeNode_t* p1, * p2, * r = avlTree->root;
-    if (!r)
-        return ((root = avltree_alloc_node(avlTree, avlTree->value)) != NULL);
-
-    switch (avlTree->comparator(avlTree->value, r->value)) {
-        case -1:
-            if (!insert_value(avlTree, r->left))
-                return false;
-            if (avlTree->branchHasChanged) {
-                switch (r->balance) {
-                case AVL_UNDERFLOW:
-                    p1 = r->left;
-                    if (p1->balance == AVL_UNDERFLOW) {  // single LL rotation
-                        r->left = p1->right;
-                        p1->right = r;
-                        r->balance = AVL_BALANCED;
-                        r = p1;
-                    }
-                    else { // double LR rotation
-                        p2 = p1->right;
-                        p1->right = p2->left;
-                        p2->left = p1;
-                        r->left = p2->right;
-                        p2->right = r;
-                        char b = p2->balance;
-                        r->balance = (b == AVL_UNDERFLOW) ? AVL_OVERFLOW : AVL_BALANCED;
-                        p1->balance = (b == AVL_OVERFLOW) ? AVL_UNDERFLOW : AVL_BALANCED;
-                        r = p2;
-                    }
-                    r->balance = AVL_BALANCED;
-                    avlTree->branchHasChanged = false;
-                    break;
-
-                case AVL_BALANCED:
-                    r->balance = AVL_UNDERFLOW;
-                    break;
+    if (avlTree->poolBlockSize > 0) {
+        node->right = avlTree->freeNodes;
+        avlTree->freeNodes = node;
+    }
+    else
+        free(node);
+    avlTree->nodeCount--;
+}
 
-                case AVL_OVERFLOW:
-                    r->balance = AVL_BALANCED;
-                    avlTree->branchHasChanged = false;
-                    break;
-                }
-            }
-            break;
+//-----------------------------------------------------------------------------
+// Rebalance sub tree r the left sub tree of which has grown two levels higher than
+// its right sub tree by inserting a record. Returns the new root of the sub tree.
 
-        case 0:
-            avlTree->isDuplicate = true;
-            avlTree->current = r;
-            break;
+static avlTreeNode_t* balance_left_growth(avlTreeNode_t* r)
+{
+    avlTreeNode_t* p1 = r->left;
+    if (p1->balance == AVL_UNDERFLOW) {  // single LL rotation
+        r->left = p1->right;
+        p1->right = r;
+        r->balance = AVL_BALANCED;
+        r = p1;
+    }
+    else { // double LR rotation
+        avlTreeNode_t* p2 = p1->right;
+        p1->right = p2->left;
+        p2->left = p1;
+        r->left = p2->right;
+        p2->right = r;
+        char b = p2->balance;
+        r->balance = (b == AVL_UNDERFLOW) ? AVL_OVERFLOW : AVL_BALANCED;
+        p1->balance = (b == AVL_OVERFLOW) ? AVL_UNDERFLOW : AVL_BALANCED;
+        r = p2;
+    }
+    r->balance = AVL_BALANCED;
+    return r;
+}
 
-        case 1:
-            if (!insert_value(avlTree, r->right))
-                return false;
-            if (avlTree->branchHasChanged) {
-                switch (r->balance) {
-                case AVL_UNDERFLOW:
-                    r->balance = AVL_BALANCED;
-                    avlTree->branchHasChanged = false;
-                    break;
-
-                case AVL_BALANCED:
-                    r->balance = AVL_OVERFLOW;
-                    break;
-
-                case AVL_OVERFLOW: {
-                    avlTreeNode_t* p1 = r->right;
-                    if (p1->balance == AVL_OVERFLOW) { // single RR rotation
-                        r->right = p1->left;
-                        p1->left = r;
-                        r->balance = AVL_BALANCED;
-                        r = p1;
-                    }
-                    else { // double RL rotation
-                        avlTreeNode_t* p2 = p1->left;
-                        p1->left = p2->right;
-                        p2->right = p1;
-                        r->right = p2->left;
-                        p2->left = r;
-                        char b = p2->balance;
-                        r->balance = (b == AVL_OVERFLOW) ? AVL_UNDERFLOW : AVL_BALANCED;
-                        p1->balance = (b == AVL_UNDERFLOW) ? AVL_OVERFLOW : AVL_BALANCED;
-                        r = p2;
-                    }
-                    r->balance = AVL_BALANCED;
-                    avlTree->branchHasChanged = false;
-                }
-            }
-        }
-        break;
+//-----------------------------------------------------------------------------
+// Rebalance sub tree r the right sub tree of which has grown two levels higher than
+// its left sub tree by inserting a record. Returns the new root of the sub tree.
+
+static avlTreeNode_t* balance_right_growth(avlTreeNode_t* r)
+{
+    avlTreeNode_t* p1 = r->right;
+    if (p1->balance == AVL_OVERFLOW) { // single RR rotation
+        r->right = p1->left;
+        p1->left = r;
+        r->balance = AVL_BALANCED;
+        r = p1;
     }
-    root = r;
-    return true;
+    else { // double RL rotation
+        avlTreeNode_t* p2 = p1->left;
+        p1->left = p2->right;
+        p2->right = p1;
+        r->right = p2->left;
+        p2->left = r;
+        char b = p2->balance;
+        r->balance = (b == AVL_OVERFLOW) ? AVL_UNDERFLOW : AVL_BALANCED;
+        p1->balance = (b == AVL_UNDERFLOW) ? AVL_OVERFLOW : AVL_BALANCED;
+        r = p2;
+    }
+    r->balance = AVL_BALANCED;
+    return r;
 }
 
 //-----------------------------------------------------------------------------
@@ -256,148 +265,133 @@ static void balance_right_shrink(avlTreeNode_t** root, bool* branchHasShrunk)
 }
 
 //-----------------------------------------------------------------------------
-// reorder_value looks for the record with the biggest key in the right sub tree
-// of the record to be removed. That record will take the place of the record to
-// be removed. To accomplish that, both records' data pointers will be exchanged.
+// Record the link to a node and the direction taken from it on the path; returns
+// the link to the child in that direction.
 
-static void reorder_value(avlTreeNode_t** root, avlTreeNode_t** nodeToDelete, bool* branchHasShrunk)
+static inline avlTreeNode_t** push_link(avlTreePath_t* path, avlTreeNode_t** link, bool isRight)
 {
-    avlTreeNode_t* r = *root;
-    if (r->right) {
-        reorder_value(&r->right, nodeToDelete, branchHasShrunk);
-        if (*branchHasShrunk)
-            balance_right_shrink(&r, branchHasShrunk);
-    }
-    else {
-        avlTreeNode_t* d = *nodeToDelete;
-        void* h = r->value;
-        r->value = d->value;
-        d->value = h;
-        *nodeToDelete = r;
-        r = r->left;
-        *branchHasShrunk = true;
-    }
-    *root = r;
+    path->links[path->depth] = link;
+    path->isRight[path->depth++] = isRight;
+    return isRight ? &(*link)->right : &(*link)->left;
 }
 
 //-----------------------------------------------------------------------------
-// Remove node holding data record with key avlTree->value from avl tree.
+// Unlink the node referenced by *link, which has one child at most, and rebalance the
+// tree along path. The node's value is passed back in avlTree->value.
 
-static bool remove_node(avlTreeDescriptor_t* avlTree, avlTreeNode_t** root, bool* branchHasChanged)
+static void unlink_node(avlTreeDescriptor_t* avlTree, avlTreePath_t* path, avlTreeNode_t** link)
 {
-    if (!root)
-        branchHasChanged = false;
-    else {
-        avlTreeNode_t* r = *root;
-        switch (avlTree->comparator(avlTree->value, r->value)) {
-            case -1:
-                if (!remove_node(avlTree, &r->left, branchHasChanged))
-                    return false;
-                if (*branchHasChanged)
-                    balance_left_shrink(&r, branchHasChanged);
-                break;
+    avlTreeNode_t* d = *link;
+    *link = d->left ? d->left : d->right;
+    avlTree->value = d->value;
+    avltree_free_node(avlTree, d);
+    bool branchHasShrunk = true;
+    while (branchHasShrunk && path->depth) {
+        --path->depth;
+        if (path->isRight[path->depth])
+            balance_right_shrink(path->links[path->depth], &branchHasShrunk);
+        else
+            balance_left_shrink(path->links[path->depth], &branchHasShrunk);
+    }
+}
 
-            case 1:
-                if (!remove_node(avlTree, &r->right, branchHasChanged))
-                    return false;
-                if (*branchHasChanged)
-                    balance_right_shrink(&r, branchHasChanged);
-                break;
+//-----------------------------------------------------------------------------
+// Build a perfectly balanced tree from the sorted values [first, last).
+// Returns the height of the tree.
 
-            default: {
-                avlTreeNode_t* d = r;
-                if (!r->right) {
-                    r = r->left;
-                    *branchHasChanged = true;
-                }
-                else if (!r->left) {
-                    r = r->right;
-                    *branchHasChanged = true;
-                }
-                else {
-                    reorder_value(&d->left, &d, branchHasChanged);
-                    if (*branchHasChanged)
-                        balance_left_shrink(&r, branchHasChanged);
-                }
-                avlTree->value = d->value;
-                if (avlTree->deleteValues && d->value) {
-                    free(d->value);
-                }
-                free(d);
-            }
-        }
-        *root = r;
+static int build_nodes(avlTreeDescriptor_t* avlTree, void** values, int first, int last, avlTreeNode_t** root)
+{
+    if (first >= last) {
+        *root = NULL;
+        return 0;
     }
-    return true;
+    int m = first + (last - first) / 2;
+    avlTreeNode_t* r = avltree_alloc_node(avlTree, values[m]);
+    if (!(*root = r))
+        return -1;
+    int hl = build_nodes(avlTree, values, first, m, &r->left);
+    int hr = build_nodes(avlTree, values, m + 1, last, &r->right);
+    if ((hl < 0) || (hr < 0))
+        return -1;
+    r->balance = (hl < hr) ? AVL_OVERFLOW : (hl > hr) ? AVL_UNDERFLOW : AVL_BALANCED;
+    return ((hl > hr) ? hl : hr) + 1;
 }
 
 //-----------------------------------------------------------------------------
-// Free all nodes in left and right sub trees of *root, then free root.
+// Free all nodes of the avl tree avlTree. The tree is flattened into a list by rotating
+// left children up while it is being freed, so no stack is needed.
 
-static void free_nodes(avlTreeNode_t* root)
+static void free_nodes(avlTreeDescriptor_t* avlTree, bool deleteValues)
 {
-    if (root) {
-        free_nodes(root->left);
-        free_nodes(root->right);
-        free(root);
+    avlTreeNode_t* node = avlTree->root;
+    while (node) {
+        avlTreeNode_t* next;
+        if ((next = node->left)) {
+            node->left = next->right;
+            next->right = node;
+        }
+        else {
+            next = node->right;
+            if (deleteValues && node->value)
+                free(node->value);
+            if (avlTree->poolBlockSize <= 0)
+                free(node);
+        }
+        node = next;
     }
+    avlTree->root = NULL;
+    avlTree->nodeCount = 0;
 }
 
 //-----------------------------------------------------------------------------
-// Free all nodes of the avl tree avlTree.
+// Initialize an iterator and return the first value in ascending (reverse: descending)
+// key order. The path holds the nodes still to be visited; for each node, the nodes
+// to visit before it are pushed on top of it.
 
-static void avltree_free(avlTreeDescriptor_t* avlTree)
+static inline void push_nodes(avlTreeIterator_t* iterator, avlTreeNode_t* node)
 {
-    free_nodes(avlTree->root);
+    for (; node; node = iterator->reverse ? node->right : node->left)
+        iterator->path[iterator->depth++] = node;
 }
 
-//-----------------------------------------------------------------------------
-// Walk through all nodes of avl sub tree *root, calling processNode in the order
-// of the values stored in that sub tree.
 
-static bool walk_nodes_forward(avlTreeNode_t* root, nodeProcessor_t processNode)
+void avltree_iterator_init(avlTreeIterator_t* iterator, avlTreeDescriptor_t* avlTree, bool reverse)
 {
-    if (root) {
-        if (!walk_nodes_forward(root->left, processNode))
-            return false;
-        if (!processNode(root->value))
-            return false;
-        if (!walk_nodes_forward(root->right, processNode))
-            return false;
-    }
-    return true;
+    iterator->depth = 0;
+    iterator->reverse = reverse;
+    push_nodes(iterator, avlTree->root);
 }
 
 //-----------------------------------------------------------------------------
-// Walk through all nodes of avl sub tree *root, calling processNode in reverse order
-// of the values stored in that sub tree.
+// Return the next value in iteration order.
 
-static bool walk_nodes_reverse(avlTreeNode_t* root, nodeProcessor_t processNode)
+void* avltree_iterator_next(avlTreeIterator_t* iterator)
 {
-    if (root) {
-        if (!walk_nodes_reverse(root->right, processNode))
-            return false;
-        if (!processNode(root->value))
-            return false;
-        if (!walk_nodes_reverse(root->left, processNode))
-            return false;
-    }
-    return true;
+    if (!iterator->depth)
+        return NULL;
+    avlTreeNode_t* node = iterator->path[--iterator->depth];
+    push_nodes(iterator, iterator->reverse ? node->left : node->right);
+    return node->value;
 }
 
 //-----------------------------------------------------------------------------
-// Walk through an entire avl tree, calling processNode for each value stored in the 
+// Walk through an entire avl tree, calling processNode for each value stored in the
 // avl tree either in ascending or descending key order.
 
 bool avltree_walk(avlTreeDescriptor_t* avlTree, nodeProcessor_t processNode, bool reverse)
 {
-    return reverse ? walk_nodes_reverse(avlTree->root, processNode) : walk_nodes_forward(avlTree->root, processNode);
+    avlTreeIterator_t iterator;
+    avltree_iterator_init(&iterator, avlTree, reverse);
+    for (void* value; (value = avltree_iterator_next(&iterator)); )
+        if (!processNode(value))
+            return false;
+    return true;
 } /*AvlWalk*/
 
 // ------------------------------------------------------------------
 // Create an avl tree and return a pointer to its descriptor.
 
-avlTreeDescriptor_t* avltree_create(char* typeName, int typeSize, valueComparator_t comparator)
+avlTreeDescriptor_t* avltree_create_pooled(char* typeName, int typeSize, valueComparator_t comparator, int poolBlockSize)
 {
     avlTreeDescriptor_t* avlTree = malloc(sizeof(avlTreeDescriptor_t));
     if (avlTree != NULL) {
@@ -405,52 +399,133 @@ avlTreeDescriptor_t* avltree_create(char* typeName, int typeSize, valueComparato
         avlTree->typeName = typeName;
         avlTree->typeSize = typeSize;
         avlTree->comparator = comparator;
+        avlTree->poolBlockSize = poolBlockSize;
     }
     return avlTree;
 }
 
+
+avlTreeDescriptor_t* avltree_create(char* typeName, int typeSize, valueComparator_t comparator)
+{
+    return avltree_create_pooled(typeName, typeSize, comparator, 0);
+}
+
 //-----------------------------------------------------------------------------
 // Insert a value referenced by value in the avl tree avlTree.
 
 bool avltree_insert(avlTreeDescriptor_t* avlTree, void* value)
 {
-    avlTree->branchHasChanged = avlTree->isDuplicate = false;
+    avlTreeNode_t** links[AVL_MAX_DEPTH];
+    int depth = 0;
+    avlTreeNode_t** link = &avlTree->root;
+
+    avlTree->isDuplicate = false;
     avlTree->value = value;
-    if (!insert_value(avlTree, avlTree->root))
+    while (*link) {
+        avlTreeNode_t* r = *link;
+        int rel = avlTree->comparator(value, r->value);
+        if (!rel) {
+            avlTree->isDuplicate = true;
+            avlTree->current = r;
+            return true;
+        }
+        links[depth++] = link;
+        link = (rel < 0) ? &r->left : &r->right;
+    }
+    avlTreeNode_t* child = avltree_alloc_node(avlTree, value);
+    if (!(*link = child))
         return false;
-    if (!avlTree->isDuplicate) {
-        avlTree->current->value = value;
+    // retrace the path until a sub tree's height hasn't changed
+    while (depth) {
+        link = links[--depth];
+        avlTreeNode_t* r = *link;
+        if (r->left == child) {
+            if (r->balance == AVL_OVERFLOW) {
+                r->balance = AVL_BALANCED;
+                break;
+            }
+            if (r->balance == AVL_UNDERFLOW) {
+                *link = balance_left_growth(r);
+                break;
+            }
+            r->balance = AVL_UNDERFLOW;
+        }
+        else {
+            if (r->balance == AVL_UNDERFLOW) {
+                r->balance = AVL_BALANCED;
+                break;
+            }
+            if (r->balance == AVL_OVERFLOW) {
+                *link = balance_right_growth(r);
+                break;
+            }
+            r->balance = AVL_OVERFLOW;
+        }
+        child = r;
     }
     return true;
 }
 
 //-----------------------------------------------------------------------------
-// Delete a value the key of which is passed in value from the avl tree avlTree.
+// Insert count values. Sorted values are built into an empty tree directly.
 
-bool avltree_delete(avlTreeDescriptor_t* avlTree, void* key, bool deleteValues)
+int avltree_insert_bulk(avlTreeDescriptor_t* avlTree, void** values, int count)
 {
-    if (!(avlTree && avlTree->root))
-        return false;
-    avlTree->value = key;
-    avlTree->branchHasChanged = false;
-    avlTree->deleteValues = deleteValues;
-    return remove_node(avlTree, &avlTree->root, &avlTree->branchHasChanged);
-    free(avlTree);
+    if (count <= 0)
+        return 0;
+    if (!avlTree->root) {
+        int i = 1;
+        while ((i < count) && (avlTree->comparator(values[i - 1], values[i]) < 0))
+            i++;
+        if (i == count) {
+            if (build_nodes(avlTree, values, 0, count, &avlTree->root) >= 0)
+                return count;
+            free_nodes(avlTree, false);
+            return 0;
+        }
+    }
+    int inserted = 0;
+    for (int i = 0; i < count; i++) {
+        if (!avltree_insert(avlTree, values[i]))
+            break;
+        if (!avlTree->isDuplicate)
+            inserted++;
+    }
+    return inserted;
 }
 
 //-----------------------------------------------------------------------------
-// Free all nodes in left and right sub trees of *root, then free root.
+// Delete a value the key of which is passed in value from the avl tree avlTree.
 
-static void destroy_nodes(avlTreeNode_t* root, bool deleteValues)
+bool avltree_delete(avlTreeDescriptor_t* avlTree, void* key, bool deleteValues)
 {
-    if (root) {
-        destroy_nodes(root->left, deleteValues);
-        destroy_nodes(root->right, deleteValues);
-        if (deleteValues && (root->value)) {
-            free(root->value);
-        }
-        free(root);
+    if (!(avlTree && avlTree->root))
+        return false;
+    avlTreePath_t path;
+    path.depth = 0;
+    avlTreeNode_t** link = &avlTree->root;
+    for (;;) {
+        if (!*link)
+            return false;
+        int rel = avlTree->comparator(key, (*link)->value);
+        if (!rel)
+            break;
+        link = push_link(&path, link, rel > 0);
     }
+    avlTreeNode_t* d = *link;
+    if (d->left && d->right) {
+        // the record with the biggest key in the left sub tree takes the place of the record to be removed
+        link = push_link(&path, link, false);
+        while ((*link)->right)
+            link = push_link(&path, link, true);
+        void* h = d->value;
+        d->value = (*link)->value;
+        (*link)->value = h;
+    }
+    unlink_node(avlTree, &path, link);
+    if (deleteValues && avlTree->value)
+        free(avlTree->value);
+    return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -459,10 +534,15 @@ static void destroy_nodes(avlTreeNode_t* root, bool deleteValues)
 
 void avltree_destroy(avlTreeDescriptor_t* avlTree, bool deleteValues)
 {
-    if (!avltree_is_empty(avlTree)) {
-        destroy_nodes(avlTree->root, deleteValues);
-        free(avlTree);
+    if (!avlTree)
+        return;
+    free_nodes(avlTree, deleteValues);
+    for (avlNodeBlock_t* block = (avlNodeBlock_t*)avlTree->nodeBlocks; block; ) {
+        avlNodeBlock_t* next = block->next;
+        free(block);
+        block = next;
     }
+    free(avlTree);
 }
 
 //-----------------------------------------------------------------------------
@@ -480,16 +560,16 @@ bool avltree_replace(avlTreeDescriptor_t* avlTree, void* oldValue, void* newValu
 //-----------------------------------------------------------------------------
 // Find the value with key key in the avl tree avlTree.
 
-static void* avltree_find(avlTreeDescriptor_t* avlTree, void* key)
+void* avltree_find(avlTreeDescriptor_t* avlTree, void* key)
 {
     avlTree->value = key;
     return find_value(avlTree);
 }
- 
+
 //-----------------------------------------------------------------------------
 // Return the value with the smallest key stored in avl tree avlTree.
 
-static void* avltree_get_min(avlTreeDescriptor_t* avlTree)
+void* avltree_get_min(avlTreeDescriptor_t* avlTree)
 {
     if (!avlTree->root)
         return NULL;
@@ -502,7 +582,7 @@ static void* avltree_get_min(avlTreeDescriptor_t* avlTree)
 //-----------------------------------------------------------------------------
 // Return the value with the biggest key stored in avl tree avlTree.
 
-static void* avltree_get_max(avlTreeDescriptor_t* avlTree)
+void* avltree_get_max(avlTreeDescriptor_t* avlTree)
 {
     if (!avlTree->root)
         return NULL;
@@ -512,29 +592,6 @@ static void* avltree_get_max(avlTreeDescriptor_t* avlTree)
     return p->value;
 }
 
-//-----------------------------------------------------------------------------
-// Internal function to Return the value with the biggest key stored in avl tree avlTree and remove it from the avl tree.
-
-static void extract_min_value(avlTreeDescriptor_t* avlTree, avlTreeNode_t** root, bool* branchHasChanged)
-{
-    avlTreeNode_t* r = *root;
-
-    if (!r)
-        avlTree->branchHasChanged = false;
-    else if (r->left) {
-        extract_min_value(avlTree, &r->left, branchHasChanged);
-        if (*branchHasChanged)
-            balance_left_shrink(&r, branchHasChanged);
-    }
-    else {
-        avlTreeNode_t* d = r;
-        avlTree->value = r->value;
-        free (d);
-        *branchHasChanged = true;
-    }
-    *root = r;
-}
-
 //-----------------------------------------------------------------------------
 // Return the value with the smallest key stored in avl tree avlTree and remove it from the avl tree.
 
@@ -542,34 +599,15 @@ void* avltree_extract_min(avlTreeDescriptor_t* avlTree)
 {
     if (!avlTree->root)
         return NULL;
-    avlTree->branchHasChanged = false;
-    extract_min_value(avlTree, &avlTree->root, &avlTree->branchHasChanged);
+    avlTreePath_t path;
+    path.depth = 0;
+    avlTreeNode_t** link = &avlTree->root;
+    while ((*link)->left)
+        link = push_link(&path, link, false);
+    unlink_node(avlTree, &path, link);
     return avlTree->value;
 }
 
-//-----------------------------------------------------------------------------
-// Internal function to return the value with the biggest key stored in avl tree avlTree and remove it from the avl tree.
-
-static void extract_max_value(avlTreeDescriptor_t* avlTree, avlTreeNode_t** root, bool* branchHasChanged)
-{
-    avlTreeNode_t* r = *root;
-
-    if (!r)
-        avlTree->branchHasChanged = false;
-    else if (r->right) {
-        extract_max_value(avlTree, &r->right, branchHasChanged);
-        if (*branchHasChanged)
-            balance_right_shrink(&r, branchHasChanged);
-    }
-    else {
-        avlTreeNode_t* d = r;
-        avlTree->value = r->value;
-        free (d);
-        *branchHasChanged = true;
-    }
-    *root = r;
-}
-
 //-----------------------------------------------------------------------------
 // Return the value with the biggest key stored in avl tree avlTree and remove it from the avl tree.
 
@@ -577,18 +615,22 @@ void* avltree_extract_max(avlTreeDescriptor_t* avlTree)
 {
     if (!avlTree->root)
         return NULL;
-    avlTree->branchHasChanged = false;
-    extract_max_value(avlTree, &avlTree->root, &avlTree->branchHasChanged);
+    avlTreePath_t path;
+    path.depth = 0;
+    avlTreeNode_t** link = &avlTree->root;
+    while ((*link)->right)
+        link = push_link(&path, link, true);
+    unlink_node(avlTree, &path, link);
     return avlTree->value;
 }
 
 // ------------------------------------------------------------------
-// Check whether the avl tree avlTree is empty (and valid).
+// Check whether the avl tree avlTree is empty (or invalid).
 
 bool avltree_is_empty(avlTreeDescriptor_t* avlTree)
 {
-    return ((avlTree != NULL) && (avlTree->root != NULL));
+    return ((avlTree == NULL) || (avlTree->root == NULL));
 }
 
 // ------------------------------------------------------------------
-// eof
\ No newline at end of file
+// eof
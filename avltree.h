@@ -10,7 +10,12 @@ extern "C" {
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include "comparators.h"
+
+// maximum height of an avl tree; an avl tree with n nodes is at most 1.44 * log2(n + 2) high
+#define AVL_MAX_DEPTH	64
 
 	typedef int (*avlDataComparator_t)(const void*, const void*);
 
@@ -29,17 +34,33 @@ extern "C" {
 		void*				value;
 		char*				typeName;
 		int					typeSize;
+		int					nodeCount;
 		avlDataComparator_t comparator;
+		avlTreeNode_t*		freeNodes;		// released pool nodes, chained through their right pointers
+		void*				nodeBlocks;		// node blocks allocated by the pool
+		int					poolBlockSize;	// nodes per pool block; 0: nodes are malloc'd one by one
 		bool				isDuplicate;
 		bool				branchHasChanged;
 		bool				deleteValues;
 	} avlTreeDescriptor_t;
 
+	// in-order iterator keeping the path to the next node on an explicit stack, so walking a tree
+	// neither recurses nor allocates
+	typedef struct {
+		avlTreeNode_t*		path[AVL_MAX_DEPTH];
+		int					depth;
+		bool				reverse;
+	} avlTreeIterator_t;
+
 	// create an avl tree descriptor on the heap and return a pointer to it if everything went alright
 	// comparator is a pointer to an appropriate comparison function depending on the ordinal relationship
 	// of the data to be stored in the avl tree
 	avlTreeDescriptor_t* avltree_create(char* typeName, int typeSize, valueComparator_t comparator);
 
+	// like avltree_create, but the tree nodes are taken from blocks of poolBlockSize nodes. Nodes of removed
+	// data sets are reused by later insertions; the blocks are only freed when the avl tree is destroyed
+	avlTreeDescriptor_t* avltree_create_pooled(char* typeName, int typeSize, valueComparator_t comparator, int poolBlockSize);
+
 	// remove the entire avl tree from memory. If deleteValues is true, all data stored in it will also
 	// be removed from memory (i.e. freed)
 	void avltree_destroy(avlTreeDescriptor_t* avlTree, bool deleteValues);
@@ -47,6 +68,11 @@ extern "C" {
 	// insert a data set *value in the avl tree described by avlTree
 	bool avltree_insert(avlTreeDescriptor_t* avlTree, void* value);
 
+	// insert count data sets. If the avl tree is empty and values are sorted in ascending key order without
+	// duplicates, the tree is built directly in O(count); otherwise the values are inserted one by one.
+	// returns the number of data sets inserted
+	int avltree_insert_bulk(avlTreeDescriptor_t* avlTree, void** values, int count);
+
 	// delete a data set with key *key from the avl tree described by avlTree
 	// if deleteValues is true, the data set stored in the avl tree will also be deleted (freed)
 	bool avltree_delete(avlTreeDescriptor_t* avlTree, void* key, bool deleteValues);
@@ -58,11 +84,24 @@ extern "C" {
 	// return a pointer to the data set with key *key in the avl tree (NULL if not found)
 	void* avltree_find(avlTreeDescriptor_t* avlTree, void* key);
 
+	// return a pointer to the data set with the smallest key in the avl tree (NULL if the tree is empty)
+	void* avltree_get_min(avlTreeDescriptor_t* avlTree);
+
+	// return a pointer to the data set with the biggest key in the avl tree (NULL if the tree is empty)
+	void* avltree_get_max(avlTreeDescriptor_t* avlTree);
+
 	// Walk through all nodes of the avl tree in either ascending or descending order of the data stored therein
 	// the function supplied in processNode will be called for each node and a pointer to the data set stored in
 	// that node will be passed to it
 	bool avltree_walk(avlTreeDescriptor_t* avlTree, nodeProcessor_t processNode, bool reverse);
 
+	// position iterator in front of the data set with the smallest (reverse: biggest) key
+	void avltree_iterator_init(avlTreeIterator_t* iterator, avlTreeDescriptor_t* avlTree, bool reverse);
+
+	// return the next data set in ascending (reverse: descending) key order, or NULL after the last one
+	// the avl tree must not be modified while it is iterated
+	void* avltree_iterator_next(avlTreeIterator_t* iterator);
+
 	// extract the data set with the smallest key from the avl tree (the data set will be removed from the avl tree
 	// (but will of course not be deleted ;-)
 	void* avltree_extract_min(avlTreeDescriptor_t* avlTree);
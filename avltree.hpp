@@ -14,8 +14,17 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <algorithm>
 #include <utility>
+#include <type_traits>
 #include <stdexcept>
+#include <cstdio>
 #include "string.h"
 
 #include "avltreetraits.h"
@@ -23,7 +32,9 @@
 
 #define RELINK_DELETED_NODE 0
 
-#define AVL_DEBUG 0
+#ifndef AVL_DEBUG
+#   define AVL_DEBUG 0 // 1: validate the tree structure after each insertion and removal
+#endif
 
 // =================================================================================================
 
@@ -33,6 +44,7 @@ class AVLTree
 public:
     using Comparator = typename AVLTreeTraits<KEY_T, DATA_T>::Comparator;
     using DataProcessor = typename AVLTreeTraits<KEY_T, DATA_T>::DataProcessor;
+    using DataComparator = typename AVLTreeTraits<KEY_T, DATA_T>::DataComparator;
 
 //-----------------------------------------------------------------------------
 
@@ -49,28 +61,33 @@ private:
         KEY_T	        workingKey;
         DATA_T          workingData;
         Comparator      compareNodes;
-        DataProcessor   processNode;
         void*           context;
-        int             visited;
         bool	        isDuplicate;
         bool            heightHasChanged;
         bool            result;
-#ifdef _DEBUG
-        AVLNodePtr      testNode;
-        KEY_T           nullKey;
-        KEY_T           testKey;
-#endif
 
         tAVLTreeInfo()
-            : root(nullptr), workingNode(nullptr), workingParent(nullptr), nodeCount(0), compareNodes(nullptr), processNode(nullptr), context(nullptr), visited(0), isDuplicate(false), heightHasChanged(false), result(false)
+            : root(nullptr), workingNode(nullptr), workingParent(nullptr), nodeCount(0), compareNodes(nullptr), context(nullptr), isDuplicate(false), heightHasChanged(false), result(false)
         {
             InitializeAnyType(workingData);
             InitializeAnyType(workingKey);
         }
     };
 
+    struct DataOrder {
+        DataComparator  compareData;
+        void*           context;
+
+        inline bool operator()(const DATA_T& a, const DATA_T& b) const {
+            return compareData(context, a, b) < 0;
+        }
+    };
+
+    using DataIndex = std::multimap<DATA_T, AVLNodePtr, DataOrder>;
+
 private:
     tAVLTreeInfo	        m_info;
+    DataIndex*              m_dataIndex;
 #if DEBUG_MALLOC
     BasicDataPool<AVLNode>  m_nodePool;
     bool                    m_useNodePool;
@@ -81,11 +98,11 @@ private:
 public:
 
 AVLTree(int capacity = 0)
+    : m_dataIndex(nullptr)
 #if DEBUG_MALLOC
-    : m_nodePool(), m_useNodePool(capacity > 0)
+    , m_nodePool(), m_useNodePool(capacity > 0)
 #endif
 {
-    memset(&m_info, 0, sizeof(m_info));
 #if DEBUG_MALLOC
     m_nodePool.Create(capacity);
 #endif
@@ -94,6 +111,7 @@ AVLTree(int capacity = 0)
 
 ~AVLTree() {
     Destroy();
+    DisableDataIndex();
 }
 
 inline void SetComparator(Comparator compareNodes, void* context = nullptr) {  // context: pointer to some class instance containing the compare function, if that is a class member
@@ -108,54 +126,254 @@ inline int Size(void) {
 
 //-----------------------------------------------------------------------------
 
+private:
+    // compareKey(nodeKey) returns the relation of the searched key to nodeKey
+    template <typename COMPARE_T>
+    AVLNodePtr FindNode(COMPARE_T compareKey)
+    {
+        for (AVLNodePtr node = m_info.root; node != nullptr; ) {
+            int rel = compareKey(node->key);
+            if (rel < 0)
+                node = node->left;
+            else if (rel > 0)
+                node = node->right;
+            else
+                return node;
+        }
+        return nullptr;
+    }
+
 public:
 DATA_T* Find(const KEY_T& key)
 {
-    if (not m_info.root)
-        return nullptr;
-    for (AVLNodePtr node = m_info.root; node != nullptr; ) {
-        int rel = m_info.compareNodes(m_info.context, key, node->key);
-        if (rel < 0)
-            node = node->left;
-        else if (rel > 0)
-            node = node->right;
-        else {
-            m_info.workingNode = node;
-            return &node->data;
-        }
-    }
-    return nullptr;
+    AVLNodePtr node = FindNode([this, &key](const KEY_T& nodeKey) { return m_info.compareNodes(m_info.context, key, nodeKey); });
+    return node ? &node->data : nullptr;
 }
 
 inline DATA_T* Find(KEY_T&& key) {
     return Find(static_cast<const KEY_T&>(key));
 }
 
+//-----------------------------------------------------------------------------
+// Heterogeneous lookup. Find, Extract and Remove also accept keys of any type
+// LOOKUP_T that KEY_T can be compared with directly (see AVLTreeTraits::isTransparent),
+// e.g. const char* or std::string_view for String keys, so no temporary KEY_T has
+// to be constructed. The lookup comparator must order keys the same way as the
+// tree's comparator; trees with a custom comparator can pass a matching one.
+
+public:
+    // char arrays and char* are looked up as const char*
+    template <typename LOOKUP_T>
+    using LookupType = std::conditional_t<std::is_pointer_v<std::decay_t<LOOKUP_T>>, const std::remove_pointer_t<std::decay_t<LOOKUP_T>>*, std::decay_t<LOOKUP_T>>;
+
+    template <typename LOOKUP_T>
+    using LookupComparator = typename AVLTreeTraits<KEY_T, DATA_T>::template LookupComparator<LookupType<LOOKUP_T>>;
+
+    template <typename LOOKUP_T>
+    using EnableLookup = std::enable_if_t<AVLTreeTraits<KEY_T, DATA_T>::template isTransparent<LookupType<LOOKUP_T>>, int>;
+
+private:
+    template <typename LOOKUP_T>
+    static inline LookupComparator<LOOKUP_T> DefaultLookupComparator(void) {
+        return LookupComparator<LOOKUP_T>(&KEY_T::Compare);
+    }
+
+
+    template <typename LOOKUP_T>
+    inline auto LookupKey(const LookupType<LOOKUP_T>& key, LookupComparator<LOOKUP_T> compareKeys) {
+        return [this, &key, compareKeys](const KEY_T& nodeKey) { return compareKeys(m_info.context, key, nodeKey); };
+    }
+
+public:
+    template <typename LOOKUP_T>
+    DATA_T* Find(const LOOKUP_T& key, LookupComparator<LOOKUP_T> compareKeys)
+    {
+        const LookupType<LOOKUP_T>& lookupKey = key;
+        AVLNodePtr node = FindNode(LookupKey<LOOKUP_T>(lookupKey, compareKeys));
+        return node ? &node->data : nullptr;
+    }
+
+
+    template <typename LOOKUP_T, EnableLookup<LOOKUP_T> = 0>
+    inline DATA_T* Find(const LOOKUP_T& key) {
+        return Find(key, DefaultLookupComparator<LOOKUP_T>());
+    }
+
+
+    template <typename LOOKUP_T>
+    bool Remove(const LOOKUP_T& key, LookupComparator<LOOKUP_T> compareKeys)
+    {
+        const LookupType<LOOKUP_T>& lookupKey = key;
+        return RemoveKey(LookupKey<LOOKUP_T>(lookupKey, compareKeys));
+    }
+
+
+    template <typename LOOKUP_T, EnableLookup<LOOKUP_T> = 0>
+    inline bool Remove(const LOOKUP_T& key) {
+        return Remove(key, DefaultLookupComparator<LOOKUP_T>());
+    }
+
+
+    template <typename LOOKUP_T>
+    bool Extract(const LOOKUP_T& key, DATA_T& data, LookupComparator<LOOKUP_T> compareKeys)
+    {
+        if (not Remove(key, compareKeys))
+            return false;
+        data = std::move(m_info.workingData);
+        return true;
+    }
+
+
+    template <typename LOOKUP_T, EnableLookup<LOOKUP_T> = 0>
+    inline bool Extract(const LOOKUP_T& key, DATA_T& data) {
+        return Extract(key, data, DefaultLookupComparator<LOOKUP_T>());
+    }
+
+//-----------------------------------------------------------------------------
+// Optional reverse index (data -> node) for FindData. Without it, FindData scans
+// the entire tree. With it, insertions and removals also maintain a map ordered
+// by compareData, and FindData is a O(log n) lookup. If several nodes carry the
+// same data, the index returns any one of them.
+// The index only sees data stored through Insert, so data must not be altered in
+// place (via Find, operator[] or an iterator) while the index is enabled; use
+// Insert(key, data, true) instead.
+
+public:
+    void EnableDataIndex(DataComparator compareData, void* context = nullptr)
+    {
+        DisableDataIndex();
+        m_dataIndex = new DataIndex(DataOrder{ compareData, context });
+        IndexNodes(m_info.root);
+    }
+
+
+    void DisableDataIndex(void)
+    {
+        delete m_dataIndex;
+        m_dataIndex = nullptr;
+    }
+
+
+    inline bool HasDataIndex(void) const {
+        return m_dataIndex != nullptr;
+    }
+
+private:
+    inline void IndexNode(AVLNodePtr node) {
+        if (m_dataIndex)
+            m_dataIndex->emplace(node->data, node);
+    }
+
+
+    void IndexNodes(AVLNodePtr node)
+    {
+        if (node) {
+            IndexNodes(node->left);
+            IndexNode(node);
+            IndexNodes(node->right);
+        }
+    }
+
+
+    // points the index entry of node at newNode (after their data has been swapped), or removes it if newNode is null
+    void ReindexNode(AVLNodePtr node, AVLNodePtr newNode = nullptr)
+    {
+        if (not m_dataIndex)
+            return;
+        auto range = m_dataIndex->equal_range(node->data);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == node) {
+                if (newNode)
+                    it->second = newNode;
+                else
+                    m_dataIndex->erase(it);
+                return;
+            }
+        }
+    }
+
 public:
     AVLTree<KEY_T, DATA_T>::AVLNodePtr FindData(const DATA_T& data, AVLNodePtr node = nullptr, bool start = true)
     {
         if (start) {
+            if (m_dataIndex) {
+                auto it = m_dataIndex->find(data);
+                return (it == m_dataIndex->end()) ? nullptr : it->second;
+            }
             node = m_info.root;
-            m_info.workingNode = nullptr;
-            ++m_info.visited;
         }
         if (not node)
             return nullptr;
-        if (node) {
-            if (node->visited == m_info.visited) { // cyclical reference
-                return nullptr;
+        AVLNodePtr result = FindData(data, node->left, false);
+        if (result)
+            return result;
+        if (node->data == data)
+            return node;
+        return FindData(data, node->right, false);
+    }
+
+//-----------------------------------------------------------------------------
+// Order statistics. Each node stores the size of its subtree, so the k-th key
+// and the rank of a key can be determined on a single root to leaf path.
+
+private:
+    AVLNodePtr SelectNode(int k)
+    {
+        if ((k < 0) or (k >= m_info.nodeCount))
+            return nullptr;
+        for (AVLNodePtr node = m_info.root; node != nullptr; ) {
+            int l = AVLNode::SizeOf(node->left);
+            if (k < l)
+                node = node->left;
+            else if (k > l) {
+                k -= l + 1;
+                node = node->right;
             }
-            node->visited = m_info.visited;
-            if (FindData(data, node->left, false))
-                return m_info.workingNode;
-            if (node->data == data)
-                return m_info.workingNode = node;
-            if (FindData(data, node->right, false))
-                return m_info.workingNode;
+            else
+                return node;
         }
         return nullptr;
     }
 
+public:
+    // return the data of the k-th smallest key (k = 0 .. Size() - 1)
+    DATA_T* Select(int k)
+    {
+        AVLNodePtr node = SelectNode(k);
+        return node ? &node->data : nullptr;
+    }
+
+
+    const KEY_T* SelectKey(int k)
+    {
+        AVLNodePtr node = SelectNode(k);
+        return node ? &node->key : nullptr;
+    }
+
+
+    // return the number of keys in the tree that are smaller than key
+    int Rank(const KEY_T& key)
+    {
+        int rank = 0;
+        for (AVLNodePtr node = m_info.root; node != nullptr; ) {
+            if (m_info.compareNodes(m_info.context, key, node->key) <= 0)
+                node = node->left;
+            else {
+                rank += AVLNode::SizeOf(node->left) + 1;
+                node = node->right;
+            }
+        }
+        return rank;
+    }
+
+
+    // return the number of keys k with lo <= k < hi
+    inline int CountRange(const KEY_T& lo, const KEY_T& hi)
+    {
+        int count = Rank(hi) - Rank(lo);
+        return (count > 0) ? count : 0;
+    }
+
 //-----------------------------------------------------------------------------
 
 public:
@@ -214,53 +432,40 @@ void DeleteNode(AVLNodePtr& node) {
 
 //-----------------------------------------------------------------------------
 
-public:
-bool CheckForNullKey(AVLNodePtr root, bool start = true) {
-    return false;
-    if (start) {
-        m_info.testKey = m_info.nullKey;
-        ++m_info.visited;
-    }
-    if (root) {
-        if (root->visited == m_info.visited)
-            return false;
-        root->visited = m_info.visited;
-        if (not CheckForNullKey(root->left, false))
-            return false;
-        if constexpr (std::is_same<DATA_T, int>::value) {
-            if (root->data == 0) {
-                if (m_info.testKey == m_info.nullKey)
-                    m_info.testKey = root->key;
-                else
-                    return false;
-            }
-        }
-        if (not m_info.compareNodes(m_info.context, m_info.nullKey, root->key))
-            return false;
-        if (not CheckForNullKey(root->right, false))
-            return false;
-    }
-return true;
-}
+#if AVL_DEBUG
+// Debug validator. Checks key order, balance factors and subtree sizes. Instead of
+// marking visited nodes (which would turn every traversal into a write to each node),
+// a cycle is detected by the traversal reaching more nodes than the tree holds.
 
- 
-bool CheckForCycles(AVLNodePtr node = nullptr, bool start = true) {
-    return false;
-    if (start) {
-        node = m_info.root;
-        ++m_info.visited;
+private:
+    // returns the height of the subtree, or -1 if it is corrupted
+    int ValidateNodes(AVLNodePtr node, const KEY_T* lo, const KEY_T* hi, int& nodeBudget)
+    {
+        if (not node)
+            return 0;
+        if (--nodeBudget < 0)
+            return -1; // cyclical reference
+        if ((lo and (m_info.compareNodes(m_info.context, node->key, *lo) <= 0)) or (hi and (m_info.compareNodes(m_info.context, node->key, *hi) >= 0)))
+            return -1;
+        int hl = ValidateNodes(node->left, lo, &node->key, nodeBudget);
+        if (hl < 0)
+            return -1;
+        int hr = ValidateNodes(node->right, &node->key, hi, nodeBudget);
+        if (hr < 0)
+            return -1;
+        if ((node->balance != hr - hl) or (node->size != AVLNode::SizeOf(node->left) + AVLNode::SizeOf(node->right) + 1))
+            return -1;
+        return ((hl > hr) ? hl : hr) + 1;
     }
-    if (node) {
-        if (node->visited == m_info.visited)
-            return false;
-        node->visited = m_info.visited;
-        if (not CheckForCycles(node->left, false))
-            return false;
-        if (not CheckForCycles(node->right, false))
-            return false;
+
+public:
+    bool Validate(void)
+    {
+        int nodeBudget = m_info.nodeCount;
+        return (ValidateNodes(m_info.root, nullptr, nullptr, nodeBudget) >= 0) and (nodeBudget == 0);
     }
-    return true;
-}
+
+#endif
 
 //-----------------------------------------------------------------------------
 
@@ -295,6 +500,7 @@ AVLNodePtr InsertNode(AVLNodePtr node, AVLNodePtr parent = nullptr)
     if (rel < 0) {
         if (not (node->left = InsertNode(node->left, node)))
             return node;
+        node->UpdateSize();
         if (m_info.heightHasChanged) {
             switch (node->balance) {
                 case AVL_UNDERFLOW:
@@ -315,6 +521,7 @@ AVLNodePtr InsertNode(AVLNodePtr node, AVLNodePtr parent = nullptr)
     else if (rel > 0) {
         if (not (node->right = InsertNode(node->right, node)))
             return node;
+        node->UpdateSize();
         if (m_info.heightHasChanged) {
             switch (node->balance) {
                 case AVL_OVERFLOW:
@@ -343,38 +550,43 @@ AVLNodePtr InsertNode(AVLNodePtr node, AVLNodePtr parent = nullptr)
 //-----------------------------------------------------------------------------
 
 public:
-    template<typename KEY_T, typename DATA_T>
-    bool Insert(KEY_T&& key, DATA_T&& data, bool updateData = false)
+    template<typename K_T, typename D_T>
+    bool Insert(K_T&& key, D_T&& data, bool updateData = false)
     {
-        m_info.workingKey = std::forward<KEY_T>(key);
+        m_info.workingKey = std::forward<K_T>(key);
         m_info.heightHasChanged = false;
         m_info.isDuplicate = false;
         m_info.workingNode = nullptr;
         m_info.root = InsertNode(m_info.root);
         if (not m_info.workingNode)
             return false;
-        if (not m_info.isDuplicate or updateData)
-            m_info.workingNode->data = std::move(data);
+        if (not m_info.isDuplicate or updateData) {
+            if (m_info.isDuplicate)
+                ReindexNode(m_info.workingNode);
+            m_info.workingNode->data = std::forward<D_T>(data);
+            IndexNode(m_info.workingNode);
+        }
         return true;
     }
 
     bool Insert2(const KEY_T& key, const DATA_T& data, const KEY_T& nullKey, bool updateData = false)
     {
         m_info.workingKey = std::move(key);
-        m_info.nullKey = nullKey;
-        m_info.testKey = nullKey;
         m_info.heightHasChanged = false;
         m_info.isDuplicate = false;
         m_info.root = InsertNode(m_info.root);
 #if AVL_DEBUG
-        CheckForCycles(m_info.root, true);
+        if (not Validate())
+            fprintf(stderr, "AVLTree::Insert2: tree structure is corrupted\n");
 #endif
         if (not m_info.workingNode)
             return false;
-        if (not m_info.isDuplicate)
-            m_info.workingNode->data = std::move(data);
-        else if (updateData)
+        if (not m_info.isDuplicate or updateData) {
+            if (m_info.isDuplicate)
+                ReindexNode(m_info.workingNode);
             m_info.workingNode->data = std::move(data);
+            IndexNode(m_info.workingNode);
+        }
         return true;
     }
 
@@ -457,6 +669,7 @@ private:
 #else
                 UnlinkNode(node->right);
 #endif
+            node->UpdateSize();
             return m_info.heightHasChanged ? BalanceRightShrink(node) : node;
         }
         else {
@@ -473,12 +686,10 @@ private:
 #else
             //m_info.workingKey = std::move(m_info.workingNode->key);
             //m_info.workingData = std::move(m_info.workingNode->data);
+            ReindexNode(node, m_info.workingNode);
             std::swap(m_info.workingNode->key, node->key);
             std::swap(m_info.workingNode->data, node->data);
             m_info.workingNode = node;
-#if AVL_DEBUG
-            CheckForCycles(m_info.root, true);
-#endif
             return node->left; // this unlinks the node to be deleted and makes it left subtree the left subtree of the node that replaces it
 #endif
         }
@@ -487,27 +698,30 @@ private:
 //-----------------------------------------------------------------------------
 
 private:
-    AVLNodePtr RemoveNode(AVLNodePtr node, AVLNodePtr parent = nullptr)
+    template <typename COMPARE_T>
+    AVLNodePtr RemoveNode(AVLNodePtr node, COMPARE_T& compareKey, AVLNodePtr parent = nullptr)
     {
         if (not node)
             m_info.heightHasChanged = false;
         else {
-            int rel = m_info.compareNodes(m_info.context, m_info.workingKey, node->key);
+            int rel = compareKey(node->key);
             if (rel < 0) {
-                if (not (node->left = RemoveNode(node->left, node)))
-                    return node;
+                node->left = RemoveNode(node->left, compareKey, node);
+                node->UpdateSize();
                 if (m_info.heightHasChanged)
                     node = BalanceLeftShrink(node);
             }
             else if (rel > 0) {
-                if (not (node->right = RemoveNode(node->right, node)))
-                    return node;
+                node->right = RemoveNode(node->right, compareKey, node);
+                node->UpdateSize();
                 if (m_info.heightHasChanged)
                     node =  BalanceRightShrink(node);
             }
             else {
                 m_info.workingParent = parent;
                 m_info.workingNode = node; // node to be deleted
+                m_info.result = true;
+                ReindexNode(node);
                 m_info.workingData = std::move(node->data);
                 if (not node->right) {
                     m_info.heightHasChanged = true;
@@ -523,6 +737,7 @@ private:
 #else
                     node->left = UnlinkNode(node->left);
 #endif
+                    node->UpdateSize();
                     if (m_info.heightHasChanged)
                         node = BalanceLeftShrink(node);
                 }
@@ -534,35 +749,28 @@ private:
 
 //-----------------------------------------------------------------------------
 
-public:
-    template<typename KEY_T>
-    bool Remove(KEY_T&& key)
+private:
+    template <typename COMPARE_T>
+    bool RemoveKey(COMPARE_T compareKey)
     {
         if (not m_info.root or not m_info.compareNodes)
             return false;
-#if 0
-        DATA_T* data = Find(std::forward<KEY_T>(key));
-        if (not data)
-            return false;
-        m_info.workingData = std::move(*data);
-        if constexpr (std::is_trivially_constructible<DATA_T>::value)
-            *data = -1;
-        return true;
-#else
-        m_info.workingKey = std::forward<KEY_T>(key);
         m_info.workingNode = nullptr;
         m_info.heightHasChanged = false;
         m_info.result = false;
-        //AVLTree backup(*this);
-        m_info.root = RemoveNode(m_info.root);
-        if (m_info.result)
+        m_info.root = RemoveNode(m_info.root, compareKey);
+        if (not m_info.result)
             return false;
 #if AVL_DEBUG
-        if (not CheckForCycles(m_info.root, true))
-            ;//  backup.Remove(key);
+        if (not Validate())
+            fprintf(stderr, "AVLTree::Remove: tree structure is corrupted\n");
 #endif
         return true;
-#endif
+    }
+
+public:
+    bool Remove(const KEY_T& key) {
+        return RemoveKey([this, &key](const KEY_T& nodeKey) { return m_info.compareNodes(m_info.context, key, nodeKey); });
     }
 
 //-----------------------------------------------------------------------------
@@ -583,22 +791,23 @@ public:
     void Destroy(void)
     {
         DestroyNodes(m_info.root);
+        if (m_dataIndex)
+            m_dataIndex->clear();
     }
 
 //-----------------------------------------------------------------------------
 
 private:
-    bool WalkNodes(AVLNodePtr root)
+    // callback and context are passed down rather than stored in m_info, so walking neither
+    // writes to the tree nor clobbers the comparator context
+    static bool WalkNodes(AVLNodePtr root, DataProcessor processNode, void* context)
     {
         if (root) {
-            if (root->visited == m_info.visited)
-                return false; // circular reference
-            root->visited = m_info.visited;
-            if (not WalkNodes(root->left))
+            if (not WalkNodes(root->left, processNode, context))
                 return false;
-            if (not m_info.processNode(m_info.context, root->key, root->data))
+            if (not processNode(context, root->key, root->data))
                 return false;
-            if (not WalkNodes(root->right))
+            if (not WalkNodes(root->right, processNode, context))
                 return false;
         }
         return true;
@@ -608,12 +817,9 @@ private:
 
 public:
 public:
-    bool Walk(DataProcessor processNode, void* context = nullptr)
+    bool Walk(DataProcessor processNode, void* context = nullptr) const
     {
-        m_info.processNode = processNode;
-        m_info.context = context;
-        m_info.visited++;
-        return WalkNodes(m_info.root);
+        return WalkNodes(m_info.root, processNode, context);
     } /*AvlWalk*/
 
 //-----------------------------------------------------------------------------
@@ -643,27 +849,686 @@ public:
     }
 
 //-----------------------------------------------------------------------------
+// In-order iterator. The iterator keeps the path from the root to the current
+// node on a fixed size stack, so nodes don't need parent pointers and stepping
+// in either direction costs amortized O(1). An empty stack marks end().
+// Dereferencing yields a (key, data) pair, so range-for loops can unpack it:
+//    for (auto [key, data] : tree.Range(lo, hi)) ...
+
+public:
+    class Iterator {
+    public:
+        static constexpr int maxDepth = 64; // AVL height <= 1.44 * log2(n + 2)
+
+    private:
+        AVLNodePtr  m_root;
+        AVLNodePtr  m_path[maxDepth];
+        int         m_depth;
+
+    public:
+        explicit Iterator(AVLNodePtr root = nullptr)
+            : m_root(root), m_depth(0)
+        { }
+
+        inline AVLNodePtr Node(void) const {
+            return m_depth ? m_path[m_depth - 1] : nullptr;
+        }
+
+        inline void Push(AVLNodePtr node) {
+            m_path[m_depth++] = node;
+        }
+
+        inline void Truncate(int depth) {
+            m_depth = depth;
+        }
+
+        inline int Depth(void) const {
+            return m_depth;
+        }
+
+        Iterator& First(void) {
+            m_depth = 0;
+            for (AVLNodePtr node = m_root; node; node = node->left)
+                Push(node);
+            return *this;
+        }
+
+        Iterator& Last(void) {
+            m_depth = 0;
+            for (AVLNodePtr node = m_root; node; node = node->right)
+                Push(node);
+            return *this;
+        }
+
+        Iterator& operator++() {
+            if (not m_depth)
+                return *this;
+            AVLNodePtr node = m_path[m_depth - 1];
+            if (node->right) {
+                for (node = node->right; node; node = node->left)
+                    Push(node);
+            }
+            else {
+                // climb up until we leave a left subtree
+                --m_depth;
+                while (m_depth and (m_path[m_depth - 1]->right == node))
+                    node = m_path[--m_depth];
+            }
+            return *this;
+        }
+
+        Iterator& operator--() {
+            if (not m_depth) // end() - step back to the biggest key
+                return Last();
+            AVLNodePtr node = m_path[m_depth - 1];
+            if (node->left) {
+                for (node = node->left; node; node = node->right)
+                    Push(node);
+            }
+            else {
+                // climb up until we leave a right subtree
+                --m_depth;
+                while (m_depth and (m_path[m_depth - 1]->left == node))
+                    node = m_path[--m_depth];
+            }
+            return *this;
+        }
+
+        inline Iterator operator++(int) {
+            Iterator it = *this;
+            ++(*this);
+            return it;
+        }
+
+        inline Iterator operator--(int) {
+            Iterator it = *this;
+            --(*this);
+            return it;
+        }
+
+        inline std::pair<const KEY_T&, DATA_T&> operator*() const {
+            AVLNodePtr node = m_path[m_depth - 1];
+            return std::pair<const KEY_T&, DATA_T&>(node->key, node->data);
+        }
+
+        inline const KEY_T& Key(void) const {
+            return m_path[m_depth - 1]->key;
+        }
+
+        inline DATA_T& Data(void) const {
+            return m_path[m_depth - 1]->data;
+        }
+
+        operator bool() const {
+            return m_depth != 0;
+        }
+
+        inline bool operator==(const Iterator& other) const {
+            return Node() == other.Node();
+        }
+
+        inline bool operator!=(const Iterator& other) const {
+            return Node() != other.Node();
+        }
+    };
+
+//-----------------------------------------------------------------------------
+
+public:
+    class IteratorRange {
+    public:
+        Iterator    first;
+        Iterator    last;
+
+        IteratorRange(const Iterator& first, const Iterator& last)
+            : first(first), last(last)
+        { }
+
+        inline Iterator begin() const {
+            return first;
+        }
+
+        inline Iterator end() const {
+            return last;
+        }
+    };
+
+//-----------------------------------------------------------------------------
+
+public:
+    inline Iterator begin() {
+        return Iterator(m_info.root).First();
+    }
+
+    inline Iterator end() {
+        return Iterator(m_info.root);
+    }
+
+//-----------------------------------------------------------------------------
+// Bound searches keep the root path of the last node that qualified, so the
+// returned iterator can step on from there without another search.
 
 private:
-    void ExtractMin(AVLNodePtr& root, bool& heightHasChanged)
+    template<bool isUpperBound>
+    Iterator Bound(const KEY_T& key)
     {
-        AVLNodePtr r = root;
+        Iterator it(m_info.root);
+        int depth = 0;
+        for (AVLNodePtr node = m_info.root; node != nullptr; ) {
+            it.Push(node);
+            int rel = m_info.compareNodes(m_info.context, key, node->key);
+            if (isUpperBound ? (rel < 0) : (rel <= 0)) {
+                depth = it.Depth();
+                node = node->left;
+            }
+            else
+                node = node->right;
+        }
+        it.Truncate(depth);
+        return it;
+    }
 
-        if (not r)
-            m_info.heightHasChanged = false;
-        else if (r->left) {
-            ExtractMin(r->left);
-            if (heightHasChanged)
-                AvlBalanceLShrink(r, heightHasChanged);
+public:
+    // first entry with a key >= key
+    inline Iterator LowerBound(const KEY_T& key) {
+        return Bound<false>(key);
+    }
+
+    // first entry with a key > key
+    inline Iterator UpperBound(const KEY_T& key) {
+        return Bound<true>(key);
+    }
+
+    inline IteratorRange EqualRange(const KEY_T& key) {
+        return IteratorRange(LowerBound(key), UpperBound(key));
+    }
+
+    // all entries with lo <= key < hi
+    IteratorRange Range(const KEY_T& lo, const KEY_T& hi) {
+        Iterator first = LowerBound(lo);
+        if (m_info.compareNodes(m_info.context, lo, hi) >= 0)
+            return IteratorRange(first, first);
+        return IteratorRange(first, LowerBound(hi));
+    }
+
+//-----------------------------------------------------------------------------
+// ParallelWalk cuts the tree into chunks of (almost) equal node counts by rank,
+// using the subtree sizes to position an iterator at the start of each chunk.
+// Threads claim chunks from a shared counter, so threads that are done early
+// pick up the remaining chunks. There are several chunks per thread to even
+// out uneven per node costs.
+// processNode is called concurrently and must be thread safe. The tree must not
+// be modified during the walk (walking itself doesn't write to the tree).
+// The result variant hands each chunk its own result slot; the slots are ordered
+// by key, so merging them front to back yields the same result as a serial walk.
+
+public:
+    static constexpr int chunksPerThread = 4;
+
+private:
+    // iterator positioned at the k-th smallest key
+    Iterator IteratorAt(int k)
+    {
+        Iterator it(m_info.root);
+        for (AVLNodePtr node = m_info.root; node != nullptr; ) {
+            it.Push(node);
+            int l = AVLNode::SizeOf(node->left);
+            if (k < l)
+                node = node->left;
+            else if (k > l) {
+                k -= l + 1;
+                node = node->right;
+            }
+            else
+                break;
+        }
+        return it;
+    }
+
+
+    inline int ChunkCount(int threadCount) {
+        return std::min(m_info.nodeCount, threadCount * chunksPerThread);
+    }
+
+
+    // processChunk(chunk index, iterator at the first node of the chunk, node count)
+    template <typename FUNC_T>
+    bool WalkChunks(FUNC_T processChunk, int threadCount)
+    {
+        int nodeCount = m_info.nodeCount;
+        int chunkCount = ChunkCount(threadCount);
+        threadCount = std::min(threadCount, chunkCount); // no idle threads for tiny trees
+        std::atomic<int> nextChunk(0);
+        std::atomic<bool> result(true);
+        auto worker = [&]() {
+            for (int i; result.load(std::memory_order_relaxed) and ((i = nextChunk++) < chunkCount); ) {
+                int first = int(int64_t(nodeCount) * i / chunkCount);
+                int last = int(int64_t(nodeCount) * (i + 1) / chunkCount);
+                if (not processChunk(i, IteratorAt(first), last - first))
+                    result = false;
+            }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (int i = 1; i < threadCount; i++)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& t : threads)
+            t.join();
+        return result;
+    }
+
+
+    static inline int ThreadCount(int threadCount) {
+        if (threadCount <= 0)
+            threadCount = int(std::thread::hardware_concurrency());
+        return std::max(threadCount, 1);
+    }
+
+public:
+    // threadCount 0: use all hardware threads. Nodes are processed in no particular order.
+    // Returns false if processNode returned false for any node; the walk stops as soon as possible then.
+    bool ParallelWalk(DataProcessor processNode, void* context = nullptr, int threadCount = 0)
+    {
+        if (not m_info.root)
+            return true;
+        return WalkChunks(
+            [processNode, context](int, Iterator it, int count) {
+                for (; count; --count, ++it)
+                    if (not processNode(context, it.Key(), it.Data()))
+                        return false;
+                return true;
+            },
+            ThreadCount(threadCount));
+    }
+
+
+    // Processes the nodes of each chunk in key order, passing the chunk's result slot as last
+    // argument of processNode. results is resized to the number of chunks.
+    // The chunks work on slots of their own and results is only filled after the walk, so
+    // RESULT_T may be bool even though std::vector<bool> packs its items into shared words.
+    template <typename RESULT_T>
+    bool ParallelWalk(bool(*processNode)(void*, const KEY_T&, const DATA_T&, RESULT_T&), std::vector<RESULT_T>& results, void* context = nullptr, int threadCount = 0)
+    {
+        threadCount = ThreadCount(threadCount);
+        int chunkCount = ChunkCount(threadCount);
+        results.assign(chunkCount, RESULT_T());
+        if (not m_info.root)
+            return true;
+        std::unique_ptr<RESULT_T[]> slots(new RESULT_T[chunkCount]());
+        bool result = WalkChunks(
+            [processNode, context, &slots](int chunk, Iterator it, int count) {
+                RESULT_T& result = slots[chunk];
+                for (; count; --count, ++it)
+                    if (not processNode(context, it.Key(), it.Data(), result))
+                        return false;
+                return true;
+            },
+            threadCount);
+        std::move(slots.get(), slots.get() + chunkCount, results.begin());
+        return result;
+    }
+
+//-----------------------------------------------------------------------------
+// Join based split and set operations (Blelloch, Ferizovic, Sun: "Just Join for
+// Parallel Ordered Sets"). Join(l, k, r) links two trees and a middle node in
+// time proportional to the difference of their heights; everything else is
+// built on top of it. Nodes are relinked rather than copied, so set operations
+// don't allocate, and Union, Intersection and Difference cost O(m log(n/m + 1))
+// for trees of sizes m <= n.
+// Heights aren't stored in the nodes; they are derived from the balance factors
+// while descending. Both trees must use the same comparator. With a data index,
+// the index is rebuilt after each of these operations.
+
+private:
+    using NodeList = std::vector<AVLNodePtr>;
+
+    static constexpr int minParallelSize = 4096; // don't fork for subtrees smaller than that
+
+    static int Height(AVLNodePtr node)
+    {
+        int h = 0;
+        for (; node; node = (node->balance == AVL_OVERFLOW) ? node->right : node->left)
+            ++h;
+        return h;
+    }
+
+
+    static inline int LeftHeight(AVLNodePtr node, int h) {
+        return h - ((node->balance == AVL_OVERFLOW) ? 2 : 1);
+    }
+
+
+    static inline int RightHeight(AVLNodePtr node, int h) {
+        return h - ((node->balance == AVL_UNDERFLOW) ? 2 : 1);
+    }
+
+
+    // makes left and right (whose heights differ by one at most) the children of node; returns the height of node
+    static int Link(AVLNodePtr node, AVLNodePtr left, int hl, AVLNodePtr right, int hr)
+    {
+        node->left = left;
+        node->right = right;
+        node->balance = char(hr - hl);
+        node->UpdateSize();
+        return std::max(hl, hr) + 1;
+    }
+
+
+    // like Link, but left and right may differ in height by two, which is fixed by a single or double rotation
+    static AVLNodePtr Rebalance(AVLNodePtr node, AVLNodePtr left, int hl, AVLNodePtr right, int hr, int& h)
+    {
+        if (hr > hl + 1) {
+            int hrl = LeftHeight(right, hr);
+            int hrr = RightHeight(right, hr);
+            AVLNodePtr rl = right->left;
+            if (hrl <= hrr) {
+                h = Link(right, node, Link(node, left, hl, rl, hrl), right->right, hrr);
+                return right;
+            }
+            int hn = Link(node, left, hl, rl->left, LeftHeight(rl, hrl));
+            h = Link(rl, node, hn, right, Link(right, rl->right, RightHeight(rl, hrl), right->right, hrr));
+            return rl;
+        }
+        if (hl > hr + 1) {
+            int hll = LeftHeight(left, hl);
+            int hlr = RightHeight(left, hl);
+            AVLNodePtr lr = left->right;
+            if (hlr <= hll) {
+                h = Link(left, left->left, hll, node, Link(node, lr, hlr, right, hr));
+                return left;
+            }
+            int hn = Link(node, lr->right, RightHeight(lr, hlr), right, hr);
+            h = Link(lr, left, Link(left, left->left, hll, lr->left, LeftHeight(lr, hlr)), node, hn);
+            return lr;
+        }
+        h = Link(node, left, hl, right, hr);
+        return node;
+    }
+
+
+    // all keys in left < key of node < all keys in right
+    static AVLNodePtr JoinNodes(AVLNodePtr left, int hl, AVLNodePtr node, AVLNodePtr right, int hr, int& h)
+    {
+        if (hl > hr + 1) {
+            int hj;
+            AVLNodePtr joined = JoinNodes(left->right, RightHeight(left, hl), node, right, hr, hj);
+            return Rebalance(left, left->left, LeftHeight(left, hl), joined, hj, h);
+        }
+        if (hr > hl + 1) {
+            int hj;
+            AVLNodePtr joined = JoinNodes(left, hl, node, right->left, LeftHeight(right, hr), hj);
+            return Rebalance(right, joined, hj, right->right, RightHeight(right, hr), h);
+        }
+        h = Link(node, left, hl, right, hr);
+        return node;
+    }
+
+
+    // unlinks the node with the biggest key from the subtree; returns the rebalanced rest of the subtree
+    static AVLNodePtr SplitLast(AVLNodePtr node, int h, AVLNodePtr& last, int& hRest)
+    {
+        if (not node->right) {
+            last = node;
+            hRest = h - 1;
+            return node->left;
+        }
+        int hr;
+        AVLNodePtr right = SplitLast(node->right, RightHeight(node, h), last, hr);
+        return JoinNodes(node->left, LeftHeight(node, h), node, right, hr, hRest);
+    }
+
+
+    // all keys in left < all keys in right
+    static AVLNodePtr JoinTrees(AVLNodePtr left, int hl, AVLNodePtr right, int hr, int& h)
+    {
+        if (not left) {
+            h = hr;
+            return right;
+        }
+        AVLNodePtr last;
+        int hRest;
+        left = SplitLast(left, hl, last, hRest);
+        return JoinNodes(left, hRest, last, right, hr, h);
+    }
+
+
+    // Splits the subtree into the nodes with keys < key and > key. Returns the unlinked node with key, if any.
+    AVLNodePtr SplitNodes(AVLNodePtr node, int h, const KEY_T& key, AVLNodePtr& left, int& hl, AVLNodePtr& right, int& hr)
+    {
+        if (not node) {
+            left = right = nullptr;
+            hl = hr = 0;
+            return nullptr;
+        }
+        int rel = m_info.compareNodes(m_info.context, key, node->key);
+        if (rel == 0) {
+            left = node->left;
+            hl = LeftHeight(node, h);
+            right = node->right;
+            hr = RightHeight(node, h);
+            return node;
+        }
+        AVLNodePtr match;
+        if (rel < 0) {
+            AVLNodePtr rest;
+            int hRest;
+            match = SplitNodes(node->left, LeftHeight(node, h), key, left, hl, rest, hRest);
+            right = JoinNodes(rest, hRest, node, node->right, RightHeight(node, h), hr);
         }
         else {
-            AVLNodePtr d = r;
-            m_info.data = r->data;
-            r = nullptr;
-            DeleteNode(d);
-            heightHasChanged = true;
+            AVLNodePtr rest;
+            int hRest;
+            match = SplitNodes(node->right, RightHeight(node, h), key, rest, hRest, right, hr);
+            left = JoinNodes(node->left, LeftHeight(node, h), node, rest, hRest, hl);
+        }
+        return match;
+    }
+
+
+    static void CollectNodes(AVLNodePtr node, NodeList& nodes)
+    {
+        if (node) {
+            CollectNodes(node->left, nodes);
+            CollectNodes(node->right, nodes);
+            nodes.push_back(node);
+        }
+    }
+
+
+    // Runs left and right on a separate thread each while depth > 0 and there is enough work.
+    // Each branch collects the nodes it discards in its own list.
+    template <typename LEFT_T, typename RIGHT_T>
+    static void Fork(int depth, int size, NodeList& discarded, LEFT_T left, RIGHT_T right)
+    {
+        if ((depth <= 0) or (size < minParallelSize)) {
+            left(discarded, 0);
+            right(discarded, 0);
+            return;
+        }
+        NodeList leftDiscarded;
+        std::thread thread([&]() { left(leftDiscarded, depth - 1); });
+        right(discarded, depth - 1);
+        thread.join();
+        discarded.insert(discarded.end(), leftDiscarded.begin(), leftDiscarded.end());
+    }
+
+
+    // duplicate keys keep the node from t1
+    AVLNodePtr UnionNodes(AVLNodePtr t1, int h1, AVLNodePtr t2, int h2, int& h, NodeList& discarded, int depth)
+    {
+        if (not t1 or not t2) {
+            h = t1 ? h1 : h2;
+            return t1 ? t1 : t2;
+        }
+        AVLNodePtr l2, r2, l, r;
+        int hl2, hr2, hl, hr;
+        AVLNodePtr match = SplitNodes(t2, h2, t1->key, l2, hl2, r2, hr2);
+        if (match)
+            discarded.push_back(match);
+        Fork(depth, AVLNode::SizeOf(t1) + AVLNode::SizeOf(t2), discarded,
+            [&](NodeList& d, int forkDepth) { l = UnionNodes(t1->left, LeftHeight(t1, h1), l2, hl2, hl, d, forkDepth); },
+            [&](NodeList& d, int forkDepth) { r = UnionNodes(t1->right, RightHeight(t1, h1), r2, hr2, hr, d, forkDepth); });
+        return JoinNodes(l, hl, t1, r, hr, h);
+    }
+
+
+    // t2 is only read
+    AVLNodePtr IntersectNodes(AVLNodePtr t1, int h1, AVLNodePtr t2, int& h, NodeList& discarded, int depth)
+    {
+        if (not t1 or not t2) {
+            CollectNodes(t1, discarded);
+            h = 0;
+            return nullptr;
+        }
+        AVLNodePtr l1, r1, l, r;
+        int hl1, hr1, hl, hr;
+        AVLNodePtr match = SplitNodes(t1, h1, t2->key, l1, hl1, r1, hr1);
+        Fork(depth, AVLNode::SizeOf(t1) + AVLNode::SizeOf(t2), discarded,
+            [&](NodeList& d, int forkDepth) { l = IntersectNodes(l1, hl1, t2->left, hl, d, forkDepth); },
+            [&](NodeList& d, int forkDepth) { r = IntersectNodes(r1, hr1, t2->right, hr, d, forkDepth); });
+        return match ? JoinNodes(l, hl, match, r, hr, h) : JoinTrees(l, hl, r, hr, h);
+    }
+
+
+    // t2 is only read
+    AVLNodePtr DifferenceNodes(AVLNodePtr t1, int h1, AVLNodePtr t2, int& h, NodeList& discarded, int depth)
+    {
+        if (not t1 or not t2) {
+            h = h1;
+            return t1;
+        }
+        AVLNodePtr l1, r1, l, r;
+        int hl1, hr1, hl, hr;
+        AVLNodePtr match = SplitNodes(t1, h1, t2->key, l1, hl1, r1, hr1);
+        if (match)
+            discarded.push_back(match);
+        Fork(depth, AVLNode::SizeOf(t1) + AVLNode::SizeOf(t2), discarded,
+            [&](NodeList& d, int forkDepth) { l = DifferenceNodes(l1, hl1, t2->left, hl, d, forkDepth); },
+            [&](NodeList& d, int forkDepth) { r = DifferenceNodes(r1, hr1, t2->right, hr, d, forkDepth); });
+        return JoinTrees(l, hl, r, hr, h);
+    }
+
+
+    static int ForkDepth(int threadCount)
+    {
+        int depth = 0;
+        for (; (1 << depth) < threadCount; ++depth)
+            ;
+        return depth;
+    }
+
+
+    // takes over the subtree root and frees the discarded nodes
+    void SetRoot(AVLNodePtr root, NodeList* discarded = nullptr)
+    {
+        m_info.root = root;
+        if (discarded) {
+            for (AVLNodePtr node : *discarded)
+                DeleteNode(node);
+        }
+        m_info.nodeCount = AVLNode::SizeOf(root);
+        if (m_dataIndex) {
+            m_dataIndex->clear();
+            IndexNodes(m_info.root);
         }
-        root = r;
+    }
+
+public:
+    // moves all entries with keys >= key to right (which is emptied first)
+    void Split(const KEY_T& key, AVLTree& right)
+    {
+        right.Destroy();
+        AVLNodePtr l, r;
+        int hl, hr;
+        AVLNodePtr match = SplitNodes(m_info.root, Height(m_info.root), key, l, hl, r, hr);
+        if (match)
+            r = JoinNodes(nullptr, 0, match, r, hr, hr);
+        SetRoot(l);
+        right.SetRoot(r);
+    }
+
+
+    // Appends all entries of right to this tree. All keys in right must be bigger than the keys in this tree.
+    bool Join(AVLTree& right)
+    {
+        if (not right.m_info.root)
+            return true;
+        if (m_info.root and (m_info.compareNodes(m_info.context, *SelectKey(m_info.nodeCount - 1), *right.SelectKey(0)) >= 0))
+            return false;
+        int h;
+        AVLNodePtr root = JoinTrees(m_info.root, Height(m_info.root), right.m_info.root, Height(right.m_info.root), h);
+        right.SetRoot(nullptr);
+        SetRoot(root);
+        return true;
+    }
+
+
+    // Appends a new entry (key, data) and all entries of right to this tree. key must be bigger than
+    // the keys in this tree, and smaller than the keys in right.
+    bool Join(const KEY_T& key, const DATA_T& data, AVLTree& right)
+    {
+        if ((m_info.root and (m_info.compareNodes(m_info.context, *SelectKey(m_info.nodeCount - 1), key) >= 0)) or
+            (right.m_info.root and (m_info.compareNodes(m_info.context, key, *right.SelectKey(0)) >= 0)))
+            return false;
+        m_info.workingKey = key;
+        AVLNodePtr node = AllocNode();
+        if (not node)
+            return false;
+        node->data = data;
+        int h;
+        AVLNodePtr root = JoinNodes(m_info.root, Height(m_info.root), node, right.m_info.root, Height(right.m_info.root), h);
+        right.SetRoot(nullptr);
+        SetRoot(root);
+        return true;
+    }
+
+
+    // Moves all entries of other into this tree; entries whose keys are in both trees keep the data from this tree.
+    // threadCount > 1 processes independent subtrees in parallel (the comparator must be thread safe then).
+    void Union(AVLTree& other, int threadCount = 1)
+    {
+        NodeList discarded;
+        int h;
+        AVLNodePtr root = UnionNodes(m_info.root, Height(m_info.root), other.m_info.root, Height(other.m_info.root), h, discarded, ForkDepth(threadCount));
+        other.SetRoot(nullptr);
+        SetRoot(root, &discarded);
+    }
+
+
+    // removes all entries whose keys are not in other
+    void Intersection(AVLTree& other, int threadCount = 1)
+    {
+        NodeList discarded;
+        int h;
+        SetRoot(IntersectNodes(m_info.root, Height(m_info.root), other.m_info.root, h, discarded, ForkDepth(threadCount)), &discarded);
+    }
+
+
+    // removes all entries whose keys are in other
+    void Difference(AVLTree& other, int threadCount = 1)
+    {
+        NodeList discarded;
+        int h;
+        SetRoot(DifferenceNodes(m_info.root, Height(m_info.root), other.m_info.root, h, discarded, ForkDepth(threadCount)), &discarded);
+    }
+
+//-----------------------------------------------------------------------------
+
+private:
+    AVLNodePtr ExtractMinNode(AVLNodePtr node)
+    {
+        if (node->left) {
+            node->left = ExtractMinNode(node->left);
+            node->UpdateSize();
+            return m_info.heightHasChanged ? BalanceLeftShrink(node) : node;
+        }
+        AVLNodePtr child = node->right;
+        ReindexNode(node);
+        m_info.workingData = std::move(node->data);
+        m_info.heightHasChanged = true;
+        DeleteNode(node);
+        return child;
     }
 
 //-----------------------------------------------------------------------------
@@ -674,33 +1539,27 @@ public:
         if (not m_info.root)
             return false;
         m_info.heightHasChanged = false;
-        ExtractMin(m_info.root, m_info.heightHasChanged);
-        data = m_info.data;
+        m_info.root = ExtractMinNode(m_info.root);
+        data = std::move(m_info.workingData);
         return true;
     }
 
 //-----------------------------------------------------------------------------
 
 private:
-    void ExtractMax(AVLNodePtr& root, bool& heightHasChanged)
+    AVLNodePtr ExtractMaxNode(AVLNodePtr node)
     {
-        AVLNodePtr r = root;
-
-        if (not r)
-            m_info.heightHasChanged = false;
-        else if (r->right) {
-            ExtractMax(r->right);
-            if (heightHasChanged)
-                AvlBalanceRShrink(r, heightHasChanged);
-        }
-        else {
-            AVLNodePtr d = r;
-            m_info.data = r->data;
-            r = nullptr;
-            DeleteNode(d);
-            heightHasChanged = true;
+        if (node->right) {
+            node->right = ExtractMaxNode(node->right);
+            node->UpdateSize();
+            return m_info.heightHasChanged ? BalanceRightShrink(node) : node;
         }
-        root = r;
+        AVLNodePtr child = node->left;
+        ReindexNode(node);
+        m_info.workingData = std::move(node->data);
+        m_info.heightHasChanged = true;
+        DeleteNode(node);
+        return child;
     }
 
 //-----------------------------------------------------------------------------
@@ -711,8 +1570,8 @@ public:
         if (not m_info.root)
             return false;
         m_info.heightHasChanged = false;
-        ExtractMax(m_info.root, m_info.heightHasChanged);
-        data = m_info.data;
+        m_info.root = ExtractMaxNode(m_info.root);
+        data = std::move(m_info.workingData);
         return true;
     }
 
@@ -731,10 +1590,10 @@ public:
 //-----------------------------------------------------------------------------
 
 public:
-    template<typename KEY_T>
-    inline DATA_T& operator[] (KEY_T&& key)
+    template<typename K_T>
+    inline DATA_T& operator[] (K_T&& key)
     {
-        DATA_T* p = Find(std::forward<KEY_T>(key));
+        DATA_T* p = Find(std::forward<K_T>(key));
         return p ? *p : throw std::invalid_argument("not found");
     }
 
@@ -758,26 +1617,41 @@ private:
 //-----------------------------------------------------------------------------
 
 public:
-    AVLTree(AVLTree& other) {
+    // copies use the comparator of the tree they copy
+    AVLTree(const AVLTree& other)
+        : AVLTree()
+    {
+        SetComparator(other.m_info.compareNodes, other.m_info.context);
         Copy(other);
     }
 
     AVLTree& operator=(const AVLTree& other) {
-        Destroy();
-        Copy(other);
+        if (&other != this) {
+            Destroy();
+            SetComparator(other.m_info.compareNodes, other.m_info.context);
+            Copy(other);
+        }
+        return *this;
     }
 
+    // adds copies of the entries of other whose keys aren't in this tree yet
     AVLTree& operator+=(const AVLTree& other) {
-        Copy(other);
+        if (&other != this) {
+            AVLTree entries;
+            entries.SetComparator(m_info.compareNodes, m_info.context);
+            Union(entries.Copy(other));
+        }
+        return *this;
     }
 
-    inline AVLTree& Copy(AVLTree& other)
+    // inserts copies of the entries of other
+    inline AVLTree& Copy(const AVLTree& other)
     {
 #if DEBUG_MALLOC
         m_nodePool = other.m_nodePool;
         m_useNodePool = other.m_useNodePool;
 #endif
-        Walk(CopyData, this);
+        other.Walk(CopyData, this);
         return *this;
     }
 
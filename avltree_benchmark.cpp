@@ -0,0 +1,131 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Compares the C avl tree (node per malloc, pooled nodes, bulk built) with the C++ AVLTree
+// on random insertions, lookups, in-order walks and removals of int keys.
+// Build e.g. with: cc -O2 -c avltree.c && c++ -O2 -std=c++20 avltree_benchmark.cpp avltree.o
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+
+#include "avltree.h"
+#include "avltree.hpp"
+
+// =================================================================================================
+
+static int CompareValues(const void* a, const void* b) {
+    int i = *static_cast<const int*>(a), j = *static_cast<const int*>(b);
+    return (i < j) ? -1 : (i > j) ? 1 : 0;
+}
+
+static int CompareKeys(void* /*context*/, const int& i, const int& j) {
+    return (i < j) ? -1 : (i > j) ? 1 : 0;
+}
+
+static long long keySum = 0;
+
+static bool SumValue(void* const value) {
+    keySum += *static_cast<int*>(value);
+    return true;
+}
+
+static bool SumKey(void* /*context*/, const int& key, const int& /*data*/) {
+    keySum += key;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+class Timer {
+    std::chrono::steady_clock::time_point   m_start;
+
+public:
+    Timer() : m_start(std::chrono::steady_clock::now()) {}
+
+    double Elapsed(void) const { // ms
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+static void BenchmarkCTree(const char* name, const std::vector<int>& keys, int poolBlockSize, bool bulk)
+{
+    std::vector<int> values(keys);
+    avlTreeDescriptor_t* tree = avltree_create_pooled(const_cast<char*>("int"), sizeof(int), CompareValues, poolBlockSize);
+    Timer insertTimer;
+    if (bulk) {
+        std::sort(values.begin(), values.end());
+        std::vector<void*> sorted(values.size());
+        for (size_t i = 0; i < values.size(); i++)
+            sorted[i] = &values[i];
+        avltree_insert_bulk(tree, sorted.data(), int(sorted.size()));
+    }
+    else {
+        for (int& v : values)
+            avltree_insert(tree, &v);
+    }
+    double tInsert = insertTimer.Elapsed();
+    Timer findTimer;
+    int found = 0;
+    for (int k : keys)
+        found += avltree_find(tree, &k) != nullptr;
+    double tFind = findTimer.Elapsed();
+    Timer walkTimer;
+    avltree_walk(tree, SumValue, false);
+    double tWalk = walkTimer.Elapsed();
+    Timer removeTimer;
+    for (int k : keys)
+        avltree_delete(tree, &k, false);
+    double tRemove = removeTimer.Elapsed();
+    avltree_destroy(tree, false);
+    fprintf(stderr, "%-18s insert %8.2f  find %8.2f  walk %8.2f  remove %8.2f ms (%d found)\n", name, tInsert, tFind, tWalk, tRemove, found);
+}
+
+//-----------------------------------------------------------------------------
+
+static void BenchmarkCppTree(const std::vector<int>& keys)
+{
+    AVLTree<int, int> tree;
+    tree.SetComparator(CompareKeys);
+    Timer insertTimer;
+    for (int k : keys)
+        tree.Insert(k, k);
+    double tInsert = insertTimer.Elapsed();
+    Timer findTimer;
+    int found = 0;
+    for (int k : keys)
+        found += tree.Find(k) != nullptr;
+    double tFind = findTimer.Elapsed();
+    Timer walkTimer;
+    tree.Walk(SumKey);
+    double tWalk = walkTimer.Elapsed();
+    Timer removeTimer;
+    for (int k : keys)
+        tree.Remove(k);
+    double tRemove = removeTimer.Elapsed();
+    fprintf(stderr, "%-18s insert %8.2f  find %8.2f  walk %8.2f  remove %8.2f ms (%d found)\n", "C++ AVLTree", tInsert, tFind, tWalk, tRemove, found);
+}
+
+// =================================================================================================
+
+int main(int argc, char** argv)
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+    std::vector<int> keys(n);
+    for (int i = 0; i < n; i++)
+        keys[i] = i;
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(12345));
+    fprintf(stderr, "%d random int keys\n", n);
+    BenchmarkCTree("C malloc", keys, 0, false);
+    BenchmarkCTree("C pooled", keys, 4096, false);
+    BenchmarkCTree("C pooled, bulk", keys, 4096, true);
+    BenchmarkCppTree(keys);
+    return 0;
+}
+
+// =================================================================================================
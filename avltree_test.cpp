@@ -0,0 +1,348 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Checks AVLTree against std::map and std::set: order statistics (Select, Rank, CountRange), bounds,
+// ranges and iteration in both directions, FindData with and without the data index, ParallelWalk,
+// Split, Join, the set operations, copies and operator+=, and lookups of String keys by const char*.
+// Returns 0 if all checks pass. Build e.g. with:
+//   c++ -O2 -std=c++20 -pthread avltree_test.cpp string.cpp
+
+#include <map>
+#include <set>
+#include <atomic>
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+
+#include "avltree.hpp"
+#include "string.hpp"
+
+// =================================================================================================
+
+using Tree = AVLTree<int, int>;
+
+static int failures = 0;
+
+static bool Check(bool condition, const char* what) {
+    if (not condition) {
+        fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+    return condition;
+}
+
+//-----------------------------------------------------------------------------
+
+static int CompareInts(void* /*context*/, const int& a, const int& b) {
+    return (a < b) ? -1 : (a > b) ? 1 : 0;
+}
+
+static inline int DataOf(int key) {
+    return key * 7 + 1;
+}
+
+static void Fill(Tree& tree, const std::set<int>& keys) {
+    tree.SetComparator(CompareInts);
+    for (int key : keys)
+        tree.Insert(key, DataOf(key));
+}
+
+//-----------------------------------------------------------------------------
+
+static bool Matches(Tree& tree, const std::map<int, int>& m) {
+    if (tree.Size() != int(m.size()))
+        return false;
+    auto it = m.begin();
+    for (auto [key, data] : tree) {
+        if ((key != it->first) or (data != it->second))
+            return false;
+        ++it;
+    }
+    return true;
+}
+
+static bool Matches(Tree& tree, const std::set<int>& keys) {
+    std::map<int, int> m;
+    for (int key : keys)
+        m[key] = DataOf(key);
+    return Matches(tree, m);
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestOrderStatistics(int n)
+{
+    std::mt19937 rng(1);
+    Tree tree;
+    tree.SetComparator(CompareInts);
+    std::map<int, int> m;
+    for (int step = 0; step < n; step++) {
+        int key = int(rng() % (n / 2));
+        if (rng() % 3) {
+            tree.Insert(key, key + step, true);
+            m[key] = key + step;
+        }
+        else {
+            Check(tree.Remove(key) == (m.erase(key) > 0), "Remove");
+        }
+        if (step % 97)
+            continue;
+        int k = m.empty() ? 0 : int(rng() % m.size());
+        auto kth = std::next(m.begin(), k);
+        if (not m.empty() and not Check((*tree.SelectKey(k) == kth->first) and (*tree.Select(k) == kth->second), "Select"))
+            return;
+        int lo = int(rng() % (n / 2)), hi = int(rng() % (n / 2));
+        int rank = int(std::distance(m.begin(), m.lower_bound(lo)));
+        int count = (lo < hi) ? int(std::distance(m.lower_bound(lo), m.lower_bound(hi))) : 0;
+        if (not Check((tree.Rank(lo) == rank) and (tree.CountRange(lo, hi) == count), "Rank and CountRange"))
+            return;
+    }
+    Check(Matches(tree, m), "random inserts and removals");
+    Check((tree.Select(-1) == nullptr) and (tree.Select(tree.Size()) == nullptr), "Select out of range");
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestIterators(void)
+{
+    std::set<int> keys;
+    for (int i = 0; i < 1000; i++)
+        keys.insert(i * 3);
+    Tree tree;
+    Fill(tree, keys);
+
+    bool boundsOk = true;
+    for (int key = -2; key < 3005; key += 1) {
+        auto lower = keys.lower_bound(key), upper = keys.upper_bound(key);
+        auto treeLower = tree.LowerBound(key), treeUpper = tree.UpperBound(key);
+        boundsOk = boundsOk and ((lower == keys.end()) ? not treeLower : (treeLower and (treeLower.Key() == *lower)));
+        boundsOk = boundsOk and ((upper == keys.end()) ? not treeUpper : (treeUpper and (treeUpper.Key() == *upper)));
+    }
+    Check(boundsOk, "LowerBound and UpperBound");
+
+    int count = 0;
+    bool rangeOk = true;
+    for (auto [key, data] : tree.Range(100, 200)) {
+        rangeOk = rangeOk and (key >= 100) and (key < 200) and (data == DataOf(key));
+        count++;
+    }
+    Check(rangeOk and (count == tree.CountRange(100, 200)) and (count == 33), "Range");
+    Check(tree.Range(200, 100).begin() == tree.Range(200, 100).end(), "empty Range");
+    auto equal = tree.EqualRange(300);
+    Check(equal.begin() and (equal.begin().Key() == 300) and (++equal.begin() == equal.end()), "EqualRange");
+
+    auto it = tree.end();
+    bool backwardsOk = true;
+    for (auto key = keys.rbegin(); key != keys.rend(); ++key) {
+        --it;
+        backwardsOk = backwardsOk and it and (it.Key() == *key);
+    }
+    Check(backwardsOk and not --it, "backward iteration from end()");
+    it = tree.LowerBound(1500);
+    it++;
+    it--;
+    --it;
+    Check(it and (it.Key() == 1497) and ((*it).second == DataOf(1497)), "stepping both ways");
+}
+
+//-----------------------------------------------------------------------------
+
+static int CompareData(void* /*context*/, const int& a, const int& b) {
+    return (a < b) ? -1 : (a > b) ? 1 : 0;
+}
+
+static void TestFindData(void)
+{
+    std::set<int> keys;
+    for (int i = 0; i < 500; i++)
+        keys.insert(i * 5);
+    Tree tree;
+    Fill(tree, keys);
+    for (bool indexed : { false, true }) {
+        if (indexed)
+            tree.EnableDataIndex(CompareData);
+        auto node = tree.FindData(DataOf(35));
+        Check(node and (node->key == 35), indexed ? "FindData with index" : "FindData");
+        Check(not tree.FindData(DataOf(36)), indexed ? "FindData of missing data with index" : "FindData of missing data");
+        tree.Insert(35, 4242, true);
+        node = tree.FindData(4242);
+        Check(node and (node->key == 35) and not tree.FindData(DataOf(35)), indexed ? "FindData after update with index" : "FindData after update");
+        tree.Remove(35);
+        Check(not tree.FindData(4242), indexed ? "FindData after Remove with index" : "FindData after Remove");
+        tree.Insert(35, DataOf(35));
+    }
+    Check(tree.HasDataIndex(), "HasDataIndex");
+    tree.DisableDataIndex();
+}
+
+//-----------------------------------------------------------------------------
+
+static bool AddKey(void* context, const int& key, const int& /*data*/) {
+    static_cast<std::atomic<long long>*>(context)->fetch_add(key);
+    return true;
+}
+
+static bool StopAtKey(void* context, const int& key, const int& /*data*/) {
+    return key != *static_cast<int*>(context);
+}
+
+static bool SumChunk(void* /*context*/, const int& key, const int& data, long long& sum) {
+    sum += key + data;
+    return true;
+}
+
+static void TestParallelWalk(int n)
+{
+    std::set<int> keys;
+    for (int i = 0; i < n; i++)
+        keys.insert(i);
+    Tree tree;
+    Fill(tree, keys);
+    long long expected = (long long)n * (n - 1) / 2;
+    for (int threadCount : { 1, 2, 4, 64 }) {
+        std::atomic<long long> sum(0);
+        Check(tree.ParallelWalk(AddKey, &sum, threadCount) and (sum == expected), "ParallelWalk");
+        int stopKey = n / 3;
+        Check(not tree.ParallelWalk(StopAtKey, &stopKey, threadCount), "ParallelWalk stops when asked to");
+        std::vector<long long> results;
+        long long total = 0;
+        Check(tree.ParallelWalk(SumChunk, results, nullptr, threadCount) and not results.empty(), "ParallelWalk with results");
+        for (long long r : results)
+            total += r;
+        Check(total == expected + 7 * expected + n, "ParallelWalk results");
+    }
+    Tree empty;
+    empty.SetComparator(CompareInts);
+    std::atomic<long long> sum(0);
+    Check(empty.ParallelWalk(AddKey, &sum, 4) and (sum == 0), "ParallelWalk of an empty tree");
+}
+
+//-----------------------------------------------------------------------------
+
+static std::set<int> RandomKeys(std::mt19937& rng, int n, int range) {
+    std::set<int> keys;
+    while (int(keys.size()) < n)
+        keys.insert(int(rng() % range));
+    return keys;
+}
+
+static void TestSetOperations(void)
+{
+    std::mt19937 rng(2);
+    for (int round = 0; round < 50; round++) {
+        int n1 = int(rng() % 500), n2 = int(rng() % 500), range = 1 + int(rng() % 1500);
+        std::set<int> k1 = RandomKeys(rng, std::min(n1, range), range), k2 = RandomKeys(rng, std::min(n2, range), range);
+        int threadCount = (round % 2) ? 4 : 1;
+
+        std::set<int> expected;
+        Tree a, b;
+        Fill(a, k1);
+        Fill(b, k2);
+        std::set_union(k1.begin(), k1.end(), k2.begin(), k2.end(), std::inserter(expected, expected.end()));
+        a.Union(b, threadCount);
+        Check(Matches(a, expected) and (b.Size() == 0), "Union");
+
+        expected.clear();
+        Tree c, d;
+        Fill(c, k1);
+        Fill(d, k2);
+        std::set_intersection(k1.begin(), k1.end(), k2.begin(), k2.end(), std::inserter(expected, expected.end()));
+        c.Intersection(d, threadCount);
+        Check(Matches(c, expected) and Matches(d, k2), "Intersection");
+
+        expected.clear();
+        Tree e, f;
+        Fill(e, k1);
+        Fill(f, k2);
+        std::set_difference(k1.begin(), k1.end(), k2.begin(), k2.end(), std::inserter(expected, expected.end()));
+        e.Difference(f, threadCount);
+        Check(Matches(e, expected) and Matches(f, k2), "Difference");
+
+        int key = int(rng() % (range + 2)) - 1;
+        Tree left, right;
+        Fill(left, k1);
+        right.SetComparator(CompareInts);
+        left.Split(key, right);
+        Check(Matches(left, std::set<int>(k1.begin(), k1.lower_bound(key))) and Matches(right, std::set<int>(k1.lower_bound(key), k1.end())), "Split");
+        Check((left.Size() == 0) or (right.Size() == 0) or not right.Join(left), "Join rejects overlapping keys");
+        Check(left.Join(right) and Matches(left, k1) and (right.Size() == 0), "Join");
+        if (not k1.count(key) and (k1.lower_bound(key) != k1.end()) and (k1.lower_bound(key) != k1.begin())) {
+            left.Split(key, right);
+            Check(left.Join(key, DataOf(key), right), "Join with a middle entry");
+            std::set<int> joined(k1);
+            joined.insert(key);
+            Check(Matches(left, joined), "Join with a middle entry");
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestCopies(void)
+{
+    std::set<int> k1, k2;
+    for (int i = 0; i < 300; i += 2)
+        k1.insert(i);
+    for (int i = 0; i < 300; i += 3)
+        k2.insert(i);
+    Tree a, b;
+    Fill(a, k1);
+    b.SetComparator(CompareInts);
+    for (int key : k2)
+        b.Insert(key, -key);
+    const Tree& other = b;
+    a += other;
+    std::map<int, int> expected;
+    for (int key : k2)
+        expected[key] = -key;
+    for (int key : k1)
+        expected[key] = DataOf(key); // entries in both trees keep the data of a
+    Check(Matches(a, expected) and (b.Size() == int(k2.size())), "operator+= merges copies");
+    Tree c(a), d;
+    d = a;
+    d = d;
+    Check(Matches(c, expected) and Matches(d, expected), "copy constructor and operator=");
+    c.Insert(1, 1, true);
+    Check(Matches(a, expected), "copies are independent");
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestStringLookup(void)
+{
+    AVLTree<String, int> tree;
+    tree.SetComparator(String::Compare);
+    const char* names[] = { "delta", "alpha", "echo", "charlie", "bravo" };
+    for (int i = 0; i < 5; i++)
+        tree.Insert(String(names[i]), i);
+    int* data = tree.Find("charlie");
+    Check(data and (*data == 3), "Find by const char*");
+    char name[] = "echo";
+    Check(tree.Find(name) and not tree.Find("foxtrot"), "Find by char array");
+    int extracted = -1;
+    Check(tree.Extract("alpha", extracted) and (extracted == 1) and not tree.Find("alpha"), "Extract by const char*");
+    Check(tree.Remove("bravo") and not tree.Remove("bravo") and (tree.Size() == 3), "Remove by const char*");
+}
+
+// =================================================================================================
+
+int main(int argc, char** argv)
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 100000;
+    TestOrderStatistics(n);
+    TestIterators();
+    TestFindData();
+    TestParallelWalk(n);
+    TestSetOperations();
+    TestCopies();
+    TestStringLookup();
+    fprintf(stderr, "%s\n", failures ? "avltree_test failed" : "avltree_test passed");
+    return failures ? 1 : 0;
+}
+
+// =================================================================================================
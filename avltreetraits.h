@@ -1,8 +1,27 @@
 #pragma once
 
+#include <type_traits>
+
+// true if KEY_T has a static member int Compare(void*, const LOOKUP_T&, const KEY_T&) with exactly these parameters
+template <typename KEY_T, typename LOOKUP_T, typename = void>
+struct HasLookupCompare : std::false_type {};
+
+template <typename KEY_T, typename LOOKUP_T>
+struct HasLookupCompare<KEY_T, LOOKUP_T, std::void_t<decltype(static_cast<int(*)(void*, const LOOKUP_T&, const KEY_T&)>(&KEY_T::Compare))>> : std::true_type {};
+
 template <typename KEY_T, typename DATA_T>
 struct AVLTreeTraits {
     using Comparator = int(*)(void*, const KEY_T&, const KEY_T&);
 
     using DataProcessor = bool(*)(void*, const KEY_T&, const DATA_T&);
+
+    using DataComparator = int(*)(void*, const DATA_T&, const DATA_T&);
+
+    template <typename LOOKUP_T>
+    using LookupComparator = int(*)(void*, const LOOKUP_T&, const KEY_T&);
+
+    // Transparent comparison: keys can be looked up by LOOKUP_T values without converting them to KEY_T
+    // if KEY_T provides a matching Compare overload (see String).
+    template <typename LOOKUP_T>
+    static constexpr bool isTransparent = HasLookupCompare<KEY_T, LOOKUP_T>::value;
 };
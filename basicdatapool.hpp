@@ -55,7 +55,7 @@ public:
 			memset(m_itemPool, 0, capacity * sizeof(ITEM_T));
 		}
 		else {
-			for (int i = 0; i < m_capacity; i++)
+			for (int i = 0; i < capacity; i++)
 				new(m_itemPool + i) ITEM_T();
 		}
 		for (int i = 0; i < capacity; i++)
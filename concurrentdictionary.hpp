@@ -0,0 +1,427 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Dictionary for lookup heavy data shared between threads.
+// The tree is a persistent (immutable once published) avl tree. Writers never
+// modify a node that readers can see; they copy the path from the root to the
+// modified node, rebalance the copies and publish the new root with a single
+// atomic store. Readers therefore run Find and Walk without any lock on
+// whatever root they loaded.
+// Replaced nodes are reclaimed with a three epoch scheme: a reader pins the
+// global epoch for the duration of a read operation; nodes retired in epoch e
+// are only freed once the epoch has advanced to e + 2, which requires that no
+// reader pinned to epoch e or e + 1 is still active.
+// Writers serialize among themselves through a mutex.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+#include "avltreetraits.h"
+
+// =================================================================================================
+
+template <typename KEY_T, typename DATA_T>
+class ConcurrentDictionary
+{
+public:
+    using Comparator = typename AVLTreeTraits<KEY_T, DATA_T>::Comparator;
+    using DataProcessor = typename AVLTreeTraits<KEY_T, DATA_T>::DataProcessor;
+
+private:
+    class Node {
+    public:
+        KEY_T       key;
+        DATA_T      data;
+        Node*       left;
+        Node*       right;
+        int         height;
+        uint64_t    generation; // write operation that created this node
+
+        Node(const KEY_T& key, const DATA_T& data, Node* left, Node* right, uint64_t generation)
+            : key(key), data(data), left(left), right(right), generation(generation)
+        {
+            int hl = HeightOf(left), hr = HeightOf(right);
+            height = ((hl > hr) ? hl : hr) + 1;
+        }
+
+        static inline int HeightOf(const Node* node) {
+            return node ? node->height : 0;
+        }
+    };
+
+    using NodeList = std::vector<Node*>;
+
+    struct alignas(64) ReaderCount {
+        std::atomic<int>    count;
+
+        ReaderCount() : count(0) {}
+    };
+
+    // RAII epoch pin for the duration of a read operation
+    class ReadGuard {
+    private:
+        ReaderCount&    m_readers;
+
+    public:
+        explicit ReadGuard(ConcurrentDictionary& dictionary)
+            : m_readers(dictionary.Pin())
+        { }
+
+        ~ReadGuard() {
+            m_readers.count.fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+private:
+    std::atomic<Node*>      m_root;
+    std::atomic<int>        m_nodeCount;
+    std::atomic<uint64_t>   m_epoch;
+    ReaderCount             m_readers[3];
+    NodeList                m_limbo[3];    // nodes retired in epoch e are kept in m_limbo [e % 3]
+    NodeList                m_retired;     // nodes replaced by the current write operation
+    std::mutex              m_writeLock;
+    Comparator              m_compareNodes;
+    void*                   m_context;
+    uint64_t                m_generation;
+    DATA_T                  m_workingData;
+    bool                    m_isUnchanged;
+
+public:
+    ConcurrentDictionary()
+        : m_root(nullptr), m_nodeCount(0), m_epoch(0), m_compareNodes(nullptr), m_context(nullptr), m_generation(0), m_workingData(), m_isUnchanged(false)
+    { }
+
+
+    ~ConcurrentDictionary() {
+        Destroy();
+        for (auto& limbo : m_limbo)
+            FreeNodes(limbo);
+    }
+
+
+    ConcurrentDictionary(const ConcurrentDictionary&) = delete;
+    ConcurrentDictionary& operator=(const ConcurrentDictionary&) = delete;
+
+
+    // must be called before the dictionary is shared between threads
+    inline void SetComparator(Comparator compareNodes, void* context = nullptr) {
+        m_compareNodes = compareNodes;
+        m_context = context;
+    }
+
+
+    inline int Size(void) const {
+        return m_nodeCount.load(std::memory_order_relaxed);
+    }
+
+//-----------------------------------------------------------------------------
+// Readers
+
+private:
+    ReaderCount& Pin(void)
+    {
+        for (;;) {
+            uint64_t epoch = m_epoch.load();
+            ReaderCount& readers = m_readers[epoch % 3];
+            readers.count.fetch_add(1);
+            if (m_epoch.load() == epoch)
+                return readers;
+            // a writer advanced the epoch in between; register with the new one
+            readers.count.fetch_sub(1);
+        }
+    }
+
+public:
+    // Data is copied out, since the node may be reclaimed as soon as the read operation has finished.
+    bool Find(const KEY_T& key, DATA_T& data)
+    {
+        ReadGuard guard(*this);
+        for (const Node* node = m_root.load(std::memory_order_acquire); node != nullptr; ) {
+            int rel = m_compareNodes(m_context, key, node->key);
+            if (rel < 0)
+                node = node->left;
+            else if (rel > 0)
+                node = node->right;
+            else {
+                data = node->data;
+                return true;
+            }
+        }
+        return false;
+    }
+
+
+    bool Contains(const KEY_T& key)
+    {
+        ReadGuard guard(*this);
+        for (const Node* node = m_root.load(std::memory_order_acquire); node != nullptr; ) {
+            int rel = m_compareNodes(m_context, key, node->key);
+            if (rel == 0)
+                return true;
+            node = (rel < 0) ? node->left : node->right;
+        }
+        return false;
+    }
+
+//-----------------------------------------------------------------------------
+
+private:
+    bool WalkNodes(const Node* node, DataProcessor processNode, void* context)
+    {
+        if (node) {
+            if (not WalkNodes(node->left, processNode, context))
+                return false;
+            if (not processNode(context, node->key, node->data))
+                return false;
+            if (not WalkNodes(node->right, processNode, context))
+                return false;
+        }
+        return true;
+    }
+
+public:
+    // Walks a consistent snapshot of the dictionary; concurrent writes are not visible to it.
+    bool Walk(DataProcessor processNode, void* context = nullptr)
+    {
+        ReadGuard guard(*this);
+        return WalkNodes(m_root.load(std::memory_order_acquire), processNode, context);
+    }
+
+//-----------------------------------------------------------------------------
+// Path copying. Nodes created by the current write operation are private to the
+// writer until the new root is published and may be discarded right away; all
+// other nodes may be in use by readers and have to be retired.
+
+private:
+    inline Node* MakeNode(const KEY_T& key, const DATA_T& data, Node* left, Node* right) {
+        return new Node(key, data, left, right, m_generation);
+    }
+
+
+    inline void Release(Node* node) {
+        if (node->generation == m_generation)
+            delete node;
+        else
+            m_retired.push_back(node);
+    }
+
+
+    Node* Balance(const KEY_T& key, const DATA_T& data, Node* left, Node* right)
+    {
+        int hl = Node::HeightOf(left), hr = Node::HeightOf(right);
+        if (hl > hr + 1) {
+            Node* l = left;
+            Node* node;
+            if (Node::HeightOf(l->left) >= Node::HeightOf(l->right)) // single right rotation
+                node = MakeNode(l->key, l->data, l->left, MakeNode(key, data, l->right, right));
+            else { // double LR rotation
+                Node* pivot = l->right;
+                node = MakeNode(pivot->key, pivot->data, MakeNode(l->key, l->data, l->left, pivot->left), MakeNode(key, data, pivot->right, right));
+                Release(pivot);
+            }
+            Release(l);
+            return node;
+        }
+        if (hr > hl + 1) {
+            Node* r = right;
+            Node* node;
+            if (Node::HeightOf(r->right) >= Node::HeightOf(r->left)) // single left rotation
+                node = MakeNode(r->key, r->data, MakeNode(key, data, left, r->left), r->right);
+            else { // double RL rotation
+                Node* pivot = r->left;
+                node = MakeNode(pivot->key, pivot->data, MakeNode(key, data, left, pivot->left), MakeNode(r->key, r->data, pivot->right, r->right));
+                Release(pivot);
+            }
+            Release(r);
+            return node;
+        }
+        return MakeNode(key, data, left, right);
+    }
+
+
+    Node* InsertNode(Node* node, const KEY_T& key, const DATA_T& data, bool updateData)
+    {
+        if (not node) {
+            m_nodeCount.fetch_add(1, std::memory_order_relaxed);
+            return MakeNode(key, data, nullptr, nullptr);
+        }
+        int rel = m_compareNodes(m_context, key, node->key);
+        Node* newNode;
+        if (rel == 0) {
+            if (not updateData) {
+                m_isUnchanged = true;
+                return node;
+            }
+            newNode = MakeNode(node->key, data, node->left, node->right);
+        }
+        else if (rel < 0) {
+            Node* left = InsertNode(node->left, key, data, updateData);
+            if (m_isUnchanged)
+                return node;
+            newNode = Balance(node->key, node->data, left, node->right);
+        }
+        else {
+            Node* right = InsertNode(node->right, key, data, updateData);
+            if (m_isUnchanged)
+                return node;
+            newNode = Balance(node->key, node->data, node->left, right);
+        }
+        Release(node);
+        return newNode;
+    }
+
+
+    Node* RemoveMinNode(Node* node, KEY_T& key, DATA_T& data)
+    {
+        Node* newNode;
+        if (not node->left) {
+            key = node->key;
+            data = node->data;
+            newNode = node->right;
+        }
+        else
+            newNode = Balance(node->key, node->data, RemoveMinNode(node->left, key, data), node->right);
+        Release(node);
+        return newNode;
+    }
+
+
+    Node* RemoveNode(Node* node, const KEY_T& key)
+    {
+        if (not node) {
+            m_isUnchanged = true;
+            return nullptr;
+        }
+        int rel = m_compareNodes(m_context, key, node->key);
+        Node* newNode;
+        if (rel < 0) {
+            Node* left = RemoveNode(node->left, key);
+            if (m_isUnchanged)
+                return node;
+            newNode = Balance(node->key, node->data, left, node->right);
+        }
+        else if (rel > 0) {
+            Node* right = RemoveNode(node->right, key);
+            if (m_isUnchanged)
+                return node;
+            newNode = Balance(node->key, node->data, node->left, right);
+        }
+        else {
+            m_workingData = node->data;
+            m_nodeCount.fetch_sub(1, std::memory_order_relaxed);
+            if (not node->left)
+                newNode = node->right;
+            else if (not node->right)
+                newNode = node->left;
+            else {
+                KEY_T minKey;
+                DATA_T minData;
+                Node* right = RemoveMinNode(node->right, minKey, minData);
+                newNode = Balance(minKey, minData, node->left, right);
+            }
+        }
+        Release(node);
+        return newNode;
+    }
+
+//-----------------------------------------------------------------------------
+// Epoch based reclamation, only ever called by the writer holding m_writeLock.
+
+private:
+    void FreeNodes(NodeList& nodes)
+    {
+        for (Node* node : nodes)
+            delete node;
+        nodes.clear();
+    }
+
+
+    void Publish(Node* root)
+    {
+        m_root.store(root, std::memory_order_release);
+        uint64_t epoch = m_epoch.load();
+        NodeList& limbo = m_limbo[epoch % 3];
+        limbo.insert(limbo.end(), m_retired.begin(), m_retired.end());
+        m_retired.clear();
+        // the epoch may only advance once the readers of the previous epoch are gone;
+        // after that, nobody can still hold a node retired two epochs ago
+        if (m_readers[(epoch + 2) % 3].count.load() == 0) {
+            m_epoch.store(epoch + 1);
+            FreeNodes(m_limbo[(epoch + 2) % 3]);
+        }
+    }
+
+
+    inline void BeginWrite(void) {
+        ++m_generation;
+        m_isUnchanged = false;
+    }
+
+//-----------------------------------------------------------------------------
+// Writers
+
+public:
+    bool Insert(const KEY_T& key, const DATA_T& data, bool updateData = false)
+    {
+        std::lock_guard<std::mutex> lock(m_writeLock);
+        BeginWrite();
+        Node* root = InsertNode(m_root.load(std::memory_order_relaxed), key, data, updateData);
+        if (not m_isUnchanged)
+            Publish(root);
+        return not m_isUnchanged;
+    }
+
+
+    bool Remove(const KEY_T& key)
+    {
+        std::lock_guard<std::mutex> lock(m_writeLock);
+        BeginWrite();
+        Node* root = RemoveNode(m_root.load(std::memory_order_relaxed), key);
+        if (not m_isUnchanged)
+            Publish(root);
+        return not m_isUnchanged;
+    }
+
+
+    bool Extract(const KEY_T& key, DATA_T& data)
+    {
+        std::lock_guard<std::mutex> lock(m_writeLock);
+        BeginWrite();
+        Node* root = RemoveNode(m_root.load(std::memory_order_relaxed), key);
+        if (m_isUnchanged)
+            return false;
+        data = std::move(m_workingData);
+        Publish(root);
+        return true;
+    }
+
+//-----------------------------------------------------------------------------
+
+private:
+    void RetireNodes(Node* node)
+    {
+        if (node) {
+            RetireNodes(node->left);
+            RetireNodes(node->right);
+            m_retired.push_back(node);
+        }
+    }
+
+public:
+    void Destroy(void)
+    {
+        std::lock_guard<std::mutex> lock(m_writeLock);
+        BeginWrite();
+        RetireNodes(m_root.load(std::memory_order_relaxed));
+        m_nodeCount.store(0, std::memory_order_relaxed);
+        Publish(nullptr);
+    }
+};
+
+// =================================================================================================
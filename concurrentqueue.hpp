@@ -0,0 +1,316 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Queues for handing work between threads without a lock shared by producers and consumers.
+// ConcurrentQueue is a Michael-Scott queue for any number of producers and consumers. Its nodes
+// come from a ConcurrentNodePool and are addressed by 32 bit indices, so head, tail, node links
+// and the pool's free list can carry a 32 bit tag in the same 64 bit atomic, which protects
+// every compare-and-swap from ABA. Node memory is only freed when the queue is destroyed, so a
+// thread may safely read the link of a node another thread has just recycled; the tags make it
+// discard what it read.
+// IntrusiveMPSCQueue is Dmitry Vyukov's intrusive queue for many producers and a single consumer:
+// producers link the item's hook with a single atomic exchange, and nothing is allocated at all.
+
+#pragma once
+
+#include <new>
+#include <bit>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+#include "intrusivehook.hpp"
+
+// =================================================================================================
+// Lock free pool of nodes with the indices 1 .. capacity (0 is the null index). NODE_T must provide
+// std::atomic<uint32_t> m_freeNext. Blocks double in size; only adding a block takes a lock.
+
+template <typename NODE_T>
+class ConcurrentNodePool {
+	static constexpr int firstBlockBits = 6;
+	static constexpr int maxBlocks = 26; // 64 * (2^26 - 1) nodes
+
+	std::atomic<NODE_T*>	m_blocks[maxBlocks];
+	std::atomic<uint64_t>	m_freeNodes; // tag << 32 | index
+	int						m_blockCount;
+	std::mutex				m_growLock;
+
+	static inline uint32_t Index(uint64_t tagged) {
+		return uint32_t(tagged);
+	}
+
+	static inline uint64_t Tagged(uint32_t index, uint64_t oldTagged) {
+		return ((oldTagged >> 32) + 1) << 32 | index;
+	}
+
+	// chain the nodes first .. last (linked through m_freeNext) into the free list
+	void Push(uint32_t first, uint32_t last) {
+		uint64_t top = m_freeNodes.load(std::memory_order_relaxed);
+		do {
+			Node(last)->m_freeNext.store(Index(top), std::memory_order_relaxed);
+		} while (not m_freeNodes.compare_exchange_weak(top, Tagged(first, top), std::memory_order_release, std::memory_order_relaxed));
+	}
+
+
+	uint32_t Grow(void) {
+		std::lock_guard<std::mutex> lock(m_growLock);
+		if (Index(m_freeNodes.load(std::memory_order_acquire)))
+			return 0; // another thread has grown the pool meanwhile
+		if (m_blockCount == maxBlocks)
+			return 0;
+		uint32_t blockSize = uint32_t(1) << (firstBlockBits + m_blockCount);
+		NODE_T* block = new (std::nothrow) NODE_T[blockSize];
+		if (not block)
+			return 0;
+		uint32_t first = ((uint32_t(1) << m_blockCount) - 1) << firstBlockBits; // global index of block[0] minus one
+		m_blocks[m_blockCount++].store(block, std::memory_order_release);
+		for (uint32_t i = 1; i < blockSize; i++)
+			block[i].m_freeNext.store(first + i + 2, std::memory_order_relaxed);
+		if (blockSize > 1)
+			Push(first + 2, first + blockSize);
+		return first + 1;
+	}
+
+public:
+	ConcurrentNodePool()
+		: m_freeNodes(0), m_blockCount(0)
+	{
+		for (auto& b : m_blocks)
+			b.store(nullptr, std::memory_order_relaxed);
+	}
+
+
+	~ConcurrentNodePool() {
+		for (int i = 0; i < m_blockCount; i++)
+			delete[] m_blocks[i].load(std::memory_order_relaxed);
+	}
+
+
+	ConcurrentNodePool(const ConcurrentNodePool&) = delete;
+	ConcurrentNodePool& operator=(const ConcurrentNodePool&) = delete;
+
+
+	inline NODE_T* Node(uint32_t index) const {
+		uint32_t i = (index - 1) >> firstBlockBits;
+		int block = std::bit_width(i + 1) - 1;
+		return m_blocks[block].load(std::memory_order_acquire) + ((index - 1) - (((uint32_t(1) << block) - 1) << firstBlockBits));
+	}
+
+
+	// returns 0 if no memory is left
+	uint32_t Claim(void) {
+		for (;;) {
+			uint64_t top = m_freeNodes.load(std::memory_order_acquire);
+			while (Index(top)) {
+				uint32_t next = Node(Index(top))->m_freeNext.load(std::memory_order_relaxed);
+				if (m_freeNodes.compare_exchange_weak(top, Tagged(next, top), std::memory_order_acquire, std::memory_order_acquire))
+					return Index(top);
+			}
+			uint32_t index = Grow();
+			if (index)
+				return index;
+			if (not Index(m_freeNodes.load(std::memory_order_acquire)))
+				return 0;
+		}
+	}
+
+
+	inline void Release(uint32_t index) {
+		Push(index, index);
+	}
+};
+
+// =================================================================================================
+// Multi producer, multi consumer queue. Push and Pop are lock free once the pool holds enough nodes.
+
+template <typename DATA_T>
+class ConcurrentQueue {
+	struct Node {
+		std::atomic<uint64_t>	m_next;		// tag << 32 | index of the successor
+		std::atomic<uint32_t>	m_freeNext;	// pool link
+		std::atomic<int>		m_refs;		// the node is recycled once it has been unlinked and its data has been taken
+		alignas(DATA_T) unsigned char m_data[sizeof(DATA_T)];
+
+		Node() : m_next(0), m_freeNext(0), m_refs(0) {}
+
+		inline DATA_T* Data(void) {
+			return std::launder(reinterpret_cast<DATA_T*>(m_data));
+		}
+	};
+
+	ConcurrentNodePool<Node>			m_pool;
+	alignas(64) std::atomic<uint64_t>	m_head;	// the head node is a dummy; the data is in its successors
+	alignas(64) std::atomic<uint64_t>	m_tail;
+
+	static inline uint32_t Index(uint64_t tagged) {
+		return uint32_t(tagged);
+	}
+
+	static inline uint64_t Tagged(uint32_t index, uint64_t oldTagged) {
+		return ((oldTagged >> 32) + 1) << 32 | index;
+	}
+
+	inline void ReleaseNode(uint32_t index) {
+		if (m_pool.Node(index)->m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			m_pool.Release(index);
+	}
+
+public:
+	ConcurrentQueue() {
+		uint32_t dummy = m_pool.Claim();
+		m_pool.Node(dummy)->m_refs.store(1, std::memory_order_relaxed);
+		m_head.store(dummy, std::memory_order_relaxed);
+		m_tail.store(dummy, std::memory_order_relaxed);
+	}
+
+
+	// must not run concurrently with any other operation
+	~ConcurrentQueue() {
+		DATA_T data;
+		while (Pop(data))
+			;
+	}
+
+
+	ConcurrentQueue(const ConcurrentQueue&) = delete;
+	ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+
+	template <typename T>
+	bool Push(T&& data) {
+		uint32_t index = m_pool.Claim();
+		if (not index)
+			return false;
+		Node* node = m_pool.Node(index);
+		new (node->m_data) DATA_T(std::forward<T>(data));
+		node->m_refs.store(2, std::memory_order_relaxed);
+		uint64_t next = node->m_next.load(std::memory_order_relaxed);
+		node->m_next.store(Tagged(0, next), std::memory_order_relaxed);
+		for (;;) {
+			uint64_t tail = m_tail.load(std::memory_order_acquire);
+			next = m_pool.Node(Index(tail))->m_next.load(std::memory_order_acquire);
+			if (tail != m_tail.load(std::memory_order_acquire))
+				continue;
+			if (Index(next)) // tail is lagging behind; help moving it
+				m_tail.compare_exchange_weak(tail, Tagged(Index(next), tail), std::memory_order_release, std::memory_order_relaxed);
+			else if (m_pool.Node(Index(tail))->m_next.compare_exchange_weak(next, Tagged(index, next), std::memory_order_release, std::memory_order_relaxed)) {
+				m_tail.compare_exchange_strong(tail, Tagged(index, tail), std::memory_order_release, std::memory_order_relaxed);
+				return true;
+			}
+		}
+	}
+
+
+	// returns false if the queue is empty
+	bool Pop(DATA_T& data) {
+		for (;;) {
+			uint64_t head = m_head.load(std::memory_order_acquire);
+			uint64_t tail = m_tail.load(std::memory_order_acquire);
+			uint64_t next = m_pool.Node(Index(head))->m_next.load(std::memory_order_acquire);
+			if (head != m_head.load(std::memory_order_acquire))
+				continue;
+			if (Index(head) == Index(tail)) {
+				if (not Index(next))
+					return false;
+				m_tail.compare_exchange_weak(tail, Tagged(Index(next), tail), std::memory_order_release, std::memory_order_relaxed);
+			}
+			else if (m_head.compare_exchange_weak(head, Tagged(Index(next), head), std::memory_order_acq_rel, std::memory_order_relaxed)) {
+				// the successor is the new dummy; it can't be recycled before its data has been taken here
+				DATA_T* p = m_pool.Node(Index(next))->Data();
+				data = std::move(*p);
+				p->~DATA_T();
+				ReleaseNode(Index(next));
+				ReleaseNode(Index(head));
+				return true;
+			}
+		}
+	}
+
+
+	// a snapshot that may be outdated as soon as it is returned
+	inline bool IsEmpty(void) const {
+		uint64_t head = m_head.load(std::memory_order_acquire);
+		return not Index(m_pool.Node(Index(head))->m_next.load(std::memory_order_acquire));
+	}
+};
+
+// =================================================================================================
+// Multi producer, single consumer intrusive queue. Items embed an MPSCQueueHook, whose offset in the
+// item is the second template argument (see intrusivehook.hpp), e.g.
+//   IntrusiveMPSCQueue<Task, offsetof(Task, m_queueHook)> tasks;
+// An item must not be pushed again before it has been popped.
+
+struct MPSCQueueHook {
+	std::atomic<MPSCQueueHook*>	m_next;
+
+	MPSCQueueHook() : m_next(nullptr) {}
+};
+
+
+template <typename ITEM_T, size_t HOOK_OFFSET>
+class IntrusiveMPSCQueue {
+	alignas(64) std::atomic<MPSCQueueHook*>	m_head;	// last pushed hook (producers)
+	alignas(64) MPSCQueueHook*				m_tail;	// next hook to pop (consumer)
+	MPSCQueueHook							m_stub;
+
+	using Hooks = IntrusiveHook<ITEM_T, MPSCQueueHook, HOOK_OFFSET>;
+
+	inline void PushHook(MPSCQueueHook* hook) {
+		hook->m_next.store(nullptr, std::memory_order_relaxed);
+		MPSCQueueHook* prev = m_head.exchange(hook, std::memory_order_acq_rel);
+		prev->m_next.store(hook, std::memory_order_release);
+	}
+
+public:
+	IntrusiveMPSCQueue()
+		: m_head(&m_stub), m_tail(&m_stub)
+	{
+	}
+
+
+	IntrusiveMPSCQueue(const IntrusiveMPSCQueue&) = delete;
+	IntrusiveMPSCQueue& operator=(const IntrusiveMPSCQueue&) = delete;
+
+
+	// wait free; may be called from any thread
+	inline void Push(ITEM_T* item) {
+		PushHook(Hooks::Hook(item));
+	}
+
+
+	// consumer thread only. Returns nullptr if the queue is empty, but also if a producer
+	// is just in the middle of pushing the only remaining item.
+	ITEM_T* Pop(void) {
+		MPSCQueueHook* tail = m_tail;
+		MPSCQueueHook* next = tail->m_next.load(std::memory_order_acquire);
+		if (tail == &m_stub) {
+			if (not next)
+				return nullptr;
+			m_tail = tail = next;
+			next = next->m_next.load(std::memory_order_acquire);
+		}
+		if (next) {
+			m_tail = next;
+			return Hooks::Item(tail);
+		}
+		if (tail != m_head.load(std::memory_order_acquire))
+			return nullptr;
+		PushHook(&m_stub);
+		next = tail->m_next.load(std::memory_order_acquire);
+		if (not next)
+			return nullptr;
+		m_tail = next;
+		return Hooks::Item(tail);
+	}
+
+
+	// consumer thread only
+	inline bool IsEmpty(void) const {
+		return (m_tail == &m_stub) and not m_stub.m_next.load(std::memory_order_acquire);
+	}
+};
+
+// =================================================================================================
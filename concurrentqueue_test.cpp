@@ -0,0 +1,151 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Checks the queues in concurrentqueue.hpp with several producer and consumer threads: every item
+// arrives exactly once, items of one producer arrive in the order they were pushed, and queues
+// that are destroyed while holding items release them. Returns 0 if all checks pass.
+// Build e.g. with:
+//   c++ -O2 -std=c++20 -pthread concurrentqueue_test.cpp
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+
+#include "concurrentqueue.hpp"
+
+// =================================================================================================
+
+static int failures = 0;
+
+static void Check(bool condition, const char* what) {
+    if (not condition) {
+        fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestMPMC(int producerCount, int consumerCount, int n)
+{
+    ConcurrentQueue<std::string> queue;
+    int total = producerCount * n;
+    std::unique_ptr<std::atomic<int>[]> received(new std::atomic<int>[total]());
+    std::atomic<int> receivedCount(0);
+    std::atomic<bool> inOrder(true);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producerCount; p++)
+        threads.emplace_back([&queue, p, n]() {
+            for (int i = 0; i < n; i++)
+                while (not queue.Push(std::to_string(p * n + i)))
+                    std::this_thread::yield();
+        });
+    for (int c = 0; c < consumerCount; c++)
+        threads.emplace_back([&, producerCount, n]() {
+            std::vector<int> last(producerCount, -1); // last item seen from each producer
+            std::string s;
+            while (receivedCount.load() < total) {
+                if (not queue.Pop(s)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                int v = atoi(s.c_str());
+                if (v <= last[v / n])
+                    inOrder = false;
+                last[v / n] = v;
+                received[v]++;
+                receivedCount++;
+            }
+        });
+    for (auto& t : threads)
+        t.join();
+
+    bool once = true;
+    for (int i = 0; i < total; i++)
+        if (received[i] != 1)
+            once = false;
+    Check(once, "MPMC queue delivers every item exactly once");
+    Check(inOrder, "MPMC queue keeps the order of each producer's items");
+    Check(queue.IsEmpty(), "MPMC queue is empty at the end");
+    std::string s;
+    Check(not queue.Pop(s), "Pop fails on an empty MPMC queue");
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestMPMCDestroy(void)
+{
+    ConcurrentQueue<std::string> queue;
+    for (int i = 0; i < 1000; i++)
+        queue.Push(std::string(100, char('a' + i % 26))); // released by the destructor
+    std::string s;
+    Check(queue.Pop(s) and (s == std::string(100, 'a')), "MPMC queue pops in push order");
+}
+
+//-----------------------------------------------------------------------------
+
+struct Job {
+    int             m_producer;
+    int             m_sequence;
+    MPSCQueueHook   m_hook; // not the first member, so the hook offset matters
+};
+
+static void TestMPSC(int producerCount, int n)
+{
+    IntrusiveMPSCQueue<Job, offsetof(Job, m_hook)> queue;
+    std::vector<Job> jobs(producerCount * n);
+    Check(queue.IsEmpty() and not queue.Pop(), "new MPSC queue is empty");
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producerCount; p++)
+        threads.emplace_back([&queue, &jobs, p, n]() {
+            for (int i = 0; i < n; i++) {
+                Job& job = jobs[p * n + i];
+                job.m_producer = p;
+                job.m_sequence = i;
+                queue.Push(&job);
+            }
+        });
+    std::vector<int> last(producerCount, -1);
+    bool inOrder = true;
+    for (int received = 0; received < producerCount * n; ) {
+        Job* job = queue.Pop();
+        if (not job) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (job->m_sequence != last[job->m_producer] + 1)
+            inOrder = false;
+        last[job->m_producer] = job->m_sequence;
+        received++;
+    }
+    for (auto& t : threads)
+        t.join();
+
+    Check(inOrder, "MPSC queue delivers each producer's items once and in order");
+    Check(queue.IsEmpty() and not queue.Pop(), "MPSC queue is empty at the end");
+    queue.Push(&jobs[0]);
+    Check(queue.Pop() == &jobs[0], "MPSC queue maps the hook back to its item");
+}
+
+// =================================================================================================
+
+int main(int argc, char** argv)
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 50000;
+    TestMPMC(4, 3, n);
+    TestMPMC(1, 1, n);
+    TestMPMCDestroy();
+    TestMPSC(4, n);
+    fprintf(stderr, "%s\n", failures ? "concurrentqueue_test failed" : "concurrentqueue_test passed");
+    return failures ? 1 : 0;
+}
+
+// =================================================================================================
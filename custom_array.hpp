@@ -6,8 +6,18 @@
 
 #define NOMINMAX
 
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include <stdlib.h>
+
 #include "sharedpointer.hpp"
 #include "quicksort.hpp"
+#include "type_helper.hpp"
+#include "arraykernels.hpp"
+#include "gridlayout.hpp"
 
 #define sizeofa(_a)	((sizeof(_a) / sizeof(*(_a))))
 
@@ -15,11 +25,37 @@
 
 // =================================================================================================
 
+// A raw pointer handle points to uninitialized storage, in which ManagedArray constructs and destroys
+// the items in use. A SharedPointer handle owns an array allocated with new[], whose items all exist.
+
 template<typename DATA_T, typename POINTER_T = DATA_T*>
 class ArrayBuffer {
 protected:
 	POINTER_T	m_handle = nullptr;
 	bool		m_isStatic = false;
+	bool		m_isShareable = true;	// false: static buffer that copies must not share, e.g. a mapped file view
+
+	// storage of trivially relocatable types is allocated with malloc, so it can be grown with realloc
+	static constexpr bool useMalloc = is_trivially_relocatable_v<DATA_T> and (alignof(DATA_T) <= alignof(std::max_align_t));
+
+	static DATA_T* Allocate(int32_t capacity) {
+		size_t size = std::max(size_t(capacity), size_t(1)) * sizeof(DATA_T);
+		if constexpr (useMalloc)
+			return static_cast<DATA_T*>(malloc(size));
+		else
+			return static_cast<DATA_T*>(::operator new(size, std::align_val_t(alignof(DATA_T)), std::nothrow));
+	}
+
+	static DATA_T* Reallocate(DATA_T* data, int32_t capacity) {
+		return static_cast<DATA_T*>(realloc(data, std::max(size_t(capacity), size_t(1)) * sizeof(DATA_T)));
+	}
+
+	static void Free(DATA_T* data) {
+		if constexpr (useMalloc)
+			free(data);
+		else
+			::operator delete(static_cast<void*>(data), std::align_val_t(alignof(DATA_T)));
+	}
 
 public:
 	ArrayBuffer() = default;
@@ -45,7 +81,7 @@ public:
 		}
 	}
 
-	void SetBuffer(DATA_T* data, bool isStatic) {
+	void SetBuffer(DATA_T* data, bool isStatic, bool isShareable = true) {
 		if constexpr (std::is_pointer_v<POINTER_T>) {
 			m_handle = data;
 		}
@@ -53,6 +89,7 @@ public:
 			m_handle = POINTER_T(data, true, isStatic);
 		}
 		m_isStatic = isStatic;
+		m_isShareable = isShareable;
 	}
 
 	inline POINTER_T& BufferHandle(void) {
@@ -76,7 +113,7 @@ public:
 		if constexpr (std::is_pointer_v<POINTER_T>) {
 			if (m_handle) {
 				if (not m_isStatic)
-					delete[] m_handle;
+					Free(m_handle);
 				m_handle = nullptr;
 			}
 		}
@@ -84,6 +121,7 @@ public:
 			m_handle.Release();
 			m_isStatic = false;
 		}
+		m_isShareable = true;
 	}
 
 	inline bool IsStatic(void) const {
@@ -118,17 +156,20 @@ private:
 
 	class ArrayInfo {
 	public:
-		int32_t	capacity;
+		int32_t	length;		// items in use
+		int32_t	capacity;	// items allocated
 		int32_t	height;
 		int32_t	width;
 		int32_t	pos;
 		int32_t	offset;
+		float	growth;		// factor the capacity grows by when appending to a full array
 		bool	wrap;
+		GridLayout	grid;	// storage order of width x height grids
 
 	public:
 
 		ArrayInfo(int32_t _width = 0, int32_t _height = 0, int32_t _offset = 0)
-			: capacity(0), height(_height), width(_width), pos(0), offset(_offset), wrap(false)
+			: length(0), capacity(0), height(_height), width(_width), pos(0), offset(_offset), growth(2.0f), wrap(false)
 		{
 		}
 
@@ -141,6 +182,41 @@ protected:
 	//ArrayBuffer<DATA_T	m_handle;
 	DATA_T					m_none;
 
+	// the items of a raw buffer only exist while they are in use; see ArrayBuffer
+	static constexpr bool rawStorage = std::is_pointer_v<POINTER_T>;
+
+	static void ConstructItems(DATA_T* items, int32_t count) {
+		if constexpr (rawStorage and not std::is_trivially_default_constructible_v<DATA_T>) {
+			for (int32_t i = 0; i < count; i++)
+				new (items + i) DATA_T;
+		}
+	}
+
+	static void DestroyItems(DATA_T* items, int32_t count) {
+		if constexpr (rawStorage and not std::is_trivially_destructible_v<DATA_T>) {
+			for (int32_t i = 0; i < count; i++)
+				items[i].~DATA_T();
+		}
+	}
+
+	// copy or move count items to uninitialized (raw) or existing (shared) items
+	static void CopyItems(DATA_T* dest, DATA_T* source, int32_t count, bool move) {
+		if (count <= 0)
+			return;
+		if constexpr (std::is_trivially_copyable_v<DATA_T>)
+			memcpy(static_cast<void*>(dest), source, size_t(count) * sizeof(DATA_T));
+		else if constexpr (rawStorage) {
+			if (move)
+				std::uninitialized_move_n(source, count, dest);
+			else
+				std::uninitialized_copy_n(source, count, dest);
+		}
+		else if (move)
+			std::move(source, source + count, dest);
+		else
+			std::copy_n(source, count, dest);
+	}
+
 	// ----------------------------------------
 
 public:
@@ -201,18 +277,18 @@ public:
 		// fprintf(stderr, "%s\n", __FUNCSIG__);
 	}
 
-	explicit ManagedArray(const int32_t capacity)
+	explicit ManagedArray(const int32_t length)
 		: m_info(), m_none(DATA_T())
 	{
 		// fprintf(stderr, "%s\n", __FUNCSIG__);
-		Reserve(capacity);
+		Resize(length);
 	}
 
 	explicit ManagedArray(const int32_t width, const int32_t height)
 		: m_info(width, height), m_none(DATA_T())
 	{
 		// fprintf(stderr, "%s\n", __FUNCSIG__);
-		Reserve(width, height);
+		Resize(width, height);
 	}
 
 	ManagedArray(ManagedArray const& other)
@@ -229,19 +305,19 @@ public:
 		Move(other);
 	}
 
-	explicit ManagedArray(DATA_T const* data, int32_t capacity, int32_t offset = 0)
+	explicit ManagedArray(DATA_T const* data, int32_t length, int32_t offset = 0)
 		: m_info(0, 0, offset), m_none(DATA_T())
 	{
 		// fprintf(stderr, "%s\n", __FUNCSIG__);
-		Reserve(capacity);
-		memcpy(Data(), data, sizeof(DATA_T) * capacity);
+		if (Resize(length))
+			std::copy_n(data, length, Data());
 	}
 
 	ManagedArray(std::initializer_list<DATA_T> data)
 		: m_info(), m_none(DATA_T())
 	{
 		// fprintf(stderr, "%s\n", __FUNCSIG__);
-		Reserve(int32_t(data.size()));
+		Resize(int32_t(data.size()));
 		int32_t i = 0;
 		for (auto it = data.begin(); it != data.end(); it++)
 			*Data(i++) = *it;
@@ -267,51 +343,166 @@ public:
 			m_info.height = height;
 		if (width != -1)
 			m_info.width = width;
+		m_info.grid.Resize(m_info.width, m_info.height);
 		m_info.offset = 0;
 		m_info.pos = 0;
 		m_info.wrap = false;
 		if constexpr (std::is_trivially_constructible<DATA_T>::value)
 			memset(&m_none, 0, sizeof(m_none));
 		else
-			new(&m_none) DATA_T();
+			m_none = DATA_T();
 	}
 
 	// ----------------------------------------
 
 	void Reset(void) {
-		Base::Destroy();
-		m_info.capacity = 0;
+		Release();
 		Init(); // leave width and height intact
 	}
 
 	// ----------------------------------------
 
+	// memset the first count items, or all items in use; reserved capacity beyond the length holds no items
 	void Clear(uint8_t filler = 0, int32_t count = 0u) {
 		if (Data())
-			memset(Data(), filler, sizeof(DATA_T) * ((count && (count < m_info.capacity)) ? count : m_info.capacity));
+			memset(Data(), filler, sizeof(DATA_T) * ((count && (count < m_info.length)) ? count : m_info.length));
 	}
 
 	// ----------------------------------------
 
+	// fill the first count items, or all items in use except the padding of a tiled grid
 	void Fill(DATA_T filler, int32_t count = -1) {
 		if (Data()) {
-			if (count < 0)
-				count = m_info.capacity;
-			for (DATA_T* bufP = Data(); count; count--, bufP++)
-				*bufP = filler;
+			if (count >= 0)
+				FillItems(Data(), count, filler);
+			else
+				m_info.grid.ForEachRun(m_info.length, [&](int32_t i, int32_t n) { FillItems(Data() + i, n, filler); return true; });
 		}
 	}
 
+	// ----------------------------------------
+	// linear search, minimum/maximum and sum of the items in use, without the padding of tiled
+	// grids (see GridLayout::ForEachRun). Arrays of arithmetic items use the SIMD kernels from
+	// arraykernels.hpp.
+
+	// index of the first item equal to value, or -1
+	int32_t Find(const DATA_T& value) const {
+		int32_t found = -1;
+		if (Data())
+			m_info.grid.ForEachRun(m_info.length, [&](int32_t i, int32_t n) {
+				int32_t j = FindItem(Data() + i, n, value);
+				if (j < 0)
+					return true;
+				found = i + j;
+				return false;
+			});
+		return found;
+	}
+
+	// ----------------------------------------
+
+	// false if the array is empty
+	bool MinMax(DATA_T& minValue, DATA_T& maxValue) const {
+		bool found = false;
+		m_info.grid.ForEachRun(m_info.length, [&](int32_t i, int32_t n) {
+			DATA_T runMin, runMax;
+			if (MinMaxItems(Data() + i, n, runMin, runMax)) {
+				if (not found) {
+					minValue = runMin;
+					maxValue = runMax;
+					found = true;
+				}
+				else {
+					if (runMin < minValue)
+						minValue = runMin;
+					if (maxValue < runMax)
+						maxValue = runMax;
+				}
+			}
+			return true;
+		});
+		return found;
+	}
+
+	// ----------------------------------------
+
+	inline DATA_T Min(void) const {
+		DATA_T minValue, maxValue;
+		return MinMax(minValue, maxValue) ? minValue : m_none;
+	}
+
+	// ----------------------------------------
+
+	inline DATA_T Max(void) const {
+		DATA_T minValue, maxValue;
+		return MinMax(minValue, maxValue) ? maxValue : m_none;
+	}
+
+	// ----------------------------------------
+
+	// 64 bit sum for integers, double for float
+	inline auto Sum(void) const {
+		typename ArrayKernels<DATA_T>::SUM_T sum = 0;
+		m_info.grid.ForEachRun(m_info.length, [&](int32_t i, int32_t n) { sum += ArrayKernels<DATA_T>::Sum(Data() + i, n); return true; });
+		return sum;
+	}
+
+	// ----------------------------------------
+
+private:
+	static void FillItems(DATA_T* items, int32_t count, const DATA_T& filler) {
+		if constexpr (std::is_arithmetic_v<DATA_T>)
+			ArrayKernels<DATA_T>::Fill(items, count, filler);
+		else
+			std::fill_n(items, count, filler);
+	}
+
+
+	static int32_t FindItem(const DATA_T* items, int32_t count, const DATA_T& value) {
+		if constexpr (std::is_arithmetic_v<DATA_T>)
+			return ArrayKernels<DATA_T>::Find(items, count, value);
+		else {
+			for (int32_t i = 0; i < count; i++)
+				if (items[i] == value)
+					return i;
+			return -1;
+		}
+	}
+
+
+	static bool MinMaxItems(const DATA_T* items, int32_t count, DATA_T& minValue, DATA_T& maxValue) {
+		if constexpr (std::is_arithmetic_v<DATA_T>)
+			return ArrayKernels<DATA_T>::MinMax(items, count, minValue, maxValue);
+		else {
+			if (not count)
+				return false;
+			auto range = std::minmax_element(items, items + count);
+			minValue = *range.first;
+			maxValue = *range.second;
+			return true;
+		}
+	}
+
+
+	static bool EqualItems(const DATA_T* a, const DATA_T* b, int32_t count) {
+		if constexpr (std::is_arithmetic_v<DATA_T>)
+			return ArrayKernels<DATA_T>::Equal(a, b, count);
+		else
+			return std::equal(a, a + count, b);
+	}
+
+public:
+
 	// ----------------------------------------
 
 	inline bool IsIndex(int32_t i) {
-		return Data() && (i - m_info.offset >= 0) && (i - m_info.offset < m_info.capacity);
+		return Data() && (i - m_info.offset >= 0) && (i - m_info.offset < m_info.length);
 	}
 
 	// ----------------------------------------
 
 	inline bool IsElement(DATA_T* elem, bool bDiligent = false) {
-		if (not Data() or (elem < Data()) or (elem >= Data() + m_info.capacity))
+		if (not Data() or (elem < Data()) or (elem >= Data() + m_info.length))
 			return false;	// no data or element out of data
 		if (bDiligent) {
 			int32_t i = static_cast<int32_t>(reinterpret_cast<uint8_t*>(elem) - reinterpret_cast<uint8_t*>(Data()));
@@ -336,25 +527,32 @@ public:
 	// ----------------------------------------
 
 	void Destroy(void) {
+		Release();
+	}
+
+	// ----------------------------------------
+
+private:
+	// destroy the items in use (unless the buffer is static) and release the buffer
+	void Release(void) {
+		if (Data() and not Base::m_isStatic)
+			DestroyItems(Data(), m_info.length);
 		Base::Destroy();
+		m_info.length =
 		m_info.capacity = 0;
 	}
 
+public:
+
 	// ----------------------------------------
+	// make room for at least capacity items, keeping the items in use. Never shrinks the buffer.
+	// A static buffer is never written through Reserve, Resize or Append; they move its items
+	// to a buffer of their own.
 
 	DATA_T* Reserve(int32_t capacity, int32_t offset = 0) {
-		if (m_info.capacity != capacity) {
-			Destroy();
-#if 0
-			Base::Reserve(capacity);
-#else
-			DATA_T* data = new DATA_T[capacity];
-			if (data) {
-				Base::SetBuffer(data, false);
-				m_info.capacity = capacity;
-				Base::m_isStatic = false;
-			}
-#endif
+		if ((capacity > m_info.capacity) or Base::m_isStatic) {
+			if (not SetCapacity(std::max(capacity, m_info.length), true))
+				return nullptr;
 			m_info.offset = offset;
 		}
 		return Data();
@@ -364,8 +562,60 @@ public:
 
 	inline DATA_T* Reserve(int32_t width, int32_t height, int32_t offset = 0) {
 		Init(width, height);
-		Reserve(width * height);
-		return Data();
+		return Resize(m_info.grid.Size());
+	}
+
+	// ----------------------------------------
+
+	inline DATA_T* Resize(int32_t width, int32_t height) {
+		Init(width, height);
+		return Resize(m_info.grid.Size());
+	}
+
+	// ----------------------------------------
+	// store the width x height grid in the given order (see gridlayout.hpp), rearranging the cells
+	// it holds. The (x, y) accessors and tile iteration work the same in all orders.
+
+	bool SetLayout(GridOrder order, int32_t tileShift = GridLayout::defaultTileShift) {
+		GridLayout layout(order, tileShift);
+		layout.Resize(m_info.width, m_info.height);
+		bool holdsGrid = (m_info.width * m_info.height > 0) and (m_info.length >= m_info.grid.Size());
+		if (holdsGrid and ((layout.order != m_info.grid.order) or (layout.tileShift != m_info.grid.tileShift))) {
+			ManagedArray<DATA_T, POINTER_T> cells;
+			if (not cells.Resize(layout.Size()))
+				return false;
+			for (int32_t y = 0; y < m_info.height; y++)
+				for (int32_t x = 0; x < m_info.width; x++)
+					*cells.Data(layout.Index(x, y)) = std::move(*Data(m_info.grid.Index(x, y)));
+			ArrayInfo info = m_info;
+			Move(cells);
+			info.length = m_info.length;
+			info.capacity = m_info.capacity;
+			m_info = info;
+		}
+		m_info.grid = layout;
+		return true;
+	}
+
+	// ----------------------------------------
+
+	inline const GridLayout& Layout(void) const {
+		return m_info.grid;
+	}
+
+	// ----------------------------------------
+
+	inline GridTiles Tiles(void) const {
+		return GridTiles(m_info.grid);
+	}
+
+	// ----------------------------------------
+
+	// the cells [tile.x0, tile.x1) of row y, which are contiguous unless the grid has Morton order
+	// (nullptr then)
+	inline DATA_T* TileRow(const GridTile& tile, int32_t y) {
+		int32_t i = m_info.grid.RowIndex(tile, y);
+		return (i < 0) ? nullptr : Data(i);
 	}
 
 	// ----------------------------------------
@@ -390,13 +640,16 @@ public:
 
 	// ----------------------------------------
 
-	void SetBuffer(DATA_T* data, int32_t capacity) {
+	// use the static buffer data. Unless it is shareable, copies of the array copy its items instead
+	// of sharing it, because it lives only as long as whoever provided it (see MappedArray).
+	void SetBuffer(DATA_T* data, int32_t capacity, bool isShareable = true) {
 		if (Data() != data) {
 			Destroy();
 			if (not data)
 				Reset();
 			else {
-				Base::SetBuffer(data, true);
+				Base::SetBuffer(data, true, isShareable);
+				m_info.length =
 				m_info.capacity = capacity;
 			}
 		}
@@ -404,34 +657,118 @@ public:
 
 	// ----------------------------------------
 
-	inline DATA_T* Realloc(int32_t capacity, bool keepData) {
+	// move to a buffer for capacity items, keeping as many of the items in use as fit if keepData
+	// is set. Items of our own buffer are moved and the buffer is released; trivially relocatable
+	// items are moved bytewise, growing the buffer in place with realloc where possible. Items of a
+	// static buffer are copied, since the buffer belongs to someone else.
+	DATA_T* Realloc(int32_t capacity, bool keepData) {
+		DATA_T* data = Data();
+		bool isOwner = data and not Base::m_isStatic;
+		int32_t length = (keepData and data) ? std::min(m_info.length, capacity) : 0;
 		DATA_T* p;
-		try {
-			p = new DATA_T[capacity];
-		}
-		catch (...) {
-			return Data();
+		if constexpr (rawStorage) {
+			if (isOwner) { // drop the items that aren't kept
+				DestroyItems(data + length, m_info.length - length);
+				m_info.length = length;
+			}
+			if constexpr (Base::useMalloc) {
+				if (isOwner and length) {
+					if (not (p = Base::Reallocate(data, capacity)))
+						return nullptr;
+					Base::SetBuffer(p, false);
+					return p;
+				}
+			}
+			if (not (p = Base::Allocate(capacity)))
+				return nullptr;
+			if (not isOwner)
+				CopyItems(p, data, length, false);
+			else if constexpr (is_trivially_relocatable_v<DATA_T>)
+				memcpy(static_cast<void*>(p), data, size_t(length) * sizeof(DATA_T));
+			else {
+				std::uninitialized_move_n(data, length, p);
+				DestroyItems(data, length);
+			}
+			if (isOwner)
+				Base::Free(data);
 		}
-		if (keepData && Data()) {
-			memcpy(p, Data(), ((capacity > m_info.capacity) ? m_info.capacity : capacity) * sizeof(DATA_T));
-			Clear(); // hack to avoid d'tors
+		else {
+			try {
+				p = new DATA_T[capacity];
+			}
+			catch (...) {
+				return nullptr;
+			}
+			CopyItems(p, data, length, isOwner);
 		}
-		Base::SetBuffer(p, false);
+		Base::SetBuffer(p, false); // a shared buffer releases the old one
+		m_info.length = length;
 		return p;
 	}
 
 
-	DATA_T* Resize(int32_t capacity, bool keepData = true) {
-		if (IsStatic())
-			return Reserve(capacity);
-		if (capacity > m_info.capacity) {
-			Realloc(capacity, keepData);
-			m_info.capacity = capacity;
-			m_info.pos %= capacity;
+	inline bool SetCapacity(int32_t capacity, bool keepData) {
+		if (not Realloc(capacity, keepData))
+			return false;
+		m_info.capacity = capacity;
+		return true;
+	}
+
+
+	// capacity for holding length items: at least the current capacity times the growth factor,
+	// so appending item by item only copies each item a constant number of times on average
+	inline int32_t GrowthCapacity(int32_t length) const {
+		return std::max(length, int32_t(m_info.capacity * m_info.growth));
+	}
+
+
+	inline bool Grow(int32_t length) {
+		return ((length <= m_info.capacity) and not Base::m_isStatic) or SetCapacity(GrowthCapacity(length), true);
+	}
+
+
+	// set the number of items in use, growing the buffer if necessary. Added items are default
+	// initialized, i.e. trivial types are left uninitialized.
+	DATA_T* Resize(int32_t length, bool keepData = true) {
+		if (Base::m_isStatic) {
+			if (not SetCapacity(length, keepData))
+				return nullptr;
+		}
+		else if (length > m_info.capacity) {
+			if (not SetCapacity(GrowthCapacity(length), keepData))
+				return nullptr;
 		}
+		else if (not keepData) {
+			DestroyItems(Data(), m_info.length);
+			m_info.length = 0;
+		}
+		if (length < m_info.length)
+			DestroyItems(Data() + length, m_info.length - length);
+		else
+			ConstructItems(Data() + m_info.length, length - m_info.length);
+		m_info.length = length;
+		if (length)
+			m_info.pos %= length;
 		return Data();
 	}
 
+
+	// release the capacity beyond the items in use
+	void ShrinkToFit(void) {
+		if ((m_info.capacity > m_info.length) and not IsStatic()) {
+			if (m_info.length)
+				SetCapacity(m_info.length, true);
+			else
+				Destroy();
+		}
+	}
+
+	// ----------------------------------------
+
+	inline const int32_t Length(void) const {
+		return m_info.length;
+	}
+
 	// ----------------------------------------
 
 	inline const int32_t Capacity(void) const {
@@ -440,6 +777,57 @@ public:
 
 	// ----------------------------------------
 
+	inline bool IsEmpty(void) const {
+		return m_info.length == 0;
+	}
+
+	// ----------------------------------------
+
+	inline float GrowthFactor(void) const {
+		return m_info.growth;
+	}
+
+	// ----------------------------------------
+
+	inline void SetGrowthFactor(float growth) {
+		m_info.growth = (growth > 1.0f) ? growth : 1.0f;
+	}
+
+	// ----------------------------------------
+
+	template <typename... ARGS>
+	DATA_T* Append(ARGS&&... args) {
+		DATA_T data(std::forward<ARGS>(args)...); // args may refer to an item of this array
+		if (not Grow(m_info.length + 1))
+			return nullptr;
+		DATA_T* p = Data() + m_info.length++;
+		if constexpr (rawStorage)
+			new (p) DATA_T(std::move(data));
+		else
+			*p = std::move(data);
+		return p;
+	}
+
+	// ----------------------------------------
+
+	template <typename T>
+	inline bool Push(T&& data) {
+		return Append(std::forward<T>(data)) != nullptr;
+	}
+
+	// ----------------------------------------
+
+	inline DATA_T Pop(void) {
+		if (not m_info.length)
+			return m_none;
+		DATA_T* p = Data() + --m_info.length;
+		DATA_T data = std::move(*p);
+		DestroyItems(p, 1);
+		return data;
+	}
+
+	// ----------------------------------------
+
 	inline DATA_T* Current(void) {
 		return Data(m_info.pos);
 	}
@@ -447,13 +835,13 @@ public:
 	// ----------------------------------------
 
 	inline int32_t Size(void) {
-		return m_info.capacity * sizeof(DATA_T);
+		return m_info.length * sizeof(DATA_T);
 	}
 
 	// ----------------------------------------
 
 	inline bool IsValidIndex(int32_t i) {
-		return (i >= 0) && (i < m_info.capacity);
+		return (i >= 0) && (i < m_info.length);
 	}
 
 	// ----------------------------------------
@@ -465,7 +853,7 @@ public:
 	// ----------------------------------------
 
 	inline int GetCheckedIndex(int32_t x, int32_t y) {
-		return IsValidIndex(x, y) ? -1 : int(y * m_info.width + x);
+		return IsValidIndex(x, y) ? int(m_info.grid.Index(x, y)) : -1;
 	}
 
 	// ----------------------------------------
@@ -477,7 +865,7 @@ public:
 	// ----------------------------------------
 
 	inline DATA_T* operator()(int32_t x, int32_t y) {
-		return Data(y * m_info.width + x);
+		return Data(m_info.grid.Index(x, y));
 	}
 
 	// ----------------------------------------
@@ -496,13 +884,14 @@ public:
 	// ----------------------------------------
 
 	const DATA_T& operator()(int32_t x, int32_t y) const {
-		return *Data(y * m_info.width + x);
+		return *Data(m_info.grid.Index(x, y));
 	}
 
 	// ----------------------------------------
 
+	// rows are only contiguous in row major order; nullptr for tiled grids (see TileRow)
 	inline DATA_T* DataRow(int32_t y) {
-		return Data(y * m_info.width);
+		return m_info.grid.IsTiled() ? nullptr : Data(y * m_info.width);
 	}
 
 	// ----------------------------------------
@@ -521,7 +910,7 @@ public:
 	// ----------------------------------------
 
 	inline ManagedArray<DATA_T>& operator= (ManagedArray<DATA_T> const& source) {
-		return CopyData(source.Data(), source.Capacity());
+		return CopyData(source.Data(), source.Length());
 	}
 
 	// ----------------------------------------
@@ -533,9 +922,9 @@ public:
 	// ----------------------------------------
 
 	inline ManagedArray<DATA_T>& operator= (std::initializer_list<DATA_T> data) {
-		Reserve(int32_t(data.size()));
+		if (Resize(int32_t(data.size()), false))
+			std::copy(data.begin(), data.end(), Data());
 		Init();
-		memcpy(Data(), data.begin(), sizeof(DATA_T) * data.size());
 		return *this;
 	}
 
@@ -543,7 +932,7 @@ public:
 
 	inline DATA_T& operator= (DATA_T* source) {
 		if (this != &source)
-			memcpy(Data(), source, m_info.capacity * sizeof(DATA_T));
+			memcpy(Data(), source, m_info.length * sizeof(DATA_T));
 		return *Data();
 	}
 
@@ -551,12 +940,19 @@ public:
 
 	ManagedArray& CopyData(const ManagedArray& source, bool allowStatic = true, int32_t offset = 0) {
 		if ((this != &source) && source.Data()) {
-			if (allowStatic && source.IsStatic()) {
+			if (allowStatic && source.IsStatic() && source.Base::m_isShareable) {
+				Destroy();
 				Base::m_isStatic = true;
 				BufferHandle() = source.BufferHandle();
+				m_info.length = source.m_info.length;
+				m_info.capacity = source.m_info.capacity;
 			}
 			else
-				CopyData(source.Data(), source.Capacity(), offset);
+				CopyData(source.Data(), source.Length(), offset);
+			// keep the grid geometry, so tiled cells stay addressable
+			m_info.width = source.m_info.width;
+			m_info.height = source.m_info.height;
+			m_info.grid = source.m_info.grid;
 		}
 		return *this;
 	}
@@ -565,15 +961,18 @@ public:
 
 	ManagedArray& CopyData(DATA_T const* sourceData, int32_t count, int32_t offset = 0) {
 		if (Resize(count + offset, false))
-			memcpy(Data(offset), sourceData, std::min(m_info.capacity - offset, count) * sizeof(DATA_T));
+			std::copy_n(sourceData, std::min(m_info.length - offset, count), Data(offset));
 		return *this;
 	}
 
 	// ----------------------------------------
 
 	ManagedArray& Move(ManagedArray& source) {
+		if (not source.Base::m_isShareable) // the buffer stays with its provider
+			return CopyData(source, false);
 		Destroy();
 		memcpy(&m_info, &source.m_info, sizeof(ArrayInfo));
+		Base::m_isStatic = source.Base::m_isStatic;
 		BufferHandle() = std::move(source.BufferHandle());
 		source.BufferHandle() = nullptr;
 		source.Reset();
@@ -582,7 +981,7 @@ public:
 
 	// ----------------------------------------
 
-	inline DATA_T operator+ (ManagedArray<DATA_T>& source) {
+	inline ManagedArray<DATA_T> operator+ (ManagedArray<DATA_T>& source) {
 		ManagedArray<DATA_T> a(*this);
 		a += source;
 		return a;
@@ -590,23 +989,42 @@ public:
 
 	// ----------------------------------------
 
-	inline DATA_T& operator+= (ManagedArray<DATA_T>& source) {
-		int32_t offset = m_info.capacity;
-		if (BufferHandle())
-			Resize(m_info.capacity + source.m_info.capacity);
-		return CopyData(source, offset);
+	inline ManagedArray<DATA_T>& operator+= (ManagedArray<DATA_T>& source) {
+		int32_t length = m_info.length, count = source.m_info.length; // source may be this array
+		if (count and Resize(length + count))
+			std::copy_n(source.Data(), count, Data() + length);
+		return *this;
 	}
 
 	// ----------------------------------------
 
-	inline bool operator== (ManagedArray<DATA_T>& other) {
-		return (m_info.capacity == other.m_info.capacity) and not (m_info.capacity && memcmp(Data(), other.Data()));
+	// equal if the items in use are equal. Tiled grids are equal if their cells (and the items
+	// beyond the grid) are, whatever their storage order; their padding isn't compared.
+	bool operator== (const ManagedArray<DATA_T>& other) const {
+		const GridLayout& layout = m_info.grid;
+		const GridLayout& otherLayout = other.m_info.grid;
+		bool isGrid = layout.IsTiled() and layout.HoldsGrid(m_info.length);
+		bool otherIsGrid = otherLayout.IsTiled() and otherLayout.HoldsGrid(other.m_info.length);
+		if ((isGrid or otherIsGrid) and not (layout == otherLayout)) {
+			if ((m_info.width != other.m_info.width) or (m_info.height != other.m_info.height)
+				or not layout.HoldsGrid(m_info.length) or not otherLayout.HoldsGrid(other.m_info.length)
+				or (m_info.length - layout.Size() != other.m_info.length - otherLayout.Size()))
+				return false;
+			for (int32_t y = 0; y < m_info.height; y++)
+				for (int32_t x = 0; x < m_info.width; x++)
+					if (not (Data()[layout.Index(x, y)] == other.Data()[otherLayout.Index(x, y)]))
+						return false;
+			return EqualItems(Data() + layout.Size(), other.Data() + otherLayout.Size(), m_info.length - layout.Size());
+		}
+		if (m_info.length != other.m_info.length)
+			return false;
+		return layout.ForEachRun(m_info.length, [&](int32_t i, int32_t n) { return EqualItems(Data() + i, other.Data() + i, n); });
 	}
 
 	// ----------------------------------------
 
-	inline bool operator!= (ManagedArray<DATA_T>& other) {
-		return (m_info.capacity != other.m_info.capacity) or (m_info.capacity && memcmp(Data(), other.Data()));
+	inline bool operator!= (const ManagedArray<DATA_T>& other) const {
+		return not (*this == other);
 	}
 
 	// ----------------------------------------
@@ -615,14 +1033,14 @@ public:
 
 	// ----------------------------------------
 
-	inline DATA_T* End(void) { return (Data() && m_info.capacity) ? Data() + m_info.capacity - 1 : nullptr; }
+	inline DATA_T* End(void) { return (Data() && m_info.length) ? Data() + m_info.length - 1 : nullptr; }
 
 	// ----------------------------------------
 
 	inline DATA_T* operator++ (void) {
 		if (not Data())
 			return nullptr;
-		if (m_info.pos < m_info.capacity - 1)
+		if (m_info.pos < m_info.length - 1)
 			m_info.pos++;
 		else if (m_info.wrap)
 			m_info.pos = 0;
@@ -639,7 +1057,7 @@ public:
 		if (m_info.pos > 0)
 			m_info.pos--;
 		else if (m_info.wrap)
-			m_info.pos = m_info.capacity - 1;
+			m_info.pos = m_info.length - 1;
 		else
 			return nullptr;
 		return Data() + m_info.pos;
@@ -665,7 +1083,7 @@ public:
 
 	// ----------------------------------------
 
-	inline void Pos(int32_t pos) { m_info.pos = pos % m_info.capacity; }
+	inline void Pos(int32_t pos) { m_info.pos = pos % m_info.length; }
 
 	// ----------------------------------------
 
@@ -676,33 +1094,7 @@ public:
 	inline int32_t GetOffset(void) { return m_info.offset; }
 
 	// ----------------------------------------
-#if 0
-	int32_t Read(CFile& cf, int32_t nCount = 0, int32_t nOffset = 0, bool bCompressed = 0) {
-		if (not Data())
-			return -1;
-		if (nOffset >= m_info.capacity)
-			return -1;
-		if (not nCount)
-			nCount = m_info.capacity - nOffset;
-		else if (nCount > m_info.capacity - nOffset)
-			nCount = m_info.capacity - nOffset;
-		return cf.Read(DataPtr() + nOffset, sizeof(DATA_T), nCount, bCompressed);
-	}
-
-	// ----------------------------------------
-
-	int32_t Write(CFile& cf, int32_t nCount = 0, int32_t nOffset = 0, int32_t bCompressed = 0) {
-		if (not Data())
-			return -1;
-		if (nOffset >= m_info.capacity)
-			return -1;
-		if (not nCount)
-			nCount = m_info.capacity - nOffset;
-		else if (nCount > m_info.capacity - nOffset)
-			nCount = m_info.capacity - nOffset;
-		return cf.Write(DataPtr() + nOffset, sizeof(DATA_T), nCount, bCompressed);
-	}
-#endif
+	// reading and writing arrays from and to files: see arrayfile.hpp
 
 	// ----------------------------------------
 
@@ -712,35 +1104,35 @@ public:
 
 	inline void SortAscending(int32_t left = 0, int32_t right = 0) {
 		if (Data())
-			QuickSort<DATA_T>::SortAscending(Data(), left, (right = 0) ? right : m_info.capacity - 1);
+			QuickSort<DATA_T>::SortAscending(Data(), left, (right = 0) ? right : m_info.length - 1);
 	}
 
 	// ----------------------------------------
 
 	inline void SortDescending(int32_t left = 0, int32_t right = 0) {
 		if (Data())
-			QuickSort<DATA_T>::SortDescending(Data(), left, (right > 0) ? right : m_info.capacity - 1);
+			QuickSort<DATA_T>::SortDescending(Data(), left, (right > 0) ? right : m_info.length - 1);
 	}
 
 	// ----------------------------------------
 
 	inline void SortAscending(QuickSort<DATA_T>::tComparator compare, int32_t left = 0, int32_t right = 0) {
 		if (Data())
-			QuickSort<DATA_T>::SortAscending(Data(), left, (right > 0) ? right : m_info.capacity - 1, compare);
+			QuickSort<DATA_T>::SortAscending(Data(), left, (right > 0) ? right : m_info.length - 1, compare);
 	}
 
 	// ----------------------------------------
 
 	inline void SortDescending(QuickSort<DATA_T>::tComparator compare, int32_t left = 0, int32_t right = 0) {
 		if (Data())
-			QuickSort<DATA_T>::SortDescending(Data(), left, (right > 0) ? right : m_info.capacity - 1, compare);
+			QuickSort<DATA_T>::SortDescending(Data(), left, (right > 0) ? right : m_info.length - 1, compare);
 	}
 
 	// ----------------------------------------
 
 	template<typename KEY_T>
 	inline int32_t Find(KEY_T const& key, int(__cdecl* compare) (DATA_T const&, KEY_T const&), int32_t left = 0, int32_t right = 0) {
-		return Data() ? this->BinSearch(Data(), key, compare, left, (right > 0) ? right : m_info.capacity - 1) : -1;
+		return Data() ? this->BinSearch(Data(), key, compare, left, (right > 0) ? right : m_info.length - 1) : -1;
 	}
 };
 
@@ -759,7 +1151,7 @@ class CharArray : public ManagedArray<char> {
 public:
 	inline char* operator= (const char* source) {
 		int32_t l = int32_t(strlen(source) + 1);
-		if ((l > this->m_info.capacity) and not this->Resize(this->m_info.capacity + l))
+		if (not this->Resize(l, false))
 			return nullptr;
 		memcpy(this->Data(), source, l);
 		return this->Data();
@@ -774,7 +1166,7 @@ using SharedArray = ManagedArray<DATA_T, SharedPointer<DATA_T>>;
 class ByteArray : public ManagedArray<uint8_t> {
 public:
 	ByteArray(const int32_t nLength) {
-		Reserve(nLength);
+		Resize(nLength);
 		Init();
 	}
 };
@@ -782,7 +1174,7 @@ public:
 class ShortArray : public ManagedArray<int16_t> {
 public:
 	ShortArray(const int32_t nLength) {
-		Reserve(nLength);
+		Resize(nLength);
 		Init();
 	}
 };
@@ -790,7 +1182,7 @@ public:
 class UShortArray : public ManagedArray<uint16_t> {
 public:
 	UShortArray(const int32_t nLength) {
-		Reserve(nLength);
+		Resize(nLength);
 		Init();
 	}
 };
@@ -798,7 +1190,7 @@ public:
 class IntArray : public ManagedArray<int32_t> {
 public:
 	IntArray(const int32_t nLength) {
-		Reserve(nLength);
+		Resize(nLength);
 		Init();
 	}
 };
@@ -806,7 +1198,7 @@ public:
 class UIntArray : public ManagedArray<int32_t> {
 public:
 	UIntArray(const int32_t nLength) {
-		Reserve(nLength);
+		Resize(nLength);
 		Init();
 	}
 };
@@ -814,7 +1206,7 @@ public:
 class SizeArray : public ManagedArray<size_t> {
 public:
 	SizeArray(const int32_t nLength) {
-		Reserve(nLength);
+		Resize(nLength);
 		Init();
 	}
 };
@@ -822,7 +1214,7 @@ public:
 class FloatArray : public ManagedArray<float> {
 public:
 	FloatArray(const int32_t nLength) {
-		Reserve(nLength);
+		Resize(nLength);
 		Init();
 	}
 };
@@ -838,8 +1230,8 @@ protected:
 public:
 	StaticArray() { Reserve(capacity); }
 
-	DATA_T* Reserve(int32_t capacity) {
-		this->SetBuffer(m_buffer, capacity);
+	DATA_T* Reserve(int32_t size) {
+		this->SetBuffer(m_buffer, size);
 		return m_buffer;
 	}
 	void Destroy(void) {}
@@ -8,6 +8,9 @@
 #include <utility>
 #include <functional>
 #include <type_traits>
+#include <vector>
+#include <thread>
+#include <algorithm>
 
 #include <stdint.h>
 #include <string.h>
@@ -20,6 +23,14 @@
 #include "allocator.h"
 #include "type_helper.hpp"
 #include "array.hpp"
+#include "listnodepool.hpp"
+#include "listindex.hpp"
+#include "listhashindex.hpp"
+
+// take list nodes from node pools with per thread caches (see listnodepool.hpp) instead of allocating each of them on the heap
+#ifndef USE_LIST_NODE_POOL
+#	define USE_LIST_NODE_POOL 1
+#endif
 
 //-----------------------------------------------------------------------------
 
@@ -188,20 +199,22 @@ public:
 			ListNodePtr	m_succ;
 			ItemType	m_dataItem;
 			bool		m_manageData;
+			ListIndexNode<ListNode>* m_indexNode;
 
 			explicit ListNode() {
 				//m_dataItem = ItemType();
 				InitializeAnyType(m_dataItem);
 				m_manageData = true;
+				m_indexNode = nullptr;
 			}
 
 			ListNode(const ItemType& dataValue, bool manageData = false)
-				: m_pred(nullptr), m_succ(nullptr), m_dataItem(dataValue), m_manageData(manageData)
+				: m_pred(nullptr), m_succ(nullptr), m_dataItem(dataValue), m_manageData(manageData), m_indexNode(nullptr)
 			{
 }
 
 			ListNode(ItemType&& dataValue, bool manageData = false)
-				: m_pred(nullptr), m_succ(nullptr), m_dataItem(dataValue), m_manageData(manageData)
+				: m_pred(nullptr), m_succ(nullptr), m_dataItem(std::move(dataValue)), m_manageData(manageData), m_indexNode(nullptr)
 			{
 			}
 
@@ -210,6 +223,7 @@ public:
 				m_manageData = other.m_manageData;
 				m_pred = nullptr;
 				m_succ = nullptr;
+				m_indexNode = nullptr;
 			}
 
 			inline ListNode* Pred(void) {
@@ -412,46 +426,70 @@ public:
 	// ----------------------------------------
 	// This list implementation uses two dummy entries as head and tail elements,
 	// as this makes many operations on the list much easier.
-	// Since the list can always store a ItemType*, head and tail will be initialized 
-	// with a ItemType*, which is quite memory efficient.
+	// Head and tail are members of the list, so creating a list doesn't allocate anything.
 
 protected:
 	const char* m_name;
+	ListNode	m_headNode;
+	ListNode	m_tailNode;
 	ListNode*	m_head;
 	ListNode*	m_tail;
 	ListNodePtr	m_headPtr;
 	ListNodePtr	m_tailPtr;
-	ItemType*	m_none;
-
-	// holds a copy of the median data for sorting; one global variable should work 
-	// as it is only used during the sorting part and not during the recursive descent
-	ItemType	m_median;
-	tComparator	m_compare;
+	ItemType	m_none;
+	ListIndex<ListNode>* m_index;	// optional positional index, see EnableIndex()
+	ListHashIndexBase<ListNode, ItemType>* m_hashIndex;	// optional value index, see EnableHashIndex()
 
 	int32_t		m_length;
 	bool		m_result;
 	bool		m_isValid;
 
 public:
+	template <typename... ARGS>
+	static inline ListNode* NewNode(ARGS&&... args) {
+#if USE_LIST_NODE_POOL
+		void* node = ListNodePool<ListNode>::Claim();
+		return node ? new (node) ListNode(std::forward<ARGS>(args)...) : nullptr;
+#else
+		return new ListNode(std::forward<ARGS>(args)...);
+#endif
+	}
+
+
+	static inline void DeleteNode(ListNode* node) {
+#if USE_LIST_NODE_POOL
+		node->~ListNode();
+		ListNodePool<ListNode>::Release(node);
+#else
+		delete node;
+#endif
+	}
+
+
+	// make room for count new nodes with at most one allocation
+	static inline bool ReserveNodes(int32_t count) {
+#if USE_LIST_NODE_POOL
+		return ListNodePool<ListNode>::Reserve(int(count));
+#else
+		return true;
+#endif
+	}
+
+
+	// unlink all nodes from the list without deleting them (they have been moved to another list)
 	inline void Reset(void) {
-		m_head = nullptr;
-		m_tail = nullptr;
-		m_headPtr = nullptr;
-		m_tailPtr = nullptr;
+		m_headPtr.Succ() = m_tail;
+		m_tailPtr.Pred() = m_head;
 		m_length = 0;
-		m_isValid = false;
 	}
 
 
 	inline void Init(void) {
 		if (not m_isValid) {
 			m_isValid = true;
-			m_head = new ListNode();
-			m_tail = new ListNode();
-			if constexpr (std::is_pointer_v<ItemType>)
-				m_none = nullptr;
-			else
-				m_none = new ItemType();
+			m_head = &m_headNode;
+			m_tail = &m_tailNode;
+			InitializeAnyType(m_none);
 			m_headPtr = m_head;
 			m_tailPtr = m_tail;
 			m_headPtr.Pred() =
@@ -464,14 +502,19 @@ public:
 
 	void Clear(void) {
 		if (m_head) {
+			if (m_index)
+				m_index->Clear();
+			if (m_hashIndex)
+				m_hashIndex->Clear();
 			for (ListNodePtr n = m_headPtr + 1; n != m_tailPtr; ) {
 				ListNodePtr p = n;
 				++n;
 				if (p.m_nodePtr) {
-					delete p.m_nodePtr;
+					DeleteNode(p.m_nodePtr);
 					p.m_nodePtr = nullptr;
 				}
 			}
+			m_length = 0;
 		}
 	}
 
@@ -479,19 +522,31 @@ public:
 		if (m_isValid) {
 			m_isValid = false;
 			Clear();
-			delete m_head;
-			delete m_tail;
-			delete m_none;
-			m_head = 
-			m_tail = nullptr;
-			m_none = nullptr;
 		}
 	}
 
-	List<ItemType>& Copy(const List<ItemType>& other) {
-		if (other.Length()) {
-			for (ListNode* pn = other.First(); pn != other.GetTail(); pn = pn->Succ())
-				AddNode(-1, new ListNode(*pn));
+	// append copies of the items [from, to) of other; to <= 0 counts from the end of other.
+	// All nodes are reserved in one go and chained in a single pass over other.
+	List<ItemType>& Copy(const List<ItemType>& other, int32_t from = 0, int32_t to = 0) {
+		if (to <= 0)
+			to += other.m_length;
+		if (not IsAvailable() or (from < 0) or (from >= to) or (to > other.m_length))
+			return *this;
+		int32_t count = to - from;
+		if (not ReserveNodes(count))
+			return *this;
+		ListNode* source = const_cast<List<ItemType>&>(other).NodePtrAt(from);
+		for (; count; count--, source = source->m_succ) {
+			ListNode* node = NewNode(*source);
+			if (not node)
+				break;
+			node->m_manageData = false;
+			node->m_succ = m_tail;
+			node->m_pred = m_tail->m_pred;
+			m_tail->m_pred->m_succ = node;
+			m_tail->m_pred = node;
+			IndexNode(node, m_tail);
+			m_length++;
 		}
 		return *this;
 	}
@@ -545,7 +600,7 @@ public:
 	}
 
 	inline const bool IsAvailable(void) const {
-		return m_head != nullptr;
+		return m_isValid;
 	}
 
 	inline const bool IsEmpty(void) const {
@@ -559,19 +614,22 @@ public:
 			return node->DataItem();
 		}
 		m_result = false;
-		return *m_none;
+		return m_none;
 	}
 #if 0
 	inline DataType& operator[] (ItemType& d) {
 		int i = Find(d);
 		if (i < 0)
-			return *m_none;
+			return m_none;
 		ListNodePtr p = NodePtrAt(int(i));
-		return p ? p->DataValue() : *m_none;
+		return p ? p->DataValue() : m_none;
 	}
 #endif
 	inline List<ItemType>& operator= (List<ItemType> const& other) {
-		Copy(other);
+		if (&other != this) {
+			Clear();
+			Copy(other);
+		}
 		return *this;
 	}
 
@@ -587,43 +645,43 @@ public:
 		return *this;
 	}
 
-	List<ItemType>(const char* name = "", int32_t segmentLength = 1)
-		: m_name(name), m_length(0), m_result(true), m_isValid(false)
+	List(const char* name = "", int32_t segmentLength = 1)
+		: m_name(name), m_index(nullptr), m_hashIndex(nullptr), m_length(0), m_result(true), m_isValid(false)
 	{
 		Init();
 	}
 
-	List<ItemType>(List<ItemType> const& other)
-		: m_length(0), m_result(true), m_isValid(false)
+	List(List<ItemType> const& other)
+		: m_index(nullptr), m_hashIndex(nullptr), m_length(0), m_result(true), m_isValid(false)
 	{
 		Init();
 		Copy(other);
 	}
 
-	List<ItemType>(List<ItemType>&& other) noexcept
-		: m_length(0), m_result(true), m_isValid(false)
+	List(List<ItemType>&& other) noexcept
+		: m_index(nullptr), m_hashIndex(nullptr), m_length(0), m_result(true), m_isValid(false)
 	{
 		Init();
 		Move(other);
 	}
 
-	explicit List<ItemType>(ItemType& data)
-		: m_length(0), m_result(true), m_isValid(false)
+	explicit List(ItemType& data)
+		: m_index(nullptr), m_hashIndex(nullptr), m_length(0), m_result(true), m_isValid(false)
 	{
 		Init();
 		Append(data);
 	}
 
-	explicit List<ItemType>(Array<ItemType>& data, bool manageData = false)
-		: m_length(0), m_result(true), m_isValid(false)
+	explicit List(ManagedArray<ItemType>& data, bool manageData = false)
+		: m_index(nullptr), m_hashIndex(nullptr), m_length(0), m_result(true), m_isValid(false)
 	{
 		Init();
 		for (auto const& v : data)
-			Append(*v, manageData);
+			Append(v, manageData);
 	}
 
-	List<ItemType>(std::initializer_list<ItemType> data, bool manageData = false, int32_t segmentSize = 0)
-		: m_length(0), m_result(true), m_isValid(false)
+	List(std::initializer_list<ItemType> data, bool manageData = false, int32_t segmentSize = 0)
+		: m_index(nullptr), m_hashIndex(nullptr), m_length(0), m_result(true), m_isValid(false)
 	{
 		Init();
 		for (auto const& d : data)
@@ -632,6 +690,8 @@ public:
 
 	~List() {
 		Destroy();
+		DisableIndex();
+		DisableHashIndex();
 	}
 
 	//-----------------------------------------------------------------------------
@@ -642,6 +702,7 @@ public:
 	}
 
 
+	// first is the first list node; last is either the last list node or the tail (when looking for an insertion position)
 	ListNode* NodePtrAt(int i, ListNode* first, ListNode* last) {
 		if (i == 0)
 			return first;
@@ -653,15 +714,20 @@ public:
 			return static_cast<ListNode*>(nullptr);
 		}
 
-		if (i > m_length / 2)
-			i = -(int(m_length) - i);
+		int32_t nodeCount = (last == m_tail) ? m_length + 1 : m_length;
+		if (i < 0)
+			i += nodeCount;
+		m_result = true;
+		if (m_index)
+			return (i == m_length) ? m_tail : m_index->At(i);
+
 		ListNodePtr p;
-		if (i > 0) {
+		if (i <= nodeCount / 2) {
 			for (p = first; (i > 0) && (p != m_tailPtr); i--)
 				++p;
 		}
 		else {
-			for (p = last; (++i < 0) && (p != m_headPtr); )
+			for (p = last, i = nodeCount - 1 - i; (i > 0) && (p != m_headPtr); i--)
 				--p;
 		}
 		m_result = i == 0;
@@ -669,6 +735,97 @@ public:
 	}
 
 	//-----------------------------------------------------------------------------
+	// The positional index makes NodePtrAt, and with it operator[], Insert(i), Extract(i) and Discard(i),
+	// O(log n) instead of O(n), at the cost of an index node per list node. Lists without an index only
+	// pay for an unused pointer per node.
+
+public:
+	bool EnableIndex(void) {
+		if (m_index)
+			return true;
+		m_index = new ListIndex<ListNode>();
+		Reindex();
+		return m_index != nullptr;
+	}
+
+
+	void DisableIndex(void) {
+		if (m_index) {
+			delete m_index;
+			m_index = nullptr;
+		}
+	}
+
+
+	inline bool HasIndex(void) const {
+		return m_index != nullptr;
+	}
+
+	//-----------------------------------------------------------------------------
+	// The hash index maps item values to the nodes holding them, so Find(data) and Remove(data) don't
+	// have to scan the list. Items must not be modified in place (e.g. through operator[] or an iterator)
+	// while it is enabled. If several nodes hold the same value, the first of them can only be determined
+	// quickly with the positional index enabled as well; otherwise the list is scanned for it.
+
+public:
+	template <typename HASH_T = std::hash<ItemType>>
+	bool EnableHashIndex(void) {
+		if (m_hashIndex)
+			return true;
+		m_hashIndex = new ListHashIndex<ListNode, ItemType, HASH_T>();
+		for (ListNode* node = m_head->m_succ; node != m_tail; node = node->m_succ)
+			m_hashIndex->Add(node);
+		return true;
+	}
+
+
+	void DisableHashIndex(void) {
+		if (m_hashIndex) {
+			delete m_hashIndex;
+			m_hashIndex = nullptr;
+		}
+	}
+
+
+	inline bool HasHashIndex(void) const {
+		return m_hashIndex != nullptr;
+	}
+
+private:
+	void Reindex(void) {
+		m_index->Clear();
+		for (ListNode* node = m_head->m_succ; node != m_tail; node = node->m_succ) {
+			if (not m_index->Insert(node, nullptr)) {
+				DisableIndex();
+				return;
+			}
+		}
+	}
+
+
+	// insert into the indices in front of succ (the tail appends)
+	inline void IndexNode(ListNode* node, ListNode* succ) {
+		if (m_index and not m_index->Insert(node, (succ == m_tail) ? nullptr : succ))
+			DisableIndex();
+		if (m_hashIndex)
+			m_hashIndex->Add(node);
+	}
+
+
+	inline void UnindexNode(ListNode* node) {
+		if (m_index)
+			m_index->Remove(node);
+		if (m_hashIndex)
+			m_hashIndex->Remove(node);
+	}
+
+
+	inline void ReleaseNode(ListNode* node) {
+		UnindexNode(node);
+		DeleteNode(node);
+	}
+
+	//-----------------------------------------------------------------------------
 
 public:
 	ListNode* AddNode(int i, ListNode* newNode = nullptr, bool manageData = false) {
@@ -677,13 +834,14 @@ public:
 		ListNode* insertBefore = NodePtrAt(i, m_headPtr + 1, m_tailPtr);
 		if (not insertBefore)
 			return nullptr;
-		if (not newNode && (not (newNode = new ListNode())))
+		if (not newNode && (not (newNode = NewNode())))
 			return nullptr;
 		newNode->m_pred = insertBefore->m_pred;
 		insertBefore->m_pred->m_succ = newNode;
 		newNode->m_succ = insertBefore;
 		newNode->m_manageData = manageData;
 		insertBefore->m_pred = newNode;
+		IndexNode(newNode, insertBefore);
 		m_length++;
 		return newNode;
 	}
@@ -698,11 +856,14 @@ public:
 
 	template<typename T>
 	ItemType* Insert(int i, T&& dataItem, bool manageData = false) {
-		ItemType* itemPtr = Insert(i, manageData);
-		if (not itemPtr)
+		ListNode* newNode = NewNode(std::forward<T>(dataItem));
+		if (not newNode)
+			return nullptr;
+		if (not AddNode(i, newNode, manageData)) {
+			DeleteNode(newNode);
 			return nullptr;
-		*itemPtr = std::forward<T>(dataItem);
-		return itemPtr;
+		}
+		return &newNode->DataItem();
 	}
 
 	//-----------------------------------------------------------------------------
@@ -711,13 +872,13 @@ public:
 	ItemType Extract(int i) {
 		m_result = false;
 		if (not m_length)
-			return *m_none;
+			return m_none;
 
 		ListNode* node = NodePtrAt(i, m_headPtr + 1, m_tailPtr - 1);
 		if (not node)
-			return *m_none;
+			return m_none;
 		ItemType data = node->DataValue();
-		delete node;
+		ReleaseNode(node);
 		m_length--;
 		m_result = true;
 		return data;
@@ -734,7 +895,7 @@ public:
 		if (not node)
 			return false;
 		data = node->DataValue();
-		delete node;
+		ReleaseNode(node);
 		m_length--;
 		return true;
 	}
@@ -747,8 +908,8 @@ public:
 			return false;
 		ListNode* node = NodePtrAt(i, m_headPtr + 1, m_tailPtr - 1);
 		if (not node)
-			return *m_none;
-		delete node;
+			return false;
+		ReleaseNode(node);
 		m_length--;
 		return m_result = true;
 	}
@@ -759,27 +920,30 @@ public:
 
 public:
 	List<ItemType>& operator+= (const List<ItemType>& other) { // copy other to end of *this
-		if (other.IsEmpty())
-			return *this;
-		for (auto& d : other)
-			Insert(-1, d);
-		return *this;
+		return Copy(other);
 	}
 
 
 	List<ItemType>& operator+= (List<ItemType>&& other) { // move other to end of *this
-		if (other.IsEmpty())
+		if (other.IsEmpty() or (&other == this))
 			return *this;
-		if (IsEmpty())
-			return Move(other);
-		ListNodePtr thisLast = ListNodePtr(Last());
-		ListNodePtr otherFirst = ListNodePtr(other.First());
+		ListNodePtr thisLast = m_tailPtr.Pred();
+		ListNodePtr otherFirst = other.m_headPtr.Succ();
+		ListNodePtr otherLast = other.m_tailPtr.Pred();
 		thisLast.Succ() = otherFirst;
 		otherFirst.Pred() = thisLast;
-		std::swap(m_tail, other.m_tail);
-		std::swap(m_tailPtr, other.m_tailPtr);
-		other.m_headPtr.Succ() = other.m_tail;
-		other.m_tailPtr.Pred() = other.m_head;
+		otherLast.Succ() = m_tailPtr;
+		m_tailPtr.Pred() = otherLast;
+		m_length += other.m_length;
+		if (other.m_index)
+			other.m_index->Clear();
+		if (other.m_hashIndex)
+			other.m_hashIndex->Clear();
+		if (m_index or m_hashIndex) {
+			for (ListNode* node = otherFirst; node != m_tail; node = node->m_succ)
+				IndexNode(node, m_tail);
+		}
+		other.Reset();
 		return *this;
 	}
 
@@ -789,16 +953,11 @@ public:
 
 public:
 	List<ItemType>& Move(List<ItemType>& other) {
-		Destroy();
-		if (not other.IsAvailable())
+		if (&other != this) {
+			Destroy();
 			Init();
-		else {
-			m_head = other.m_head;
-			m_tail = other.m_tail;
-			m_headPtr = other.m_head;
-			m_tailPtr = other.m_tail;
-			m_length = other.m_length;
-			other.Reset();
+			if (other.IsAvailable())
+				*this += std::move(other);
 		}
 		return *this;
 	}
@@ -823,25 +982,96 @@ public:
 	template<typename T>
 	int Find(T&& data) {
 		ItemType pattern = std::forward<T>(data);
+		if (m_hashIndex) {
+			ListNode* node = FindNode(pattern);
+			if (not node)
+				return -1;
+			if (m_index)
+				return m_index->IndexOf(node);
+			int i = 0;
+			for (ListNode* p = m_head->m_succ; p != node; p = p->m_succ)
+				i++;
+			return i;
+		}
 		for (auto it = begin(); it != end(); it++)
 			if (*it == pattern)
 				return int (it.Index());
 		return -1;
 	}
 
+
+	// first node holding data
+	ListNode* FindNode(const ItemType& data) {
+		if (m_hashIndex) {
+			bool ambiguous;
+			ListNode* node = m_hashIndex->Find(data, m_index, ambiguous);
+			if (not ambiguous)
+				return node;
+		}
+		for (ListNode* node = m_head->m_succ; node != m_tail; node = node->m_succ)
+			if (node->m_dataItem == data)
+				return node;
+		return nullptr;
+	}
+
 	//-----------------------------------------------------------------------------
 
+	// return a copy of items [from, to); to == 0 copies up to the end of the list
+
 public:
 	List<ItemType> Splice(int32_t from, int32_t to = 0) {
-		ListNode* start = NodePtrAt(int(from), m_headPtr + 1, m_tailPtr - 1);
-		ListNode* end = NodePtrAt(int(to ? to : m_length - 1), m_headPtr + 1, m_tailPtr - 1);
 		List<ItemType> l;
-		if ((start != nullptr) && (end != nullptr)) {
-			for (ListNode* it = start; it != end; it = it->next) {
-				l.Append(new ListNode(it->m_dataItem, it->m_manageData));
+		l.Copy(*this, from, to);
+		return l;
+	}
+
+
+	// Move the count nodes first .. last of other in front of succ in this list by relinking them.
+	// O(1), plus O(count log n) for updating the indices of lists that have any. succ must not be
+	// one of the moved nodes. other may be this list.
+	void SpliceNodes(ListNode* succ, List<ItemType>& other, ListNode* first, ListNode* last, int32_t count) {
+		if (other.m_index or other.m_hashIndex) {
+			for (ListNode* node = first; ; node = node->m_succ) {
+				other.UnindexNode(node);
+				if (node == last)
+					break;
 			}
 		}
-		return l;
+		first->m_pred->m_succ = last->m_succ;
+		last->m_succ->m_pred = first->m_pred;
+		other.m_length -= count;
+		first->m_pred = succ->m_pred;
+		succ->m_pred->m_succ = first;
+		last->m_succ = succ;
+		succ->m_pred = last;
+		m_length += count;
+		if (m_index or m_hashIndex) {
+			for (ListNode* node = first; node != succ; node = node->m_succ)
+				IndexNode(node, succ);
+		}
+	}
+
+
+	// move items [from, to) of other in front of item i of this list (i == -1 or Length(): append);
+	// to <= 0 counts from the end of other. Within one list, i must not lie inside (from, to).
+	bool Splice(int32_t i, List<ItemType>& other, int32_t from = 0, int32_t to = 0) {
+		if (to <= 0)
+			to += other.m_length;
+		if (i < 0)
+			i += m_length + 1;
+		if (not IsAvailable() or (from < 0) or (from >= to) or (to > other.m_length) or (i < 0) or (i > m_length))
+			return false;
+		if (&other == this) {
+			if ((i == from) or (i == to))
+				return true;
+			if ((i > from) and (i < to))
+				return false;
+		}
+		ListNode* succ = (i == m_length) ? m_tail : NodePtrAt(i);
+		ListNode* first = other.NodePtrAt(from);
+		ListNode* last = other.NodePtrAt(to - 1);
+		SpliceNodes(succ, other, first, last, to - from);
+		return true;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -856,14 +1086,20 @@ public:
 		return Insert(-1, manageData);
 	}
 
+	// take over all nodes of other in O(1) (plus indexing, if enabled); will leave other empty
+	inline List<ItemType>& Append(List<ItemType>&& other) {
+		return *this += std::move(other);
+	}
+
 	//-----------------------------------------------------------------------------
 
 public:
-	inline bool Remove(ItemType data) {
-		int i = Find(data);
-		if (i < 0)
+	inline bool Remove(const ItemType& data) {
+		ListNode* node = FindNode(data);
+		if (not node)
 			return (m_result = false);
-		Extract(int32_t(i));
+		ReleaseNode(node);
+		m_length--;
 		return (m_result = true);
 	}
 
@@ -877,7 +1113,7 @@ public:
 			ListNode* candidate = nodePtr;
 			nodePtr = nodePtr->Succ();
 			if (filter(*candidate->DataPointer())) {
-				delete candidate;
+				ReleaseNode(candidate);
 				deleted++;
 			}
 		}
@@ -887,73 +1123,124 @@ public:
 
 	//-----------------------------------------------------------------------------
 
-	inline void Swap(ItemType* left, ItemType* right)
-	{
-		ItemType h;
-		memcpy(&h, left, sizeof(ItemType));
-		memcpy(left, right, sizeof(ItemType));
-		memcpy(right, &h, sizeof(ItemType));
-		memset(&h, 0, sizeof(ItemType));
+	// Stable bottom-up merge sort. Nodes are relinked instead of having their data copied: while sorting,
+	// they form null terminated runs chained through m_succ, and the m_pred links are restored in the end.
+	// The sequential sort doesn't allocate memory. A parallel sort cuts the list into one piece per thread,
+	// sorts the pieces concurrently and merges neighbouring pieces pairwise.
+
+private:
+	static constexpr int32_t minParallelSize = 16384; // don't sort pieces smaller than that on a thread of their own
+
+	// nodes of run a precede those of run b in the list, so a wins ties
+	static ListNode* MergeRuns(ListNode* a, ListNode* b, tComparator compare, int direction) {
+		ListNode* run = nullptr;
+		ListNode** link = &run;
+		while (a and b) {
+			if (direction * compare(&b->m_dataItem, &a->m_dataItem) < 0) {
+				*link = b;
+				link = &b->m_succ.m_nodePtr;
+				b = b->m_succ.m_nodePtr;
+			}
+			else {
+				*link = a;
+				link = &a->m_succ.m_nodePtr;
+				a = a->m_succ.m_nodePtr;
+			}
+		}
+		*link = a ? a : b;
+		return run;
 	}
 
-	//-----------------------------------------------------------------------------
 
-	ItemType& GetMedian(ListNodePtr p, int i) {
-		for (; i; i--)
-			p++;
-		return p->DataValue();
+	// runs[i] holds a sorted run of 2^i nodes, so merges always pair runs of equal length
+	static ListNode* SortRun(ListNode* node, tComparator compare, int direction) {
+		ListNode* runs[32] = {};
+		int32_t runCount = 0;
+		while (node) {
+			ListNode* run = node;
+			node = node->m_succ.m_nodePtr;
+			run->m_succ.m_nodePtr = nullptr;
+			int32_t i = 0;
+			for (; runs[i]; i++) {
+				run = MergeRuns(runs[i], run, compare, direction);
+				runs[i] = nullptr;
+			}
+			runs[i] = run;
+			if (runCount <= i)
+				runCount = i + 1;
+		}
+		ListNode* run = nullptr;
+		for (int32_t i = 0; i < runCount; i++) {
+			if (runs[i])
+				run = run ? MergeRuns(runs[i], run, compare, direction) : runs[i];
+		}
+		return run;
 	}
 
-	//-----------------------------------------------------------------------------
 
-	void Sort(ListNodePtr leftNode, ListNodePtr rightNode, int32_t left, int32_t right, int direction)
-	{
-		int32_t		l = left,
-					r = right;
-		ListNodePtr	ln = leftNode,
-					rn = rightNode;
-
-		MemCpy(&m_median, GetMedian(left, (l + r) / 2), sizeof(ItemType));
-		do {
-			while (direction * m_compare(ln->DataPointer(), &m_median) < 0) {
-				++l;
-				++ln;
-			}
-			while (direction * m_compare(rn->DataPointer(), &m_median) > 0) {
-				--r;
-				--rn;
-			}
-			if (l <= r) {
-				if (l < r)
-					Swap(l->DataValue(), r->DataValue());
-				l++;
-				r--;
-			}
-		} while (l <= r);
-		memset(&m_median, 0, sizeof(ItemType));
+	static ListNode* ParallelSortRun(ListNode* node, int32_t length, tComparator compare, int direction, int threadCount) {
+		std::vector<ListNode*> runs(threadCount);
+		for (int t = 0; t < threadCount; t++) {
+			runs[t] = node;
+			int32_t runLength = length / threadCount + ((t < length % threadCount) ? 1 : 0);
+			while (--runLength)
+				node = node->m_succ.m_nodePtr;
+			ListNode* succ = node->m_succ.m_nodePtr;
+			node->m_succ.m_nodePtr = nullptr;
+			node = succ;
+		}
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount);
+		for (int t = 1; t < threadCount; t++)
+			threads.emplace_back([&runs, t, compare, direction]() { runs[t] = SortRun(runs[t], compare, direction); });
+		runs[0] = SortRun(runs[0], compare, direction);
+		for (auto& t : threads)
+			t.join();
+		for (int step = 1; step < threadCount; step *= 2) {
+			threads.clear();
+			for (int t = step; t < threadCount; t += 2 * step)
+				threads.emplace_back([&runs, t, step, compare, direction]() { runs[t - step] = MergeRuns(runs[t - step], runs[t], compare, direction); });
+			for (auto& t : threads)
+				t.join();
+		}
+		return runs[0];
+	}
 
-		if (l < right)
-			Sort(ln, rightNode, l, right, direction);
-		if (left < r)
-			Sort(leftNode, rn, left, r, direction);
+
+	void Sort(tComparator compare, int direction, int threadCount) {
+		if (m_length < 2)
+			return;
+		ListNode* run = m_head->m_succ;
+		m_tail->m_pred->m_succ = nullptr;
+		if (threadCount <= 0)
+			threadCount = int(std::thread::hardware_concurrency());
+		threadCount = std::min(threadCount, int(m_length / minParallelSize));
+		run = (threadCount > 1)
+			? ParallelSortRun(run, m_length, compare, direction, threadCount)
+			: SortRun(run, compare, direction);
+		ListNode* pred = m_head;
+		for (ListNode* node = run; node; node = node->m_succ.m_nodePtr) {
+			pred->m_succ = node;
+			node->m_pred = pred;
+			pred = node;
+		}
+		pred->m_succ = m_tail;
+		m_tail->m_pred = pred;
+		if (m_index)
+			Reindex();
 	}
 
 	//-----------------------------------------------------------------------------
+	// threadCount 0: use all hardware threads; lists shorter than 2 * minParallelSize are always sorted sequentially
 
-	void SortDescending(tComparator compare)
-	{
-		m_compare = compare;
-		Sort(First(), Last(), m_length - 1, -1);
+public:
+	inline void SortAscending(tComparator compare, int threadCount = 1) {
+		Sort(compare, 1, threadCount);
 	}
 
-	//-----------------------------------------------------------------------------
 
-	void SortAscending(tComparator compare)
-	{
-		if (m_length > 1) {
-			m_compare = compare;
-			Sort(m_headPtr->Succ(), m_tailPtr->Pred(), m_length, -1);
-		}
+	inline void SortDescending(tComparator compare, int threadCount = 1) {
+		Sort(compare, -1, threadCount);
 	}
 
 	//-----------------------------------------------------------------------------
@@ -27,7 +27,7 @@ public:
 
 
     SharedMemoryHandle()
-        : SharedHandle(nullptr, nullptr), m_isArray(false)
+        : SharedHandle<DATA_T*>(nullptr, nullptr), m_isArray(false)
     {
     }
 
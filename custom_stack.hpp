@@ -6,12 +6,14 @@
 
 #include <stdexcept>
 #include <utility>
+#include <algorithm>
 #include "custom_array.hpp"
+#include "arraykernels.hpp"
 
 //-----------------------------------------------------------------------------
 
 template < class DATA_T > 
-class Stack : public Array< DATA_T > {
+class Stack : public ManagedArray< DATA_T > {
 	protected:
 		int32_t	m_tos;
 		int32_t	m_growth;	// how much to increase buffer size if the stack is full and something gets pushed on it; -1 = no growth, zero = double capacity every time growth is needed
@@ -42,28 +44,34 @@ class Stack : public Array< DATA_T > {
 
 
 		inline bool AllowReordering(bool reorder) {
-			m_reorder = reorder;
+			return m_reorder = reorder;
 		}
 
 
 		inline void Init (void) { 
 			m_growth = 0;
+			m_reorder = false;
 			Reset();
-			Array<DATA_T>::Init ();
+			ManagedArray<DATA_T>::Init ();
 			}
 
 
+		// grows by at least m_growth items, and geometrically (see ManagedArray::GrowthCapacity) beyond that.
+		// The array's length is the high water mark of the stack, so popped items stay valid.
 		inline bool Grow (const int32_t i = 1) {
-			if (m_tos + i >= this->m_info.capacity) {
-				if (not m_growth) {
-					throw std::runtime_error("stack out of space");
-					return false;
-				}
-				if (not this->Resize(this->m_info.capacity + m_growth)) {
-					throw std::runtime_error("stack expansion failed");
-					return false;
+			if (m_tos + i > this->Length ()) {
+				if (m_tos + i > this->Capacity ()) {
+					if (not m_growth) {
+						throw std::runtime_error("stack out of space");
+						return false;
+					}
+					if (not ManagedArray<DATA_T>::Reserve(std::max(this->Capacity () + m_growth, this->GrowthCapacity(m_tos + i)))) {
+						throw std::runtime_error("stack expansion failed");
+						return false;
+					}
 				}
 				//#pragma omp critical
+				this->Resize(m_tos + i);
 			}
 			m_tos += i;
 			return true;
@@ -72,10 +80,17 @@ class Stack : public Array< DATA_T > {
 		
 		template<typename T>
 		inline bool Push (T&& data) { 
+			if (m_tos < this->Capacity ()) {
+				if (not Grow ())
+					return false;
+//#pragma omp critical
+				*(this->Data(m_tos - 1)) = std::forward<T>(data);
+				return true;
+				}
+			DATA_T item (std::forward<T>(data)); // data may refer to an item that growing moves
 			if (not Grow ())
 				return false;
-//#pragma omp critical
-			*(this->Data(m_tos - 1)) = std::forward<T>(data);
+			*(this->Data(m_tos - 1)) = std::move (item);
 			return true;
 			}
 	
@@ -102,26 +117,39 @@ class Stack : public Array< DATA_T > {
 			}
 
 
-		inline int32_t Find (DATA_T& data) {
-			for (int32_t i = 0; i < m_tos; i++)
-				if (this->m_data [i] == data)
-					return i;
-			return m_tos;
+		// index of the first item equal to data, or ToS () if there is none
+		inline int32_t Find (const DATA_T& data) {
+			if constexpr (std::is_arithmetic_v<DATA_T>) {
+				int32_t i = ArrayKernels<DATA_T>::Find (this->Data (), m_tos, data);
+				return (i < 0) ? m_tos : i;
+				}
+			else {
+				for (int32_t i = 0; i < m_tos; i++)
+					if (*this->Data (i) == data)
+						return i;
+				return m_tos;
+				}
 			}
 
 
 		inline int32_t ToS (void) { return m_tos; }
 
 
-		inline DATA_T* Top (void) { return (this->m_data && m_tos) ? this->m_data + m_tos - 1 : NULL; }
+		inline DATA_T* Top (void) { return (this->Data () && m_tos) ? this->Data () + m_tos - 1 : NULL; }
 
 
+		// with reordering allowed, the top item takes the place of the deleted one instead of all items above it moving down
 		inline bool Delete (int32_t i) {
-			if (i >= m_tos) 
+			if ((i < 0) or (i >= m_tos))
 				return false;
 //#pragma omp critical
-			if (i < --m_tos) 
-				memcpy(this->m_data + i, this->m_data + i + 1, sizeof(DATA_T) * (m_tos - i));
+			DATA_T* data = this->Data ();
+			if (i < --m_tos) {
+				if (m_reorder)
+					data [i] = std::move (data [m_tos]);
+				else
+					std::move (data + i + 1, data + m_tos + 1, data + i);
+				}
 			return true;
 			}
 
@@ -132,7 +160,7 @@ class Stack : public Array< DATA_T > {
 		inline DATA_T& Pull (DATA_T& data, int32_t i) {
 //#pragma omp critical
 			if (i < m_tos) {
-				data = this->m_data [i];
+				data = this->Data () [i];
 				Delete (i);
 				}
 			return data;
@@ -147,12 +175,12 @@ class Stack : public Array< DATA_T > {
 
 		inline DATA_T* GetRef(int32_t i) {
 			//#pragma omp critical
-			return (i < m_tos) ? this->m_data + i : nullptr;
+			return (i < m_tos) ? this->Data () + i : nullptr;
 		}
 
 
 		inline void Destroy (void) {
-			Array<DATA_T>::Destroy ();
+			ManagedArray<DATA_T>::Destroy ();
 			m_tos = 0;
 			}
 
@@ -161,7 +189,7 @@ class Stack : public Array< DATA_T > {
 			Destroy ();
 			m_growth = (static_cast<ptrdiff_t>(growth) < 0) ? 0 : (growth > 0) ? growth : capacity;
 			m_reorder = reorder;
-			return Array<DATA_T>::Reserve (capacity);
+			return ManagedArray<DATA_T>::Reserve (capacity);
 			}
 
 
@@ -172,31 +200,31 @@ class Stack : public Array< DATA_T > {
 
 
 		inline void SortAscending (int32_t left = 0, int32_t right = 0) { 
-			if (this->m_data)
-				QuickSort<DATA_T>::SortAscending (this->m_data, left, (right >= 0) ? right : m_tos - 1); 
+			if (this->Data ())
+				QuickSort<DATA_T>::SortAscending (this->Data (), left, (right >= 0) ? right : m_tos - 1); 
 				}
 
 
 		inline void SortDescending (int32_t left = 0, int32_t right = 0) {
-			if (this->m_data)
-				QuickSort<DATA_T>::SortDescending (this->m_data, left, (right >= 0) ? right : m_tos - 1);
+			if (this->Data ())
+				QuickSort<DATA_T>::SortDescending (this->Data (), left, (right >= 0) ? right : m_tos - 1);
 			}
 
 
 		inline void SortAscending (QuickSort<DATA_T>::tComparator compare, int32_t left = 0, int32_t right = 0) {
-			if (this->m_data)
-				QuickSort<DATA_T>::SortAscending (this->m_data, left, (right >= 0) ? right : m_tos - 1, compare);
+			if (this->Data ())
+				QuickSort<DATA_T>::SortAscending (this->Data (), left, (right >= 0) ? right : m_tos - 1, compare);
 			}
 
 
 		inline void SortDescending (QuickSort<DATA_T>::tComparator compare, int32_t left = 0, int32_t right = 0) {
-			if (this->m_data)
-				QuickSort<DATA_T>::SortDescending (this->m_data, left, (right >= 0) ? right : m_tos - 1, compare);
+			if (this->Data ())
+				QuickSort<DATA_T>::SortDescending (this->Data (), left, (right >= 0) ? right : m_tos - 1, compare);
 			}
 
 
 		inline int32_t BinSearch (DATA_T key, int32_t left = 0, int32_t right = 0) {
-			return this->m_data ? QuickSort<DATA_T>::BinSearch (this->m_data, left, (right >= 0) ? right : m_tos - 1, key) : -1;
+			return this->Data () ? QuickSort<DATA_T>::BinSearch (this->Data (), left, (right >= 0) ? right : m_tos - 1, key) : -1;
 			}
 
 	};
@@ -105,7 +105,7 @@ void String::Log(const char* fmt, const char* s) {
 			SetBuffer(m_char, 2);
 		}
 		else { // capacity always > 2 here
-			Reserve(int32_t(capacity));
+			Resize(int32_t(capacity), false);
 			memcpy(Data(), source, m_length);
 			*Data(m_length) = '\0';
 			LOG("Creating string '%source'\n", Data());
@@ -133,7 +133,7 @@ void String::Log(const char* fmt, const char* s) {
 		char s[20];
 		snprintf(s, sizeof(s), "%d", n);
 		m_length = static_cast<int32_t>(strlen(s));
-		Reserve(m_length + 1);
+		Resize(m_length + 1, false);
 		memcpy(Data(), s, m_length + 1);
 	}
 
@@ -150,7 +150,7 @@ void String::Log(const char* fmt, const char* s) {
 		snprintf(s, sizeof(s), "%ld", n);
 #endif
 		m_length = static_cast<int32_t>(strlen(s));
-		Reserve(m_length + 1);
+		Resize(m_length + 1, false);
 		memcpy(Data(), s, m_length + 1);
 	}
 
@@ -174,11 +174,8 @@ void String::Log(const char* fmt, const char* s) {
 
 	String& String::operator= (const char s[]) {
 		int32_t l = (int32_t)strlen(s);
-		if (l + 1 > Capacity()) {
-			Resize(l + 1);
-			if (l + 1 > Capacity())
-				return *this;
-		}
+		if (not Resize(l + 1, false))
+			return *this;
 		memcpy(Data(), s, l + 1);
 		m_length = l;
 		return *this;
@@ -188,8 +185,8 @@ void String::Log(const char* fmt, const char* s) {
 
 	String& String::operator+= (int32_t n) {
 		int32_t s = Length() + n + 1;
-		if (s > Capacity())
-			Resize(s);
+		if (not Resize(s))
+			return *this;
 		m_length += n;
 		return *this;
 	}
@@ -236,7 +233,7 @@ void String::Log(const char* fmt, const char* s) {
 		for (auto const& v : values)
 			l += v.Length();
 		String result;
-		result.Reserve(l + 1);
+		result.Resize(l + 1, false);
 		char* p = result.Data();
 		for (auto const& v : values) {
 			l = v.Length();
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <utility>
+#include <string_view>
 
 #include <ctype.h>
 #include <string.h>
@@ -102,7 +103,7 @@ class String : public SharedArray<char> {
 		}
 
 		void Create(int32_t size) {
-			Reserve(size);
+			Resize(size, false);
 			*Data() = '\0';
 		}
 
@@ -304,10 +305,23 @@ class String : public SharedArray<char> {
 
 		String ToUppercase(void);
 
-		static int Compare(void* context, const String& s1, const String& s2) {
+		static int Compare(void* /*context*/, const String& s1, const String& s2) {
 			return (s1.Data() && s2.Data()) ? strcmp(s1.Data(), s2.Data()) : 0;
 		}
 
+		// Heterogeneous comparison, lets String keyed AVLTrees be searched without building a temporary String
+		static int Compare(void* /*context*/, const char* const& s1, const String& s2) {
+			return (s1 && s2.Data()) ? strcmp(s1, s2.Data()) : 0;
+		}
+
+		static int Compare(void* /*context*/, const std::string_view& s1, const String& s2) {
+			if (!s2.Data())
+				return 0;
+			size_t l1 = s1.length(), l2 = size_t(s2.Length());
+			int rel = memcmp(s1.data(), s2.Data(), (l1 < l2) ? l1 : l2);
+			return rel ? rel : (l1 < l2) ? -1 : (l1 > l2) ? 1 : 0;
+		}
+
 		//----------------------------------------
 
 		template<typename... Args>
@@ -53,10 +53,16 @@ private:
 		}
 		m_usedItems = new(buffer) ItemMap(capacity);
 		m_usedItems->SetComparator(comparator, context);
+		m_usedItems->EnableDataIndex(CompareItemIndices);
 		return true;
 	}
 
 
+	static int CompareItemIndices(void* /*context*/, const int& i, const int& j) {
+		return (i < j) ? -1 : (i > j) ? 1 : 0;
+	}
+
+
 public:
 	inline bool Create(int32_t capacity, Comparator comparator, void* context = nullptr, bool createOnce = true) {
 		return this->m_isCreated = Setup(capacity, comparator, context, createOnce);
@@ -129,7 +135,7 @@ public:
 				return nullptr;
 		}
 		else {
-			typename Map<KEY_T, int>::AVLNode* dataNode = m_usedItems->FindData(itemIndex);
+			typename ItemMap::AVLNode* dataNode = m_usedItems->FindData(itemIndex);
 			if (dataNode)
 				fprintf(stderr, "                                                duplicate item index #%d\n", itemIndex);
 		}
@@ -0,0 +1,331 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+#pragma once
+
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <stdint.h>
+
+#include "array.hpp"
+
+// =================================================================================================
+// Double ended queue in a circular buffer, for FIFO (and LIFO) use where List would allocate a node
+// per item. Appending and prepending items and extracting them at either end take O(1) time
+// (amortized when the buffer has to grow); the items live in one block of memory, so walking them
+// doesn't chase pointers. The buffer is a ManagedArray whose capacity is always a power of two,
+// so positions wrap around with a mask. Growing doubles the capacity; the buffer never shrinks
+// unless the deque is destroyed.
+
+template <typename DATA_T>
+class Deque {
+private:
+	static constexpr int32_t minCapacity = 16;
+
+	ManagedArray<DATA_T>	m_buffer;
+	DATA_T*					m_data;
+	int32_t					m_capacity;
+	int32_t					m_head;		// buffer position of the first item
+	int32_t					m_length;
+	DATA_T					m_none;
+
+	inline int32_t Wrap(int32_t i) const {
+		return i & (m_capacity - 1);
+	}
+
+	inline DATA_T& Slot(int32_t i) const {
+		return m_data[Wrap(m_head + i)];
+	}
+
+	// extracted items leave their slot moved-from; give up what they may still hold
+	inline void Vacate(DATA_T& slot) {
+		if constexpr (not std::is_trivially_destructible_v<DATA_T>)
+			slot = DATA_T();
+	}
+
+
+	template <typename T>
+	inline DATA_T* Store(DATA_T& slot, T&& data) {
+		slot = std::forward<T>(data);
+		return &slot;
+	}
+
+
+	// a free slot in front of the first item, which becomes the first item
+	inline DATA_T& PrependSlot(void) {
+		m_head = Wrap(m_head - 1);
+		m_length++;
+		return Slot(0);
+	}
+
+
+	bool Grow(int32_t capacity) {
+		int32_t newCapacity = m_capacity ? m_capacity : minCapacity;
+		while (newCapacity < capacity)
+			newCapacity *= 2;
+		if (newCapacity == m_capacity)
+			return true;
+		ManagedArray<DATA_T> buffer;
+		DATA_T* data = buffer.Resize(newCapacity);
+		if (not data)
+			return false;
+		for (int32_t i = 0; i < m_length; i++)
+			data[i] = std::move(Slot(i));
+		m_buffer = std::move(buffer);
+		m_data = m_buffer.Data();
+		m_capacity = newCapacity;
+		m_head = 0;
+		return true;
+	}
+
+	//----------------------------------------
+
+public:
+	class Iterator {
+	private:
+		Deque*	m_deque;
+		int32_t	m_index;
+
+	public:
+		Iterator(Deque* deque, int32_t index) : m_deque(deque), m_index(index) {}
+
+		DATA_T& operator*() const {
+			return m_deque->Slot(m_index);
+		}
+
+		DATA_T* operator->() const {
+			return &m_deque->Slot(m_index);
+		}
+
+		inline Iterator& operator++() {
+			++m_index;
+			return *this;
+		}
+
+		inline Iterator& operator--() {
+			--m_index;
+			return *this;
+		}
+
+		inline int32_t Index(void) const {
+			return m_index;
+		}
+
+		bool operator==(const Iterator& other) const {
+			return m_index == other.m_index;
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return m_index != other.m_index;
+		}
+	};
+
+	//----------------------------------------
+
+public:
+	Deque(int32_t capacity = 0)
+		: m_data(nullptr), m_capacity(0), m_head(0), m_length(0), m_none(DATA_T())
+	{
+		if (capacity > 0)
+			Grow(capacity);
+	}
+
+
+	Deque(const Deque& other)
+		: Deque(other.m_length)
+	{
+		*this += other;
+	}
+
+
+	Deque(Deque&& other) noexcept
+		: Deque()
+	{
+		Move(other);
+	}
+
+
+	Deque& operator=(const Deque& other) {
+		if (&other != this) {
+			Clear();
+			*this += other;
+		}
+		return *this;
+	}
+
+
+	Deque& operator=(Deque&& other) noexcept {
+		return Move(other);
+	}
+
+
+	// take over other's buffer; will leave other empty
+	Deque& Move(Deque& other) {
+		if (&other != this) {
+			m_buffer = std::move(other.m_buffer);
+			m_data = other.m_data;
+			m_capacity = other.m_capacity;
+			m_head = other.m_head;
+			m_length = other.m_length;
+			other.m_data = nullptr;
+			other.m_capacity =
+			other.m_head =
+			other.m_length = 0;
+		}
+		return *this;
+	}
+
+
+	// append copies of other's items
+	Deque& operator+=(const Deque& other) {
+		int32_t length = other.m_length; // other may be this deque
+		if (not Grow(m_length + length))
+			return *this;
+		for (int32_t i = 0; i < length; i++)
+			Slot(m_length++) = other.Slot(i);
+		return *this;
+	}
+
+
+	// remove all items; the buffer is kept
+	void Clear(void) {
+		if constexpr (not std::is_trivially_destructible_v<DATA_T>) {
+			for (int32_t i = 0; i < m_length; i++)
+				Vacate(Slot(i));
+		}
+		m_head =
+		m_length = 0;
+	}
+
+
+	inline bool Reserve(int32_t capacity) {
+		return Grow(capacity);
+	}
+
+
+	inline int32_t Length(void) const {
+		return m_length;
+	}
+
+
+	inline int32_t Capacity(void) const {
+		return m_capacity;
+	}
+
+
+	inline bool IsEmpty(void) const {
+		return m_length == 0;
+	}
+
+	//-----------------------------------------------------------------------------
+
+public:
+	template <typename T>
+	DATA_T* Append(T&& data) {
+		if (m_length < m_capacity)
+			return Store(Slot(m_length++), std::forward<T>(data));
+		DATA_T item(std::forward<T>(data)); // data may refer to an item that growing moves
+		if (not Grow(m_length + 1))
+			return nullptr;
+		return Store(Slot(m_length++), std::move(item));
+	}
+
+
+	template <typename T>
+	DATA_T* Prepend(T&& data) {
+		if (m_length < m_capacity)
+			return Store(PrependSlot(), std::forward<T>(data));
+		DATA_T item(std::forward<T>(data)); // data may refer to an item that growing moves
+		if (not Grow(m_length + 1))
+			return nullptr;
+		return Store(PrependSlot(), std::move(item));
+	}
+
+
+	bool ExtractFirst(DATA_T& data) {
+		if (not m_length)
+			return false;
+		DATA_T& slot = Slot(0);
+		data = std::move(slot);
+		Vacate(slot);
+		m_head = Wrap(m_head + 1);
+		m_length--;
+		return true;
+	}
+
+
+	bool ExtractLast(DATA_T& data) {
+		if (not m_length)
+			return false;
+		DATA_T& slot = Slot(--m_length);
+		data = std::move(slot);
+		Vacate(slot);
+		return true;
+	}
+
+
+	bool DiscardFirst(void) {
+		if (not m_length)
+			return false;
+		Vacate(Slot(0));
+		m_head = Wrap(m_head + 1);
+		m_length--;
+		return true;
+	}
+
+
+	bool DiscardLast(void) {
+		if (not m_length)
+			return false;
+		Vacate(Slot(--m_length));
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+
+public:
+	inline DATA_T& First(void) {
+		return m_length ? Slot(0) : m_none;
+	}
+
+
+	inline DATA_T& Last(void) {
+		return m_length ? Slot(m_length - 1) : m_none;
+	}
+
+
+	// i must be in [0, Length())
+	inline DATA_T& operator[](int32_t i) {
+		return Slot(i);
+	}
+
+
+	inline const DATA_T& operator[](int32_t i) const {
+		return Slot(i);
+	}
+
+
+	// rotate the buffer so the items are stored in order from its start, e.g. to pass them on
+	// as a plain array
+	DATA_T* Linearize(void) {
+		if (m_head) {
+			std::rotate(m_data, m_data + m_head, m_data + m_capacity);
+			m_head = 0;
+		}
+		return m_data;
+	}
+
+
+	Iterator begin() {
+		return Iterator(this, 0);
+	}
+
+
+	Iterator end() {
+		return Iterator(this, m_length);
+	}
+};
+
+// =================================================================================================
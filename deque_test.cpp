@@ -0,0 +1,205 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Checks Deque against std::deque: random appends, prepends, extractions and discards at both
+// ends with the buffer wrapping around, FIFO and LIFO use, copies, moves, Linearize, and appending
+// or prepending an item of the deque itself while the buffer grows. Returns 0 if all checks pass.
+// Build e.g. with:
+//   c++ -O2 -std=c++20 deque_test.cpp
+
+#include <deque>
+#include <random>
+#include <string>
+#include <cstdio>
+
+#include "deque.hpp"
+
+// =================================================================================================
+
+static int failures = 0;
+
+static bool Check(bool condition, const char* what) {
+    if (not condition) {
+        fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+    return condition;
+}
+
+//-----------------------------------------------------------------------------
+
+template <typename DATA_T>
+static bool Matches(Deque<DATA_T>& d, const std::deque<DATA_T>& v) {
+    if (d.Length() != int32_t(v.size()))
+        return false;
+    size_t i = 0;
+    for (auto& item : d)
+        if (not (item == v[i++]))
+            return false;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+static std::string MakeItem(unsigned r) {
+    return std::to_string(r % 1000) + std::string(30, 'x'); // too long for the small string buffer
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestRandomOps(unsigned seed)
+{
+    std::mt19937 rng(seed);
+    Deque<std::string> d;
+    std::deque<std::string> v;
+    std::string s;
+    for (int step = 0; step < 50000; step++) {
+        int op = rng() % 8;
+        if (op < 2) {
+            std::string item = MakeItem(rng());
+            d.Append(item);
+            v.push_back(item);
+        }
+        else if (op < 4) {
+            std::string item = MakeItem(rng());
+            d.Prepend(item);
+            v.push_front(item);
+        }
+        else if (op == 4) {
+            bool ok = d.ExtractFirst(s);
+            if (not Check(ok == not v.empty() and (not ok or (s == v.front())), "ExtractFirst"))
+                return;
+            if (ok)
+                v.pop_front();
+        }
+        else if (op == 5) {
+            bool ok = d.ExtractLast(s);
+            if (not Check(ok == not v.empty() and (not ok or (s == v.back())), "ExtractLast"))
+                return;
+            if (ok)
+                v.pop_back();
+        }
+        else if (op == 6) {
+            if (not Check(d.DiscardFirst() == not v.empty(), "DiscardFirst"))
+                return;
+            if (not v.empty())
+                v.pop_front();
+        }
+        else if (not v.empty()) {
+            int32_t i = int32_t(rng() % v.size());
+            if (not Check((d[i] == v[i]) and (d.First() == v.front()) and (d.Last() == v.back()), "operator[], First and Last"))
+                return;
+        }
+        if (not Check(d.Length() == int32_t(v.size()), "Length"))
+            return;
+    }
+    Check(Matches(d, v), "random appends, prepends and extractions");
+
+    Deque<std::string> c(d), m(std::move(c));
+    Check((c.Length() == 0) and Matches(m, v), "copy and move");
+    m += m;
+    std::deque<std::string> w(v);
+    w.insert(w.end(), v.begin(), v.end());
+    Check(Matches(m, w), "operator+= of the deque itself");
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestQueueAndStack(int n)
+{
+    Deque<int> fifo, lifo;
+    int item, expected = 0;
+    bool fifoOk = true, lifoOk = true;
+    for (int i = 0; i < n; i++) {
+        fifo.Append(i);
+        lifo.Append(i);
+        if (i % 3 == 2) { // keep the queue short, so its items wrap around the buffer end
+            fifoOk = fifoOk and fifo.ExtractFirst(item) and (item == expected++);
+            fifoOk = fifoOk and fifo.ExtractFirst(item) and (item == expected++);
+        }
+    }
+    while (fifo.ExtractFirst(item))
+        fifoOk = fifoOk and (item == expected++);
+    for (int i = n; lifo.ExtractLast(item); )
+        lifoOk = lifoOk and (item == --i);
+    Check(fifoOk and (expected == n), "FIFO order");
+    Check(lifoOk and lifo.IsEmpty(), "LIFO order");
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestLinearize(void)
+{
+    Deque<int> d;
+    std::deque<int> v;
+    for (int i = 0; i < 12; i++) {
+        d.Append(i);
+        v.push_back(i);
+    }
+    for (int i = 0; i < 9; i++) {
+        d.DiscardFirst();
+        v.pop_front();
+    }
+    for (int i = 0; i < 10; i++) { // wraps around the end of the buffer
+        d.Append(100 + i);
+        v.push_back(100 + i);
+        d.Prepend(-i);
+        v.push_front(-i);
+    }
+    int* items = d.Linearize();
+    bool same = (d.Length() == int32_t(v.size()));
+    for (int32_t i = 0; same and (i < d.Length()); i++)
+        same = (items[i] == v[i]);
+    Check(same and Matches(d, v), "Linearize");
+    d.Append(7);
+    v.push_back(7);
+    Check(Matches(d, v), "Append after Linearize");
+}
+
+//-----------------------------------------------------------------------------
+
+// appending or prepending an item of the deque itself when the buffer is full: the item must be
+// copied before growing moves (and releases) the source
+static void TestSelfReference(void)
+{
+    Deque<std::string> d;
+    std::deque<std::string> v;
+    d.Append(MakeItem(1));
+    v.push_back(MakeItem(1));
+    for (int i = 0; i < 200; i++) {
+        switch (i % 4) {
+            case 0:
+                d.Append(d[0]);
+                v.push_back(v[0]);
+                break;
+            case 1:
+                d.Prepend(d.Last());
+                v.push_front(v.back());
+                break;
+            case 2:
+                d.Append(MakeItem(i));
+                v.push_back(MakeItem(i));
+                break;
+            default:
+                d.Prepend(d[d.Length() / 2]);
+                v.push_front(v[v.size() / 2]);
+        }
+    }
+    Check(Matches(d, v), "Append and Prepend of own items while growing");
+}
+
+// =================================================================================================
+
+int main()
+{
+    for (unsigned seed = 1; seed < 4; seed++)
+        TestRandomOps(seed);
+    TestQueueAndStack(100000);
+    TestLinearize();
+    TestSelfReference();
+    fprintf(stderr, "%s\n", failures ? "deque_test failed" : "deque_test passed");
+    return failures ? 1 : 0;
+}
+
+// =================================================================================================
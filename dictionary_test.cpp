@@ -0,0 +1,255 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Checks the dictionaries in concurrentdictionary.hpp and shardeddictionary.hpp with several
+// writer and reader threads: readers never see a partially updated entry, Walk visits the keys in
+// ascending order (across all shards of a ShardedDictionary), Modify updates counters without
+// losing increments, and the final contents match what the writers did. Returns 0 if all checks
+// pass. Build e.g. with:
+//   c++ -O2 -std=c++20 -pthread dictionary_test.cpp
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "concurrentdictionary.hpp"
+#include "shardeddictionary.hpp"
+
+// =================================================================================================
+
+static int failures = 0;
+
+static void Check(bool condition, const char* what) {
+    if (not condition) {
+        fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+
+static int CompareInts(void* /*context*/, const int& a, const int& b) {
+    return (a < b) ? -1 : (a > b) ? 1 : 0;
+}
+
+//-----------------------------------------------------------------------------
+// Walk callback: checks that keys ascend and that each entry holds 2 * key
+
+struct WalkState {
+    int     count = 0;
+    int     last = -1;
+    bool    isSorted = true;
+    bool    isConsistent = true;
+};
+
+static bool CheckEntry(void* context, const int& key, const int& data) {
+    WalkState& state = *static_cast<WalkState*>(context);
+    if (key <= state.last)
+        state.isSorted = false;
+    if (data != 2 * key)
+        state.isConsistent = false;
+    state.last = key;
+    state.count++;
+    return true;
+}
+
+// =================================================================================================
+// Each writer owns the keys w, w + writerCount, ...: it inserts them in random order and then
+// removes the odd ones again. Readers look up random keys and walk snapshots meanwhile.
+
+static void TestConcurrentDictionary(int writerCount, int readerCount, int n)
+{
+    ConcurrentDictionary<int, int> dict;
+    dict.SetComparator(CompareInts);
+    int total = writerCount * n;
+    std::atomic<int> activeWriters(writerCount);
+    std::atomic<bool> findsOk(true), walksOk(true);
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writerCount; w++)
+        threads.emplace_back([&, w]() {
+            std::vector<int> keys;
+            for (int i = 0; i < n; i++)
+                keys.push_back(i * writerCount + w);
+            std::shuffle(keys.begin(), keys.end(), std::mt19937(w));
+            for (int key : keys)
+                dict.Insert(key, 2 * key);
+            for (int key : keys)
+                if (key & 1)
+                    dict.Remove(key);
+            activeWriters--;
+        });
+    for (int r = 0; r < readerCount; r++)
+        threads.emplace_back([&, r]() {
+            std::mt19937 rng(100 + r);
+            for (int i = 0; activeWriters.load() > 0; i++) {
+                int key = int(rng() % total), data = -1;
+                if (dict.Find(key, data) and (data != 2 * key))
+                    findsOk = false;
+                if (i % 1000 == 999) {
+                    WalkState state;
+                    dict.Walk(CheckEntry, &state);
+                    if (not (state.isSorted and state.isConsistent))
+                        walksOk = false;
+                    std::this_thread::yield();
+                }
+            }
+        });
+    for (auto& t : threads)
+        t.join();
+
+    Check(findsOk, "ConcurrentDictionary::Find never returns a partially updated entry");
+    Check(walksOk, "ConcurrentDictionary::Walk sees a sorted, consistent snapshot");
+    Check(dict.Size() == (total + 1) / 2, "ConcurrentDictionary::Size counts the remaining entries");
+    bool contentsOk = true;
+    for (int key = 0; key < total; key++) {
+        int data = -1;
+        if (dict.Find(key, data) != not (key & 1))
+            contentsOk = false;
+        else if (not (key & 1) and (data != 2 * key))
+            contentsOk = false;
+    }
+    Check(contentsOk, "ConcurrentDictionary holds exactly the even keys");
+    WalkState state;
+    dict.Walk(CheckEntry, &state);
+    Check(state.isSorted and (state.count == dict.Size()), "ConcurrentDictionary::Walk visits all entries in order");
+
+    int data = -1;
+    Check(not dict.Insert(0, 1) and dict.Find(0, data) and (data == 0), "ConcurrentDictionary::Insert keeps an existing entry");
+    Check(dict.Insert(0, 1, true) and dict.Find(0, data) and (data == 1), "ConcurrentDictionary::Insert updates an existing entry on request");
+    Check(dict.Extract(0, data) and (data == 1) and not dict.Contains(0), "ConcurrentDictionary::Extract returns and removes the entry");
+    Check(not dict.Remove(1) and not dict.Extract(1, data), "ConcurrentDictionary::Remove and Extract fail for missing keys");
+    dict.Destroy();
+    Check((dict.Size() == 0) and not dict.Contains(2), "ConcurrentDictionary is empty after Destroy");
+}
+
+// =================================================================================================
+// Same scheme for ShardedDictionary; readers additionally run the merging Walk, which locks all
+// shards and therefore must see every shard in a consistent state.
+
+static void TestShardedDictionary(int writerCount, int readerCount, int n)
+{
+    ShardedDictionary<int, int> dict(8);
+    dict.SetComparator(CompareInts);
+    int total = writerCount * n;
+    std::atomic<int> activeWriters(writerCount);
+    std::atomic<bool> findsOk(true), walksOk(true);
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writerCount; w++)
+        threads.emplace_back([&, w]() {
+            std::vector<int> keys;
+            for (int i = 0; i < n; i++)
+                keys.push_back(i * writerCount + w);
+            std::shuffle(keys.begin(), keys.end(), std::mt19937(w));
+            for (int key : keys)
+                dict.Insert(key, 2 * key);
+            for (int key : keys)
+                if (key & 1)
+                    dict.Remove(key);
+            activeWriters--;
+        });
+    for (int r = 0; r < readerCount; r++)
+        threads.emplace_back([&, r]() {
+            std::mt19937 rng(100 + r);
+            for (int i = 0; activeWriters.load() > 0; i++) {
+                int key = int(rng() % total), data = -1;
+                if (dict.Find(key, data) and (data != 2 * key))
+                    findsOk = false;
+                if (i % 1000 == 999) {
+                    WalkState state;
+                    dict.Walk(CheckEntry, &state);
+                    if (not (state.isSorted and state.isConsistent))
+                        walksOk = false;
+                    std::this_thread::yield();
+                }
+            }
+        });
+    for (auto& t : threads)
+        t.join();
+
+    Check(dict.ShardCount() == 8, "ShardedDictionary uses the requested number of shards");
+    Check(findsOk, "ShardedDictionary::Find never returns a partially updated entry");
+    Check(walksOk, "ShardedDictionary::Walk merges the shards in key order while writers run");
+    Check(dict.Size() == (total + 1) / 2, "ShardedDictionary::Size counts the remaining entries");
+    bool contentsOk = true;
+    for (int key = 0; key < total; key++) {
+        int data = -1;
+        if (dict.Find(key, data) != not (key & 1))
+            contentsOk = false;
+        else if (not (key & 1) and (data != 2 * key))
+            contentsOk = false;
+    }
+    Check(contentsOk, "ShardedDictionary holds exactly the even keys");
+
+    WalkState state;
+    dict.Walk(CheckEntry, &state);
+    Check(state.isSorted and (state.count == dict.Size()), "ShardedDictionary::Walk visits all entries in order");
+    // the keys are spread over the shards, so visiting the shards one after the other is not sorted
+    WalkState shardState;
+    dict.WalkShards(CheckEntry, &shardState);
+    Check(not shardState.isSorted and (shardState.count == dict.Size()), "ShardedDictionary::WalkShards visits all shards");
+
+    int data = -1;
+    Check(dict.Extract(0, data) and (data == 0) and not dict.Find(0, data), "ShardedDictionary::Extract returns and removes the entry");
+    Check(not dict.Remove(1) and not dict.Extract(1, data), "ShardedDictionary::Remove and Extract fail for missing keys");
+    dict.Destroy();
+    Check(dict.Size() == 0, "ShardedDictionary is empty after Destroy");
+
+    ShardedDictionary<int, int> rounded(5);
+    Check(rounded.ShardCount() == 8, "ShardedDictionary rounds the shard count up to a power of two");
+}
+
+//-----------------------------------------------------------------------------
+// All threads increment the same few counters through Modify; no increment may get lost.
+
+static void TestShardedCounters(int threadCount, int counterCount, int n)
+{
+    ShardedDictionary<int, int> counters(4);
+    counters.SetComparator(CompareInts);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++)
+        threads.emplace_back([&counters, counterCount, n, t]() {
+            for (int i = 0; i < n; i++)
+                counters.Modify((i + t) % counterCount, [](int& count) { count++; });
+        });
+    for (auto& t : threads)
+        t.join();
+
+    bool countsOk = true;
+    int sum = 0;
+    for (int key = 0; key < counterCount; key++) {
+        int count = 0;
+        counters.Find(key, count);
+        int expected = 0;
+        for (int t = 0; t < threadCount; t++)
+            expected += (n + counterCount - 1 - (key - t % counterCount + counterCount) % counterCount) / counterCount;
+        if (count != expected)
+            countsOk = false;
+        sum += count;
+    }
+    Check(countsOk and (sum == threadCount * n), "ShardedDictionary::Modify doesn't lose concurrent increments");
+    Check(counters.Size() == counterCount, "ShardedDictionary::Modify inserts each counter once");
+    Check(not counters.Modify(counterCount, [](int& count) { count++; }, false) and (counters.Size() == counterCount),
+          "ShardedDictionary::Modify doesn't insert missing entries unless asked to");
+}
+
+// =================================================================================================
+
+int main(int argc, char** argv)
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 20000;
+    TestConcurrentDictionary(4, 2, n);
+    TestConcurrentDictionary(1, 1, n);
+    TestShardedDictionary(4, 2, n);
+    TestShardedCounters(4, 13, n);
+    fprintf(stderr, "%s\n", failures ? "dictionary_test failed" : "dictionary_test passed");
+    return failures ? 1 : 0;
+}
+
+// =================================================================================================
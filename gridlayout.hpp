@@ -0,0 +1,242 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+#pragma once
+
+#include <algorithm>
+#include <stdint.h>
+
+// =================================================================================================
+// Order in which a width x height grid stores its cells, and the mapping of cell (x, y) to an item
+// index. Row major storage keeps rows contiguous, so walking down a column or over a neighbourhood
+// of a big grid touches a new cache line (and page) for every row. The tiled orders split the grid
+// into square tiles of 2^tileShift cells per side that are stored one after the other, row by row
+// of tiles, so cells that are close in both directions are close in memory:
+// - Tiled stores the cells of a tile row by row,
+// - Morton stores the cells of a tile in Z order (interleaving the bits of x and y), which keeps
+//   the sub-squares of a tile together as well. The tiles themselves are still stored row by row.
+// Tiles along the right and bottom border are padded to full size, so a tiled grid holds Size()
+// items, which can be somewhat more than width * height. The padding items hold no cells;
+// ForEachRun skips them.
+
+enum class GridOrder : uint8_t {
+	RowMajor,
+	Tiled,
+	Morton
+};
+
+
+// a rectangle [x0, x1) x [y0, y1) of grid cells; offset is the index of its first item if the
+// grid is tiled, -1 otherwise
+class GridTile {
+public:
+	int32_t	x0, y0, x1, y1;
+	int32_t	offset;
+
+	inline int32_t Width(void) const {
+		return x1 - x0;
+	}
+
+	inline int32_t Height(void) const {
+		return y1 - y0;
+	}
+};
+
+// -------------------------------------------------------------------------------------------------
+
+class GridLayout {
+public:
+	static constexpr int32_t defaultTileShift = 3; // 8 x 8 cells
+	static constexpr int32_t maxTileShift = 8;
+
+	GridOrder	order;
+	int32_t		tileShift;
+	int32_t		width;
+	int32_t		height;
+	int32_t		tilesPerRow;
+	int32_t		tilesPerColumn;
+
+public:
+	GridLayout(GridOrder _order = GridOrder::RowMajor, int32_t _tileShift = defaultTileShift)
+		: order(_order), tileShift(std::clamp(_tileShift, 0, maxTileShift)), width(0), height(0), tilesPerRow(0), tilesPerColumn(0)
+	{
+	}
+
+
+	void Resize(int32_t _width, int32_t _height) {
+		width = std::max(_width, 0);
+		height = std::max(_height, 0);
+		tilesPerRow = (width + TileSize() - 1) >> tileShift;
+		tilesPerColumn = (height + TileSize() - 1) >> tileShift;
+	}
+
+
+	inline int32_t TileSize(void) const {
+		return 1 << tileShift;
+	}
+
+
+	inline int32_t TileCount(void) const {
+		return tilesPerRow * tilesPerColumn;
+	}
+
+
+	inline bool IsTiled(void) const {
+		return order != GridOrder::RowMajor;
+	}
+
+
+	// true if an array of length items holds all cells of the grid
+	inline bool HoldsGrid(int32_t length) const {
+		return (width * height > 0) and (length >= Size());
+	}
+
+
+	inline bool operator==(const GridLayout& other) const {
+		return (order == other.order) and (width == other.width) and (height == other.height) and (not IsTiled() or (tileShift == other.tileShift));
+	}
+
+
+	// number of items needed to store the grid, including the padding of border tiles
+	inline int32_t Size(void) const {
+		return IsTiled() ? TileCount() << (2 * tileShift) : width * height;
+	}
+
+
+	inline int32_t Index(int32_t x, int32_t y) const {
+		if (order == GridOrder::RowMajor)
+			return y * width + x;
+		int32_t mask = TileSize() - 1;
+		int32_t tile = ((y >> tileShift) * tilesPerRow + (x >> tileShift)) << (2 * tileShift);
+		if (order == GridOrder::Tiled)
+			return tile + ((y & mask) << tileShift) + (x & mask);
+		return tile + int32_t(SpreadBits(uint32_t(x & mask)) | (SpreadBits(uint32_t(y & mask)) << 1));
+	}
+
+
+	// tile i, counting row by row; tiles along the right and bottom border are clipped to the grid
+	GridTile Tile(int32_t i) const {
+		int32_t x = (i % tilesPerRow) << tileShift;
+		int32_t y = (i / tilesPerRow) << tileShift;
+		return GridTile{ x, y, std::min(x + TileSize(), width), std::min(y + TileSize(), height), IsTiled() ? i << (2 * tileShift) : -1 };
+	}
+
+
+	// index of the first item of the cells [tile.x0, tile.x1) in row y, which are contiguous unless
+	// the grid has Morton order (-1 then)
+	inline int32_t RowIndex(const GridTile& tile, int32_t y) const {
+		if (order == GridOrder::Morton)
+			return -1;
+		return (order == GridOrder::Tiled) ? tile.offset + ((y - tile.y0) << tileShift) : y * width + tile.x0;
+	}
+
+
+	// calls run(index, count) for each run of consecutive items of an array of length items that
+	// hold grid cells or items beyond the grid, in storage order, skipping the padding of border
+	// tiles. Stops as soon as run returns false and returns false then. Arrays that don't hold a
+	// tiled grid are one run.
+	template <typename RUN_T>
+	bool ForEachRun(int32_t length, RUN_T run) const {
+		if (not IsTiled() or not HoldsGrid(length))
+			return (length <= 0) or run(0, length);
+		int32_t tileCells = 1 << (2 * tileShift);
+		for (int32_t i = 0, n = TileCount(); i < n; i++) {
+			GridTile tile = Tile(i);
+			if ((tile.Width() == TileSize()) and (tile.Height() == TileSize())) {
+				if (not run(tile.offset, tileCells))
+					return false;
+			}
+			else if (order == GridOrder::Tiled) {
+				for (int32_t y = tile.y0; y < tile.y1; y++)
+					if (not run(RowIndex(tile, y), tile.Width()))
+						return false;
+			}
+			else { // Z order: join consecutive cells inside the grid
+				for (int32_t j = 0, start = -1; j <= tileCells; j++) {
+					bool inside = (j < tileCells) and (CompactBits(uint32_t(j)) < uint32_t(tile.Width())) and (CompactBits(uint32_t(j) >> 1) < uint32_t(tile.Height()));
+					if (inside) {
+						if (start < 0)
+							start = j;
+					}
+					else if (start >= 0) {
+						if (not run(tile.offset + start, j - start))
+							return false;
+						start = -1;
+					}
+				}
+			}
+		}
+		return (length == Size()) or run(Size(), length - Size());
+	}
+
+private:
+	// move the lower 8 bits of v to the even bit positions
+	static inline uint32_t SpreadBits(uint32_t v) {
+		v = (v | (v << 4)) & 0x0F0F;
+		v = (v | (v << 2)) & 0x3333;
+		return (v | (v << 1)) & 0x5555;
+	}
+
+
+	// move the even bits of the lower 16 bits of v to the lower 8 bits (the inverse of SpreadBits)
+	static inline uint32_t CompactBits(uint32_t v) {
+		v &= 0x5555;
+		v = (v | (v >> 1)) & 0x3333;
+		v = (v | (v >> 2)) & 0x0F0F;
+		return (v | (v >> 4)) & 0x00FF;
+	}
+};
+
+// -------------------------------------------------------------------------------------------------
+// Iterates over the tiles of a grid in storage order, e.g.
+//   for (GridTile tile : grid.Tiles())
+//       for (int32_t y = tile.y0; y < tile.y1; y++)
+//           for (int32_t x = tile.x0; x < tile.x1; x++)
+//               ... grid(x, y) ...
+// Grids in row major order are iterated in blocks of the layout's tile size as well, which gives
+// stencil passes over them the same locality.
+
+class GridTiles {
+private:
+	const GridLayout*	m_layout;
+
+public:
+	class Iterator {
+	private:
+		const GridLayout*	m_layout;
+		int32_t				m_tile;
+
+	public:
+		Iterator(const GridLayout* layout, int32_t tile) : m_layout(layout), m_tile(tile) {}
+
+		inline GridTile operator*() const {
+			return m_layout->Tile(m_tile);
+		}
+
+		inline Iterator& operator++() {
+			++m_tile;
+			return *this;
+		}
+
+		inline bool operator==(const Iterator& other) const {
+			return m_tile == other.m_tile;
+		}
+
+		inline bool operator!=(const Iterator& other) const {
+			return m_tile != other.m_tile;
+		}
+	};
+
+	explicit GridTiles(const GridLayout& layout) : m_layout(&layout) {}
+
+	inline Iterator begin() const {
+		return Iterator(m_layout, 0);
+	}
+
+	inline Iterator end() const {
+		return Iterator(m_layout, m_layout->TileCount());
+	}
+};
+
+// =================================================================================================
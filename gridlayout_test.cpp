@@ -0,0 +1,165 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Checks grids stored in row major, tiled and Morton order (see gridlayout.hpp): cells keep their
+// values when the order changes, tiles cover every cell once, copies keep the layout, and Fill,
+// Find, MinMax, Sum and operator== ignore the padding of border tiles. Returns 0 if all checks
+// pass. Build e.g. with:
+//   c++ -O2 -std=c++20 gridlayout_test.cpp
+
+#include <vector>
+#include <cstdio>
+
+#include "array.hpp"
+
+// =================================================================================================
+
+static int failures = 0;
+
+static const char* orderNames[] = { "row major", "tiled", "Morton" };
+
+static bool Check(bool condition, const char* what, GridOrder order, int32_t tileShift, int32_t width, int32_t height) {
+    if (not condition) {
+        fprintf(stderr, "FAILED: %s (%s, tile shift %d, %d x %d)\n", what, orderNames[int(order)], tileShift, width, height);
+        ++failures;
+    }
+    return condition;
+}
+
+//-----------------------------------------------------------------------------
+
+// the custom ManagedArray returns a pointer to cell (x, y), the std::vector based one a reference
+static inline int& Cell(int* cell) {
+    return *cell;
+}
+
+static inline int& Cell(int& cell) {
+    return cell;
+}
+
+static inline int Value(int32_t x, int32_t y) {
+    return y * 1000 + x;
+}
+
+//-----------------------------------------------------------------------------
+
+static bool HasCells(ManagedArray<int>& a, int32_t width, int32_t height)
+{
+    for (int32_t y = 0; y < height; y++)
+        for (int32_t x = 0; x < width; x++)
+            if (Cell(a(x, y)) != Value(x, y))
+                return false;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestLayout(GridOrder order, int32_t tileShift, int32_t width, int32_t height)
+{
+    ManagedArray<int> a;
+    a.Resize(width, height);
+    for (int32_t y = 0; y < height; y++)
+        for (int32_t x = 0; x < width; x++)
+            Cell(a(x, y)) = Value(x, y);
+    Check(a.SetLayout(order, tileShift) and (a.Layout().order == order) and (a.Length() == a.Layout().Size()), "SetLayout", order, tileShift, width, height);
+    Check(HasCells(a, width, height), "cells keep their values", order, tileShift, width, height);
+
+    std::vector<int> seen(width * height, 0);
+    bool rowsOk = true;
+    for (GridTile tile : a.Tiles())
+        for (int32_t y = tile.y0; y < tile.y1; y++) {
+            int* row = a.TileRow(tile, y);
+            rowsOk = rowsOk and ((row == nullptr) == (order == GridOrder::Morton));
+            for (int32_t x = tile.x0; x < tile.x1; x++) {
+                seen[y * width + x]++;
+                rowsOk = rowsOk and (not row or (row[x - tile.x0] == Value(x, y)));
+            }
+        }
+    bool once = true;
+    for (int n : seen)
+        once = once and (n == 1);
+    Check(once, "tiles cover every cell once", order, tileShift, width, height);
+    Check(rowsOk, "TileRow", order, tileShift, width, height);
+    Check((a.DataRow(0) == nullptr) == (order != GridOrder::RowMajor), "DataRow", order, tileShift, width, height);
+#if !(USE_STD || USE_STD_VECTOR)
+    Check((a.GetCheckedIndex(width - 1, height - 1) >= 0) and (a.GetCheckedIndex(width, 0) < 0), "GetCheckedIndex", order, tileShift, width, height);
+#endif
+
+    ManagedArray<int> b(a);
+    Check((b.Layout().order == order) and HasCells(b, width, height), "copies keep the layout", order, tileShift, width, height);
+    a.SetLayout(GridOrder::RowMajor);
+    Check((a.Length() == width * height) and HasCells(a, width, height), "back to row major", order, tileShift, width, height);
+    bool rowMajor = true;
+    for (int32_t i = 0; i < width * height; i++)
+        rowMajor = rowMajor and (a.Data()[i] == Value(i % width, i / width));
+    Check(rowMajor, "row major storage", order, tileShift, width, height);
+}
+
+//-----------------------------------------------------------------------------
+
+// the padding of border tiles holds no cells: whatever it contains must not show up in the results
+static void TestPadding(GridOrder order, int32_t tileShift, int32_t width, int32_t height)
+{
+    ManagedArray<int> a;
+    a.Resize(width, height);
+    a.Fill(1);
+    a.SetLayout(order, tileShift);
+    for (int32_t i = 0; i < a.Length(); i++)
+        a.Data()[i] = -7;
+    a.Fill(1);
+    Check((a.Sum() == width * height) and (a.Min() == 1) and (a.Max() == 1) and (a.Find(-7) == -1), "Fill, Sum, MinMax and Find skip the padding", order, tileShift, width, height);
+
+    int32_t cells = 0, last = -1;
+    bool runsOk = true;
+    a.Layout().ForEachRun(a.Length(), [&](int32_t i, int32_t n) {
+        runsOk = runsOk and (i > last) and (n > 0);
+        for (last = i + n - 1; n; n--, i++, cells++)
+            runsOk = runsOk and (a.Data()[i] == 1);
+        return true;
+    });
+    Check(runsOk and (cells == width * height), "ForEachRun visits the cells once, in storage order", order, tileShift, width, height);
+
+    Cell(a(width - 1, height - 1)) = 5;
+    Cell(a(width / 2, 0)) = 5;
+    int64_t sum = 0;
+    for (int32_t y = 0; y < height; y++)
+        for (int32_t x = 0; x < width; x++)
+            sum += Cell(a(x, y));
+    int32_t first = a.Find(5);
+    Check((first >= 0) and (a.Data()[first] == 5) and (a.Max() == 5) and (a.Sum() == sum), "Find, Max and Sum of cells", order, tileShift, width, height);
+    for (int32_t i = 0; i < first; i++)
+        if (a.Data()[i] == 5)
+            Check(false, "Find returns the first cell in storage order", order, tileShift, width, height);
+
+    ManagedArray<int> b(a), rowMajor(a);
+    for (int32_t i = 0; i < b.Length(); i++)
+        if (b.Data()[i] == -7)
+            b.Data()[i] = 99;
+    rowMajor.SetLayout(GridOrder::RowMajor);
+    Check((a == b) and (b == a) and (a == rowMajor) and (rowMajor == a), "operator== compares cells only", order, tileShift, width, height);
+    Cell(b(0, height - 1)) = 3;
+    Check((a != b) and (b != rowMajor), "operator== finds different cells", order, tileShift, width, height);
+}
+
+// =================================================================================================
+
+int main()
+{
+    for (GridOrder order : { GridOrder::RowMajor, GridOrder::Tiled, GridOrder::Morton })
+        for (int32_t tileShift : { 0, 2, 3 })
+            for (auto [width, height] : { std::pair<int32_t, int32_t>(13, 7), { 16, 16 }, { 10, 10 }, { 1, 1 }, { 3, 40 } }) {
+                TestLayout(order, tileShift, width, height);
+                TestPadding(order, tileShift, width, height);
+            }
+
+    // a layout chosen before the grid size is known
+    ManagedArray<int> a;
+    a.SetLayout(GridOrder::Tiled, 2);
+    a.Resize(5, 5);
+    Check(a.Length() == 64, "Resize allocates the padded size", GridOrder::Tiled, 2, 5, 5);
+    fprintf(stderr, "%s\n", failures ? "gridlayout_test failed" : "gridlayout_test passed");
+    return failures ? 1 : 0;
+}
+
+// =================================================================================================
@@ -0,0 +1,36 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+#pragma once
+
+#include <type_traits>
+
+#include <stddef.h>
+
+// =================================================================================================
+// Conversion between an item and a hook (a link) embedded in it, for containers that chain items
+// through such hooks (IntrusiveList, IntrusiveMPSCQueue). The containers take the offset of the
+// hook in the item as template argument, e.g.
+//   struct Task { IntrusiveListHook m_link; ... };
+//   IntrusiveList<Task, offsetof(Task, m_link)> tasks;
+// offsetof is well defined for standard layout items (compilers support it for other types
+// without virtual bases as well), and hooks must be standard layout themselves, so the address
+// of a hook is always the address of its item plus that offset.
+
+template <typename ITEM_T, typename HOOK_T, size_t HOOK_OFFSET>
+struct IntrusiveHook {
+	static inline ITEM_T* Item(HOOK_T* hook) {
+		static_assert(std::is_standard_layout_v<HOOK_T>, "hooks must be standard layout types");
+		static_assert(HOOK_OFFSET + sizeof(HOOK_T) <= sizeof(ITEM_T), "the hook offset lies outside of the item");
+		return reinterpret_cast<ITEM_T*>(reinterpret_cast<char*>(hook) - HOOK_OFFSET);
+	}
+
+	static inline HOOK_T* Hook(ITEM_T* item) {
+		static_assert(std::is_standard_layout_v<HOOK_T>, "hooks must be standard layout types");
+		static_assert(HOOK_OFFSET + sizeof(HOOK_T) <= sizeof(ITEM_T), "the hook offset lies outside of the item");
+		return reinterpret_cast<HOOK_T*>(reinterpret_cast<char*>(item) + HOOK_OFFSET);
+	}
+};
+
+// =================================================================================================
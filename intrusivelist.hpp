@@ -0,0 +1,303 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+#pragma once
+
+#include <utility>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "intrusivehook.hpp"
+
+// =================================================================================================
+// Doubly linked list whose links live in the items themselves: each item embeds an IntrusiveListHook
+// per list it can be a member of, and the list is told the hook's offset in the item (see
+// intrusivehook.hpp), e.g. IntrusiveList<Task, offsetof(Task, m_link)>. Linking and unlinking items
+// doesn't allocate anything, and an item can be removed in O(1) without searching for it. The list
+// doesn't own its items; they must stay alive while they are linked, and an item can only be in one
+// list per hook at a time.
+// The list is circular around a sentinel hook embedded in the list.
+
+struct IntrusiveListHook {
+	IntrusiveListHook*	m_pred;
+	IntrusiveListHook*	m_succ;
+
+	IntrusiveListHook() : m_pred(nullptr), m_succ(nullptr) {}
+
+	// items are copied without their list membership
+	IntrusiveListHook(const IntrusiveListHook&) : m_pred(nullptr), m_succ(nullptr) {}
+
+	IntrusiveListHook& operator=(const IntrusiveListHook&) {
+		return *this;
+	}
+
+	inline bool IsLinked(void) const {
+		return m_succ != nullptr;
+	}
+};
+
+//-----------------------------------------------------------------------------
+
+template <typename ITEM_T, size_t HOOK_OFFSET>
+class IntrusiveList {
+private:
+	IntrusiveListHook	m_head;
+	int32_t				m_length;
+
+	static inline ITEM_T* Item(IntrusiveListHook* hook) {
+		return IntrusiveHook<ITEM_T, IntrusiveListHook, HOOK_OFFSET>::Item(hook);
+	}
+
+	static inline IntrusiveListHook* Hook(ITEM_T* item) {
+		return IntrusiveHook<ITEM_T, IntrusiveListHook, HOOK_OFFSET>::Hook(item);
+	}
+
+	inline ITEM_T* ItemOrNull(IntrusiveListHook* hook) const {
+		return (hook == &m_head) ? nullptr : Item(hook);
+	}
+
+	// link hook in front of succ
+	inline void Link(IntrusiveListHook* hook, IntrusiveListHook* succ) {
+		hook->m_succ = succ;
+		hook->m_pred = succ->m_pred;
+		succ->m_pred->m_succ = hook;
+		succ->m_pred = hook;
+		m_length++;
+	}
+
+	inline void Unlink(IntrusiveListHook* hook) {
+		hook->m_pred->m_succ = hook->m_succ;
+		hook->m_succ->m_pred = hook->m_pred;
+		hook->m_pred =
+		hook->m_succ = nullptr;
+		m_length--;
+	}
+
+	//----------------------------------------
+
+public:
+	class Iterator {
+	private:
+		IntrusiveListHook*	m_current;
+
+	public:
+		explicit Iterator(IntrusiveListHook* current) : m_current(current) {}
+
+		ITEM_T& operator*() {
+			return *Item(m_current);
+		}
+
+		ITEM_T* operator->() {
+			return Item(m_current);
+		}
+
+		// the current item may be removed from the list after the iterator has moved past it
+		inline Iterator& operator++() {
+			m_current = m_current->m_succ;
+			return *this;
+		}
+
+		inline Iterator& operator--() {
+			m_current = m_current->m_pred;
+			return *this;
+		}
+
+		bool operator==(const Iterator& other) const {
+			return m_current == other.m_current;
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return m_current != other.m_current;
+		}
+	};
+
+	//----------------------------------------
+
+public:
+	IntrusiveList()
+		: m_length(0)
+	{
+		m_head.m_pred =
+		m_head.m_succ = &m_head;
+	}
+
+
+	IntrusiveList(IntrusiveList&& other) noexcept
+		: IntrusiveList()
+	{
+		*this += std::move(other);
+	}
+
+
+	IntrusiveList(const IntrusiveList&) = delete;
+	IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+
+	IntrusiveList& operator=(IntrusiveList&& other) noexcept {
+		if (&other != this) {
+			Clear();
+			*this += std::move(other);
+		}
+		return *this;
+	}
+
+
+	~IntrusiveList() {
+		Clear();
+	}
+
+
+	// unlink all items
+	void Clear(void) {
+		for (IntrusiveListHook* hook = m_head.m_succ; hook != &m_head; ) {
+			IntrusiveListHook* succ = hook->m_succ;
+			hook->m_pred =
+			hook->m_succ = nullptr;
+			hook = succ;
+		}
+		m_head.m_pred =
+		m_head.m_succ = &m_head;
+		m_length = 0;
+	}
+
+	Iterator begin() const {
+		return Iterator(m_head.m_succ);
+	}
+
+	Iterator end() const {
+		return Iterator(const_cast<IntrusiveListHook*>(&m_head));
+	}
+
+	inline int32_t Length(void) const {
+		return m_length;
+	}
+
+	inline bool IsEmpty(void) const {
+		return m_length == 0;
+	}
+
+	inline ITEM_T* First(void) const {
+		return ItemOrNull(m_head.m_succ);
+	}
+
+	inline ITEM_T* Last(void) const {
+		return ItemOrNull(m_head.m_pred);
+	}
+
+	inline ITEM_T* Succ(ITEM_T* item) const {
+		return ItemOrNull(Hook(item)->m_succ);
+	}
+
+	inline ITEM_T* Pred(ITEM_T* item) const {
+		return ItemOrNull(Hook(item)->m_pred);
+	}
+
+	// true if item is linked through HOOK; it's up to the caller to know which list that is
+	static inline bool IsLinked(ITEM_T* item) {
+		return Hook(item)->IsLinked();
+	}
+
+	//-----------------------------------------------------------------------------
+	// Items must not be linked through HOOK already.
+
+public:
+	inline ITEM_T* Append(ITEM_T* item) {
+		Link(Hook(item), &m_head);
+		return item;
+	}
+
+	inline ITEM_T* Prepend(ITEM_T* item) {
+		Link(Hook(item), m_head.m_succ);
+		return item;
+	}
+
+	inline ITEM_T* InsertBefore(ITEM_T* succ, ITEM_T* item) {
+		Link(Hook(item), Hook(succ));
+		return item;
+	}
+
+	inline ITEM_T* InsertAfter(ITEM_T* pred, ITEM_T* item) {
+		Link(Hook(item), Hook(pred)->m_succ);
+		return item;
+	}
+
+	// O(n)
+	ITEM_T* Insert(int i, ITEM_T* item) {
+		if (i < 0)
+			i += m_length + 1;
+		if ((i < 0) or (i > m_length))
+			return nullptr;
+		IntrusiveListHook* succ = m_head.m_succ;
+		for (; i; i--)
+			succ = succ->m_succ;
+		Link(Hook(item), succ);
+		return item;
+	}
+
+	//-----------------------------------------------------------------------------
+	// item must be a member of this list
+
+public:
+	inline ITEM_T* Remove(ITEM_T* item) {
+		Unlink(Hook(item));
+		return item;
+	}
+
+	inline ITEM_T* ExtractFirst(void) {
+		return IsEmpty() ? nullptr : Remove(Item(m_head.m_succ));
+	}
+
+	inline ITEM_T* ExtractLast(void) {
+		return IsEmpty() ? nullptr : Remove(Item(m_head.m_pred));
+	}
+
+	// O(n)
+	ITEM_T* Extract(int i) {
+		if (i < 0)
+			i += m_length;
+		if ((i < 0) or (i >= m_length))
+			return nullptr;
+		IntrusiveListHook* hook = m_head.m_succ;
+		for (; i; i--)
+			hook = hook->m_succ;
+		return Remove(Item(hook));
+	}
+
+	// remove all items for which filter returns true
+	template<typename FILTER_T>
+	int32_t Filter(FILTER_T filter) {
+		int32_t deleted = 0;
+		for (IntrusiveListHook* hook = m_head.m_succ; hook != &m_head; ) {
+			IntrusiveListHook* succ = hook->m_succ;
+			if (filter(*Item(hook))) {
+				Unlink(hook);
+				deleted++;
+			}
+			hook = succ;
+		}
+		return deleted;
+	}
+
+	//-----------------------------------------------------------------------------
+	// move all items of other to the end of this list in O(1); will leave other empty
+
+public:
+	IntrusiveList& operator+= (IntrusiveList&& other) {
+		if (other.IsEmpty() or (&other == this))
+			return *this;
+		IntrusiveListHook* first = other.m_head.m_succ, * last = other.m_head.m_pred;
+		first->m_pred = m_head.m_pred;
+		m_head.m_pred->m_succ = first;
+		last->m_succ = &m_head;
+		m_head.m_pred = last;
+		m_length += other.m_length;
+		other.m_head.m_pred =
+		other.m_head.m_succ = &other.m_head;
+		other.m_length = 0;
+		return *this;
+	}
+};
+
+// =================================================================================================
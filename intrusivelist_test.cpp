@@ -0,0 +1,228 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Checks IntrusiveList against std::vector: random inserts at both ends, next to other items and at
+// indices, removals, extractions, filters, splices with operator+= and moves, with every item being
+// a member of two lists through two hooks at the same time. Changing one list must never affect the
+// other one, and IsLinked must track the membership of each item.
+// Returns 0 if all checks pass. Build e.g. with:
+//   c++ -O2 -std=c++20 intrusivelist_test.cpp
+
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <cstddef>
+#include <algorithm>
+
+#include "intrusivelist.hpp"
+
+// =================================================================================================
+
+static int failures = 0;
+
+static bool Check(bool condition, const char* what, const char* list) {
+    if (not condition) {
+        fprintf(stderr, "FAILED: %s (%s)\n", what, list);
+        ++failures;
+    }
+    return condition;
+}
+
+//-----------------------------------------------------------------------------
+
+struct Task {
+    int                 m_id;
+    IntrusiveListHook   m_queueLink;
+    int                 m_priority;
+    IntrusiveListHook   m_allLink; // neither hook is the first member, so the offsets matter
+};
+
+using TaskQueue = IntrusiveList<Task, offsetof(Task, m_queueLink)>;
+using TaskList = IntrusiveList<Task, offsetof(Task, m_allLink)>;
+
+//-----------------------------------------------------------------------------
+
+template <typename LIST_T>
+static bool Matches(const LIST_T& l, const std::vector<Task*>& v, const std::vector<Task>& tasks) {
+    if ((l.Length() != int32_t(v.size())) or (l.IsEmpty() != v.empty()))
+        return false;
+    if ((l.First() != (v.empty() ? nullptr : v.front())) or (l.Last() != (v.empty() ? nullptr : v.back())))
+        return false;
+    size_t i = 0;
+    for (auto& t : l)
+        if ((i == v.size()) or (&t != v[i++]))
+            return false;
+    auto it = l.end();
+    for (size_t j = v.size(); j; ) {
+        --it;
+        if (&*it != v[--j])
+            return false;
+    }
+    int32_t linked = 0;
+    for (auto& t : tasks)
+        if (LIST_T::IsLinked(const_cast<Task*>(&t)))
+            linked++;
+    return linked == l.Length();
+}
+
+
+// returns an item that isn't linked through the list's hook, or nullptr if all are
+template <typename LIST_T>
+static Task* UnlinkedTask(std::vector<Task>& tasks, std::mt19937& rng) {
+    size_t n = tasks.size();
+    for (size_t i = rng() % n, k = 0; k < n; i = (i + 1) % n, k++)
+        if (not LIST_T::IsLinked(&tasks[i]))
+            return &tasks[i];
+    return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+
+template <typename LIST_T>
+static bool RandomStep(LIST_T& l, std::vector<Task*>& v, std::vector<Task>& tasks, std::mt19937& rng, const char* name)
+{
+    int op = rng() % 10, n = int(v.size());
+    if (op < 4) {
+        Task* t = UnlinkedTask<LIST_T>(tasks, rng);
+        if (not t)
+            return true;
+        int variant = rng() % 5;
+        if (not n or (variant == 0)) {
+            l.Append(t);
+            v.push_back(t);
+        }
+        else if (variant == 1) {
+            l.Prepend(t);
+            v.insert(v.begin(), t);
+        }
+        else if (variant == 2) {
+            int j = rng() % n;
+            l.InsertBefore(v[j], t);
+            v.insert(v.begin() + j, t);
+        }
+        else if (variant == 3) {
+            int j = rng() % n;
+            l.InsertAfter(v[j], t);
+            v.insert(v.begin() + j + 1, t);
+        }
+        else {
+            int i = rng() % (n + 1);
+            // negative indices count from the end, -1 appends
+            if (not Check(l.Insert((rng() & 1) ? i : i - n - 1, t) == t, "Insert", name))
+                return false;
+            v.insert(v.begin() + i, t);
+        }
+    }
+    else if ((op < 7) and n) {
+        int variant = rng() % 4, j = rng() % n;
+        Task* t = (variant == 1) ? v.front() : (variant == 2) ? v.back() : v[j];
+        Task* removed = (variant == 0) ? l.Remove(t)
+                      : (variant == 1) ? l.ExtractFirst()
+                      : (variant == 2) ? l.ExtractLast()
+                      : l.Extract((rng() & 1) ? j : j - n);
+        if (not Check((removed == t) and not LIST_T::IsLinked(t), "Remove and Extract", name))
+            return false;
+        v.erase(std::find(v.begin(), v.end(), t));
+    }
+    else if ((op == 7) and n) {
+        int j = rng() % n;
+        if (not Check((l.Pred(v[j]) == (j ? v[j - 1] : nullptr)) and (l.Succ(v[j]) == ((j < n - 1) ? v[j + 1] : nullptr)), "Pred and Succ", name))
+            return false;
+        if (not Check((l.Insert(n + 1, v[j]) == nullptr) and (l.Extract(n) == nullptr) and (l.Extract(-n - 1) == nullptr), "index range checks", name))
+            return false;
+    }
+    else if (op == 8) {
+        // splice a list of fresh items onto the end
+        LIST_T other;
+        std::vector<Task*> w;
+        for (int k = rng() % 8; k; k--) {
+            Task* t = UnlinkedTask<LIST_T>(tasks, rng);
+            if (not t)
+                break;
+            other.Append(t);
+            w.push_back(t);
+        }
+        l += std::move(other);
+        l += std::move(l);
+        v.insert(v.end(), w.begin(), w.end());
+        if (not Check(other.IsEmpty() and (other.begin() == other.end()), "operator+= empties the source", name))
+            return false;
+    }
+    else if (rng() % 20 == 0) {
+        int r = rng() % 3;
+        int32_t removed = l.Filter([r](Task& t) { return t.m_id % 3 == r; });
+        auto last = std::remove_if(v.begin(), v.end(), [r](Task* t) { return t->m_id % 3 == r; });
+        int32_t expected = int32_t(v.end() - last);
+        v.erase(last, v.end());
+        if (not Check(removed == expected, "Filter result", name))
+            return false;
+    }
+    else if (rng() % 20 == 0) {
+        LIST_T moved(std::move(l));
+        if (not Check(l.IsEmpty() and Matches(moved, v, tasks), "move construction", name))
+            return false;
+        l = std::move(moved);
+        if (not Check(moved.IsEmpty() and (moved.First() == nullptr), "move assignment empties the source", name))
+            return false;
+    }
+    return Check(Matches(l, v, tasks), "list contents", name);
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestRandomOps(unsigned int seed, int taskCount)
+{
+    std::mt19937 rng(seed);
+    std::vector<Task> tasks(taskCount);
+    for (int i = 0; i < taskCount; i++) {
+        tasks[i].m_id = i;
+        tasks[i].m_priority = i % 7;
+    }
+    {
+        TaskQueue queue;
+        TaskList all;
+        std::vector<Task*> q, a;
+        for (int step = 0; step < 20000; step++) {
+            bool ok = (rng() & 1) ? RandomStep(queue, q, tasks, rng, "queue hook") : RandomStep(all, a, tasks, rng, "list hook");
+            // the list that wasn't touched must still be intact
+            if (not (ok and Check(Matches(queue, q, tasks) and Matches(all, a, tasks), "lists are independent", "both hooks")))
+                return;
+        }
+        queue.Clear();
+        Check(queue.IsEmpty() and Matches(all, a, tasks), "Clear unlinks only its own hooks", "queue hook");
+    }
+    bool unlinked = true;
+    for (auto& t : tasks)
+        if (TaskQueue::IsLinked(&t) or TaskList::IsLinked(&t))
+            unlinked = false;
+    Check(unlinked, "destroying a list unlinks its items", "both hooks");
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestCopiedItems(void)
+{
+    Task task{ 1, {}, 0, {} };
+    TaskQueue queue;
+    queue.Append(&task);
+    Task copy = task;
+    Check(not TaskQueue::IsLinked(&copy) and (queue.Length() == 1), "copies of an item are not linked", "queue hook");
+    copy = task;
+    Check(not TaskQueue::IsLinked(&copy), "assigning an item keeps the target's membership", "queue hook");
+    queue.Append(&copy);
+    Check((queue.First() == &task) and (queue.Last() == &copy), "copies can be linked separately", "queue hook");
+}
+
+// =================================================================================================
+
+int main(void)
+{
+    TestRandomOps(1, 16);
+    TestRandomOps(2, 200);
+    TestCopiedItems();
+    fprintf(stderr, "%s\n", failures ? "intrusivelist_test failed" : "intrusivelist_test passed");
+    return failures ? 1 : 0;
+}
+
+// =================================================================================================
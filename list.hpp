@@ -11,3 +11,4 @@
 #endif
 
 #include "segmentedlist.hpp"
+#include "smalllist.hpp"
@@ -0,0 +1,121 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+#pragma once
+
+#include <functional>
+#include <unordered_set>
+
+#include "listindex.hpp"
+
+// =================================================================================================
+// Hash index over the data of the nodes of a linked list, so a node holding a given value can be
+// found in O(1) expected time. The index stores node pointers and hashes and compares them by
+// their data, so values aren't copied into the index. The data of an indexed node must not be
+// changed in place.
+// The list only sees ListHashIndexBase, so the hash and equality operators of its items are only
+// required if an index is actually created.
+
+template <typename NODE_T, typename ITEM_T>
+class ListHashIndexBase {
+public:
+	virtual ~ListHashIndexBase() {}
+
+	virtual bool Add(NODE_T* node) = 0;
+
+	virtual void Remove(NODE_T* node) = 0;
+
+	virtual void Clear(void) = 0;
+
+	// Returns the node holding data. If several nodes hold it, positions (if available) is used to
+	// return the first one in list order; otherwise nullptr is returned and ambiguous is set.
+	virtual NODE_T* Find(const ITEM_T& data, const ListIndex<NODE_T>* positions, bool& ambiguous) const = 0;
+};
+
+//-----------------------------------------------------------------------------
+
+template <typename NODE_T, typename ITEM_T, typename HASH_T = std::hash<ITEM_T>>
+class ListHashIndex : public ListHashIndexBase<NODE_T, ITEM_T> {
+	struct NodeHash {
+		using is_transparent = void;
+
+		HASH_T	m_hash;
+
+		inline size_t operator()(const NODE_T* node) const {
+			return m_hash(node->m_dataItem);
+		}
+
+		inline size_t operator()(const ITEM_T& data) const {
+			return m_hash(data);
+		}
+	};
+
+	struct NodeEqual {
+		using is_transparent = void;
+
+		inline bool operator()(const NODE_T* a, const NODE_T* b) const {
+			return a->m_dataItem == b->m_dataItem;
+		}
+
+		inline bool operator()(const ITEM_T& data, const NODE_T* node) const {
+			return data == node->m_dataItem;
+		}
+
+		inline bool operator()(const NODE_T* node, const ITEM_T& data) const {
+			return node->m_dataItem == data;
+		}
+	};
+
+	using NodeSet = std::unordered_multiset<NODE_T*, NodeHash, NodeEqual>;
+
+	NodeSet	m_nodes;
+
+public:
+	virtual bool Add(NODE_T* node) override {
+		m_nodes.insert(node);
+		return true;
+	}
+
+
+	virtual void Remove(NODE_T* node) override {
+		auto range = m_nodes.equal_range(node);
+		for (auto it = range.first; it != range.second; ++it) {
+			if (*it == node) {
+				m_nodes.erase(it);
+				return;
+			}
+		}
+	}
+
+
+	virtual void Clear(void) override {
+		m_nodes.clear();
+	}
+
+
+	virtual NODE_T* Find(const ITEM_T& data, const ListIndex<NODE_T>* positions, bool& ambiguous) const override {
+		ambiguous = false;
+		auto range = m_nodes.equal_range(data);
+		if (range.first == range.second)
+			return nullptr;
+		NODE_T* node = *range.first;
+		if (++range.first == range.second)
+			return node;
+		if (not positions) {
+			ambiguous = true;
+			return nullptr;
+		}
+		int32_t position = positions->IndexOf(node);
+		for (; range.first != range.second; ++range.first) {
+			int32_t i = positions->IndexOf(*range.first);
+			if (i < position) {
+				position = i;
+				node = *range.first;
+			}
+		}
+		return node;
+	}
+};
+
+// =================================================================================================
@@ -0,0 +1,200 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+#pragma once
+
+#include <new>
+#include <stdint.h>
+
+#include "listnodepool.hpp"
+
+// =================================================================================================
+// Positional index over the nodes of a linked list: an implicit key treap, i.e. a randomized
+// balanced binary tree ordered by list position, where each tree node knows the size of its
+// subtree. Finding the node at a position, adding a node in front of another one and removing a
+// node all take O(log n) expected time.
+// NODE_T must provide a member ListIndexNode<NODE_T>* m_indexNode, which the index maintains.
+
+template <typename NODE_T>
+struct ListIndexNode {
+	ListIndexNode*	m_parent;
+	ListIndexNode*	m_left;
+	ListIndexNode*	m_right;
+	NODE_T*			m_node;
+	int32_t			m_size;
+	uint32_t		m_priority;
+};
+
+//-----------------------------------------------------------------------------
+
+template <typename NODE_T>
+class ListIndex {
+public:
+	using IndexNode = ListIndexNode<NODE_T>;
+
+private:
+	IndexNode*	m_root;
+	uint32_t	m_seed;
+
+	static inline int32_t Size(IndexNode* node) {
+		return node ? node->m_size : 0;
+	}
+
+
+	inline uint32_t Priority(void) { // xorshift32
+		m_seed ^= m_seed << 13;
+		m_seed ^= m_seed >> 17;
+		m_seed ^= m_seed << 5;
+		return m_seed;
+	}
+
+
+	// rotate node up over its parent
+	void RotateUp(IndexNode* node) {
+		IndexNode* parent = node->m_parent;
+		IndexNode* grandParent = parent->m_parent;
+		if (parent->m_left == node) {
+			if ((parent->m_left = node->m_right))
+				parent->m_left->m_parent = parent;
+			node->m_right = parent;
+		}
+		else {
+			if ((parent->m_right = node->m_left))
+				parent->m_right->m_parent = parent;
+			node->m_left = parent;
+		}
+		parent->m_parent = node;
+		node->m_parent = grandParent;
+		if (not grandParent)
+			m_root = node;
+		else if (grandParent->m_left == parent)
+			grandParent->m_left = node;
+		else
+			grandParent->m_right = node;
+		node->m_size = parent->m_size;
+		parent->m_size = Size(parent->m_left) + Size(parent->m_right) + 1;
+	}
+
+public:
+	ListIndex()
+		: m_root(nullptr), m_seed(0x9E3779B9u)
+	{
+	}
+
+
+	~ListIndex() {
+		Clear();
+	}
+
+
+	inline int32_t Size(void) const {
+		return Size(m_root);
+	}
+
+
+	NODE_T* At(int32_t i) const {
+		for (IndexNode* node = m_root; node; ) {
+			int32_t leftSize = Size(node->m_left);
+			if (i < leftSize)
+				node = node->m_left;
+			else if (i == leftSize)
+				return node->m_node;
+			else {
+				i -= leftSize + 1;
+				node = node->m_right;
+			}
+		}
+		return nullptr;
+	}
+
+
+	// position of node in the list; node must be indexed
+	int32_t IndexOf(const NODE_T* node) const {
+		IndexNode* indexNode = node->m_indexNode;
+		int32_t i = Size(indexNode->m_left);
+		for (IndexNode* parent = indexNode->m_parent; parent; indexNode = parent, parent = parent->m_parent) {
+			if (parent->m_right == indexNode)
+				i += Size(parent->m_left) + 1;
+		}
+		return i;
+	}
+
+
+	// add node in front of succ, or at the end if succ is nullptr
+	bool Insert(NODE_T* node, NODE_T* succ) {
+		void* storage = ListNodePool<IndexNode>::Claim();
+		if (not storage)
+			return false;
+		IndexNode* indexNode = new (storage) IndexNode{ nullptr, nullptr, nullptr, node, 1, Priority() };
+		node->m_indexNode = indexNode;
+		IndexNode* parent = succ ? succ->m_indexNode : m_root;
+		if (not parent) {
+			m_root = indexNode;
+			return true;
+		}
+		if (succ and not parent->m_left)
+			parent->m_left = indexNode;
+		else {
+			if (succ)
+				parent = parent->m_left;
+			while (parent->m_right)
+				parent = parent->m_right;
+			parent->m_right = indexNode;
+		}
+		indexNode->m_parent = parent;
+		for (; parent; parent = parent->m_parent)
+			parent->m_size++;
+		while (indexNode->m_parent and (indexNode->m_priority > indexNode->m_parent->m_priority))
+			RotateUp(indexNode);
+		return true;
+	}
+
+
+	void Remove(NODE_T* node) {
+		IndexNode* indexNode = node->m_indexNode;
+		if (not indexNode)
+			return;
+		// rotate the node down to a leaf, keeping the heap order of the priorities
+		while (indexNode->m_left or indexNode->m_right) {
+			IndexNode* left = indexNode->m_left, * right = indexNode->m_right;
+			RotateUp((left and (not right or (left->m_priority > right->m_priority))) ? left : right);
+		}
+		IndexNode* parent = indexNode->m_parent;
+		if (not parent)
+			m_root = nullptr;
+		else if (parent->m_left == indexNode)
+			parent->m_left = nullptr;
+		else
+			parent->m_right = nullptr;
+		for (; parent; parent = parent->m_parent)
+			parent->m_size--;
+		node->m_indexNode = nullptr;
+		ListNodePool<IndexNode>::Release(indexNode);
+	}
+
+
+	void Clear(void) {
+		for (IndexNode* indexNode = m_root; indexNode; ) {
+			if (indexNode->m_left)
+				indexNode = indexNode->m_left;
+			else if (indexNode->m_right)
+				indexNode = indexNode->m_right;
+			else {
+				IndexNode* parent = indexNode->m_parent;
+				if (parent) {
+					if (parent->m_left == indexNode)
+						parent->m_left = nullptr;
+					else
+						parent->m_right = nullptr;
+				}
+				indexNode->m_node->m_indexNode = nullptr;
+				ListNodePool<IndexNode>::Release(indexNode);
+				indexNode = parent;
+			}
+		}
+		m_root = nullptr;
+	}
+};
+
+// =================================================================================================
@@ -0,0 +1,249 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+#pragma once
+
+#include <new>
+#include <mutex>
+#include <algorithm>
+#include <type_traits>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "basicdatapool.hpp"
+
+// =================================================================================================
+// Raw storage for list nodes of one type.
+// Nodes are cut from blocks of growing size (BasicDataPool instances) owned by a pool that all
+// threads share. Released nodes go to a free list and are handed out again before a block is
+// touched, so once a program has reached its peak node count, building and tearing down lists
+// doesn't call the heap allocator any more.
+// Each thread keeps a small cache of free nodes in front of the shared pool, so claiming and
+// releasing a node normally needs no locking. The cache is refilled from and drained to the shared
+// pool in batches. Nodes claimed by one thread and released by another (e.g. a list used as a work
+// queue between threads) thus flow back to the claiming thread, and the number of nodes stays
+// bounded by the peak number of nodes in use plus the caches.
+// A thread's cache is freed when the thread ends, and its nodes go back to the shared pool. Lists
+// may outlive the thread that created their nodes (static lists are destroyed after the main
+// thread's thread local data), so the shared pool and its blocks are never freed; nodes released
+// after the releasing thread's cache is gone go straight to the shared pool.
+
+template <typename NODE_T>
+class ListNodePool {
+	union NodeSlot {
+		NodeSlot*	m_next;
+		alignas(NODE_T) char m_node[sizeof(NODE_T)];
+	};
+
+	struct NodeBlock {
+		BasicDataPool<NodeSlot>	m_slots;
+		NodeBlock*				m_next;
+	};
+
+	// -------------------------------------------------------------------------------------------------
+
+	class SharedPool {
+		static constexpr int minBlockSize = 64;
+		static constexpr int maxBlockSize = 4096;
+
+		std::mutex	m_lock;
+		NodeSlot*	m_freeSlots;
+		int			m_freeSlotCount;
+		NodeBlock*	m_blocks;
+		int			m_blockSize;
+		int			m_slotCount;
+
+		bool NewBlock(int blockSize) {
+			NodeBlock* block = new NodeBlock();
+			if (not block->m_slots.Create(blockSize)) {
+				delete block;
+				return false;
+			}
+			block->m_next = m_blocks;
+			m_blocks = block;
+			m_slotCount += blockSize;
+			if (m_blockSize < maxBlockSize)
+				m_blockSize *= 2;
+			return true;
+		}
+
+
+		NodeSlot* NewSlot(int count) {
+			int slotIndex;
+			if (m_blocks) {
+				NodeSlot* slot = m_blocks->m_slots.Claim(slotIndex);
+				if (slot)
+					return slot;
+			}
+			return NewBlock(std::max(count, m_blockSize)) ? m_blocks->m_slots.Claim(slotIndex) : nullptr;
+		}
+
+	public:
+		SharedPool()
+			: m_freeSlots(nullptr), m_freeSlotCount(0), m_blocks(nullptr), m_blockSize(minBlockSize), m_slotCount(0)
+		{
+		}
+
+
+		// pushes up to count free slots on the chain slots, allocating at most one block; returns the number of slots added
+		int Claim(NodeSlot*& slots, int count) {
+			std::lock_guard<std::mutex> lock(m_lock);
+			int i = 0;
+			for (; i < count; i++) {
+				NodeSlot* slot = m_freeSlots;
+				if (slot) {
+					m_freeSlots = slot->m_next;
+					--m_freeSlotCount;
+				}
+				else if (not (slot = NewSlot(count - i)))
+					break;
+				slot->m_next = slots;
+				slots = slot;
+			}
+			return i;
+		}
+
+
+		// takes back the count slots chained from first to last
+		void Release(NodeSlot* first, NodeSlot* last, int count) {
+			std::lock_guard<std::mutex> lock(m_lock);
+			last->m_next = m_freeSlots;
+			m_freeSlots = first;
+			m_freeSlotCount += count;
+		}
+
+
+		int SlotCount(void) {
+			std::lock_guard<std::mutex> lock(m_lock);
+			return m_slotCount;
+		}
+	};
+
+	// -------------------------------------------------------------------------------------------------
+
+	// creates the calling thread's cache and frees it when the thread ends
+	struct ThreadPoolOwner {
+		ThreadPoolOwner() {
+			m_threadPool = new ListNodePool();
+		}
+
+		~ThreadPoolOwner() {
+			m_threadPool->Drain(m_threadPool->m_freeSlotCount);
+			delete m_threadPool;
+			m_threadPool = nullptr;
+			m_threadEnded = true;
+		}
+	};
+
+	// -------------------------------------------------------------------------------------------------
+
+	static constexpr int batchSize = 64;
+	static constexpr int maxCachedSlots = 4 * batchSize;
+
+	// trivially destructible, so they remain usable while the thread's other thread locals are destroyed
+	static inline thread_local ListNodePool* m_threadPool = nullptr;
+	static inline thread_local bool m_threadEnded = false;
+
+	NodeSlot*	m_freeSlots;
+	int			m_freeSlotCount;
+
+	ListNodePool()
+		: m_freeSlots(nullptr), m_freeSlotCount(0)
+	{
+	}
+
+
+	static SharedPool& Shared(void) {
+		static SharedPool* pool = new SharedPool();
+		return *pool;
+	}
+
+
+	// the calling thread's cache, or nullptr if the thread is ending
+	static inline ListNodePool* ThreadPool(void) {
+		if (m_threadPool or m_threadEnded)
+			return m_threadPool;
+		static thread_local ThreadPoolOwner owner;
+		return m_threadPool;
+	}
+
+
+	inline bool Fill(int count) {
+		int claimed = Shared().Claim(m_freeSlots, count);
+		m_freeSlotCount += claimed;
+		return claimed == count;
+	}
+
+
+	// hands the count topmost cached slots back to the shared pool
+	void Drain(int count) {
+		if (count <= 0)
+			return;
+		NodeSlot* first = m_freeSlots;
+		NodeSlot* last = first;
+		for (int i = 1; i < count; i++)
+			last = last->m_next;
+		m_freeSlots = last->m_next;
+		m_freeSlotCount -= count;
+		Shared().Release(first, last, count);
+	}
+
+
+	inline void* ClaimSlot(void) {
+		if (not m_freeSlots) {
+			Fill(batchSize);
+			if (not m_freeSlots)
+				return nullptr;
+		}
+		NodeSlot* slot = m_freeSlots;
+		m_freeSlots = slot->m_next;
+		--m_freeSlotCount;
+		return slot;
+	}
+
+
+	inline void ReleaseSlot(NodeSlot* slot) {
+		slot->m_next = m_freeSlots;
+		m_freeSlots = slot;
+		if (++m_freeSlotCount > maxCachedSlots)
+			Drain(batchSize);
+	}
+
+public:
+	// returns uninitialized storage for a NODE_T; construct it with placement new
+	static inline void* Claim(void) {
+		ListNodePool* pool = ThreadPool();
+		if (pool)
+			return pool->ClaimSlot();
+		NodeSlot* slot = nullptr;
+		return Shared().Claim(slot, 1) ? slot : nullptr;
+	}
+
+
+	// node must have been destructed already. It may have been claimed by another thread.
+	static inline void Release(void* node) {
+		NodeSlot* slot = static_cast<NodeSlot*>(node);
+		ListNodePool* pool = ThreadPool();
+		if (pool)
+			pool->ReleaseSlot(slot);
+		else
+			Shared().Release(slot, slot, 1);
+	}
+
+
+	// make sure that count nodes can be claimed by the calling thread without allocating more than one block
+	static bool Reserve(int count) {
+		ListNodePool* pool = ThreadPool();
+		return not pool or (pool->m_freeSlotCount >= count) or pool->Fill(count - pool->m_freeSlotCount);
+	}
+
+
+	// number of nodes the pool has allocated storage for, whether in use or not
+	static int SlotCount(void) {
+		return Shared().SlotCount();
+	}
+};
+
+// =================================================================================================
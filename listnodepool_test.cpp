@@ -0,0 +1,127 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Checks that List nodes and positional index nodes (see listnodepool.hpp) are recycled across
+// threads: a list used as a work queue between a producer and a consumer thread, threads that
+// build lists and end, lists handed to another thread and a static list destroyed at exit.
+// Returns 0 if all checks pass. Build e.g. with:
+//   c++ -O2 -std=c++20 -pthread listnodepool_test.cpp
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include "list.hpp"
+
+// =================================================================================================
+
+static int failures = 0;
+
+static void Check(bool condition, const char* what) {
+    if (not condition) {
+        fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+static List<int> staticList; // released after the main thread's thread local data is gone
+
+//-----------------------------------------------------------------------------
+
+// one thread appends, the other one extracts from the front; at most maxQueued items are queued
+static void TestWorkQueue(int n, bool useIndex)
+{
+    constexpr int maxQueued = 1024;
+    List<int> queue;
+    if (useIndex)
+        queue.EnableIndex();
+    std::mutex lock;
+    long long sum = 0;
+    int slotCount = ListNodePool<List<int>::ListNode>::SlotCount();
+
+    std::condition_variable changed;
+    std::thread producer([&]() {
+        for (int i = 0; i < n; ) {
+            std::unique_lock<std::mutex> guard(lock);
+            changed.wait(guard, [&]() { return queue.Length() < maxQueued; });
+            for (; (i < n) and (queue.Length() < maxQueued); i++)
+                queue.Append(i);
+            changed.notify_one();
+        }
+    });
+    std::thread consumer([&]() {
+        for (int i = 0; i < n; ) {
+            std::unique_lock<std::mutex> guard(lock);
+            changed.wait(guard, [&]() { return queue.Length() > 0; });
+            for (; queue.Length(); i++)
+                sum += queue.Extract(0);
+            changed.notify_one();
+        }
+    });
+    producer.join();
+    consumer.join();
+
+    Check(queue.Length() == 0, "work queue is empty at the end");
+    Check(sum == (long long)n * (n - 1) / 2, "work queue passed every item once");
+    // the consumer's cache holds at most a few batches, the rest goes back to the producer
+    Check(ListNodePool<List<int>::ListNode>::SlotCount() - slotCount < 16 * maxQueued, "work queue node count stays bounded");
+}
+
+//-----------------------------------------------------------------------------
+
+// threads that end hand their cached nodes back, so later threads don't allocate new ones
+static void TestThreadExit(int threadCount, int n)
+{
+    auto buildList = [n]() {
+        List<int> l;
+        l.EnableIndex();
+        for (int i = 0; i < n; i++)
+            l.Append(i);
+        Check(l[n / 2] == n / 2, "indexed list built on a thread");
+    };
+    std::thread(buildList).join();
+    int slotCount = ListNodePool<List<int>::ListNode>::SlotCount();
+    for (int i = 0; i < threadCount; i++)
+        std::thread(buildList).join();
+    Check(ListNodePool<List<int>::ListNode>::SlotCount() == slotCount, "ended threads return their nodes");
+}
+
+//-----------------------------------------------------------------------------
+
+// nodes claimed on a thread that has ended are released by the thread that destroys the list
+static void TestHandOver(int n)
+{
+    List<int> l;
+    std::thread([&l, n]() {
+        for (int i = 0; i < n; i++)
+            l.Append(i);
+    }).join();
+    long long sum = 0;
+    for (auto v : l)
+        sum += v;
+    Check(sum == (long long)n * (n - 1) / 2, "list built on an ended thread");
+    l.Destroy();
+    Check(l.Length() == 0, "list built on an ended thread destroyed");
+}
+
+// =================================================================================================
+
+int main(int argc, char** argv)
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 2000000;
+    TestWorkQueue(n, false);
+    TestWorkQueue(n / 4, true);
+    TestThreadExit(16, 10000);
+    TestHandOver(100000);
+    for (int i = 0; i < 1000; i++)
+        staticList.Append(i);
+    fprintf(stderr, "%s\n", failures ? "listnodepool_test failed" : "listnodepool_test passed");
+    return failures ? 1 : 0;
+}
+
+// =================================================================================================
@@ -1,6 +1,8 @@
 #pragma once
 
-#include "std_defines.h"
+#if __has_include("std_defines.h") // project wide USE_STD* settings; all default to 0 without it
+#	include "std_defines.h"
+#endif
 
 #include <algorithm>
 
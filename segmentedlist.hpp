@@ -1,8 +1,21 @@
 #pragma once
 
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "list.hpp"
 
-#define USE_SEGMENTED_LISTS 0
+// 0: SegmentedList is an alias of List
+#ifndef USE_SEGMENTED_LISTS
+#	define USE_SEGMENTED_LISTS 0
+#endif
 
 #if !USE_SEGMENTED_LISTS
 
@@ -11,477 +24,451 @@ using SegmentedList = List<ITEM_T>;
 
 #else
 
+// =================================================================================================
+// Unrolled linked list: a doubly linked list of segments, each of which holds up to m_segmentSize
+// items contiguously (items [0, m_count) of a segment are in use). Sequential scans touch one
+// segment per cache friendly run of items, and indexed access skips whole segments.
+// Inserting into a full segment splits it in halves; a segment that becomes empty is released,
+// and a segment that becomes sparse is merged with its neighbour.
+
 template <typename DATA_T>
 class SegmentedList {
 private:
-	typedef Stack<DATA_T>		tDataBuffer;
-	typedef List<tDataBuffer*>	tSegmentList;
-
-	tSegmentList	m_data;
+	struct Segment {
+		Segment*	m_pred;
+		Segment*	m_succ;
+		int32_t		m_count;
 
-	//----------------------------------------
-
-	class ListDataPtr {
-	public:
-		tSegmentList*				m_data;
-		typename tSegmentList::ListNode*		m_nodePtr;
-		size_t						m_segmentSize;
-		size_t						m_index;
-
-		explicit ListDataPtr() : m_data(nullptr), m_nodePtr(nullptr), m_index(0) {}
-#if 0
-		explicit ListDataPtr(tSegmentList* data, size_t segmentSize, size_t index = 0) 
-			: m_data(data), m_segmentSize(segmentSize), m_index(index)
-		{
-			if (data && (segmentSize > 0)) {
-				m_nodePtr = data->NodePtrAt(index / segmentSize);
-			}
-		}
-#endif
-		explicit ListDataPtr(const tSegmentList* data, const size_t segmentSize, size_t index = 0)
-			: m_data(const_cast<tSegmentList*>(data)), m_segmentSize(segmentSize), m_index(index), m_nodePtr(nullptr)
-		{
-			if (data && (segmentSize > 0)) {
-				m_nodePtr = m_data->NodePtrAt(int (index / segmentSize));
-			}
-		}
-
-		ListDataPtr& operator= (ListDataPtr other) {
-			m_nodePtr = m_nodePtr;
-			return *this;
-		}
-
-		ListDataPtr& operator= (typename tSegmentList::ListNode* p) {
-			m_nodePtr = p;
-			return *this;
-		}
-#if 0
-		bool operator== (const ListDataPtr* other) {
-			return (m_nodePtr == other->m_nodePtr) && (m_index == other->m_index);
-		}
-#endif
-		bool operator!= (const ListDataPtr* other) {
-			return (m_nodePtr != other->m_nodePtr) or (m_index != other->m_index);
-		}
-
-		bool operator== (const ListDataPtr& other) {
-			return (m_nodePtr == other.m_nodePtr) && (m_index == other.m_index);
-		}
-
-		bool operator!= (const ListDataPtr& other) {
-			return (m_nodePtr != other.m_nodePtr) or (m_index != other.m_index);
-		}
-
-		void operator++ (int) {
-			if (m_index < m_nodePtr->GetDataValue()->ToS())
-				m_index++;
-			else {
-				m_nodePtr = m_nodePtr->m_succ;
-				m_index = 0;
-			}
-		}
-
-		void operator-- (int) {
-			if (m_index == 0) {
-				m_nodePtr = m_nodePtr->pred;
-				m_index = m_nodePtr->GetDataValue().ToS();
-			}
-			m_index--;
-		}
-
-
-		ListDataPtr ListDataPtrAt(int i) {
-			i += m_index;
-			return ListDataPtr(&m_data, m_segmentSize, i);
-		}
-
-
-		DATA_T* GetDataRef(void) {
-			return m_nodePtr->GetDataValue()->GetRef(m_index);
-		}
-
-
-		ListDataPtr operator+ (int n) {
-			return ListDataPtrAt(n);
-		}
-
-		ListDataPtr operator- (int n) {
-			return ListDataPtrAt(-n);
-		}
-
-		typename tSegmentList::ListNode* operator->() const {
-			return m_nodePtr;
-		}
-#if 1
-		bool operator== (const typename tSegmentList::ListNode* nodePtr) {
-			return m_nodePtr == nodePtr;
-		}
-
-		bool operator!= (const typename tSegmentList::ListNode* nodePtr) {
-			return m_nodePtr != nodePtr;
-		}
-#endif
-		operator bool() {
-			return (m_nodePtr != nullptr);
-		}
-
-		operator typename tSegmentList::ListNode* const() {
-			return m_nodePtr;
+		inline DATA_T* Items(void) {
+			return reinterpret_cast<DATA_T*>(reinterpret_cast<char*>(this) + itemOffset);
 		}
 	};
 
+	static constexpr size_t itemOffset = (sizeof(Segment) + alignof(DATA_T) - 1) / alignof(DATA_T) * alignof(DATA_T);
+	static constexpr int32_t defaultSegmentBytes = 512;
+
 	//----------------------------------------
 
+public:
 	class Iterator {
-		using ListDataPtr = typename SegmentedList<DATA_T>::ListDataPtr;
-
 	private:
-		ListDataPtr 	m_first;
-		ListDataPtr 	m_last;
-		ListDataPtr 	m_current;
-		size_t			m_index;
+		const SegmentedList*	m_list;
+		Segment*				m_segment;	// nullptr: end()
+		int32_t					m_offset;
+		int32_t					m_index;
 
 	public:
-		explicit Iterator() {}
-
-		Iterator(SegmentedList<DATA_T>& l)
-			//: m_first(l.First()), m_last(l.Last()), m_index(0)
+		explicit Iterator(const SegmentedList* list = nullptr, Segment* segment = nullptr, int32_t index = 0)
+			: m_list(list), m_segment(segment), m_offset(0), m_index(index)
 		{
-			m_first = l.First();
-			m_last = l.Last();
-			m_index = 0;
-			m_current = m_first;
 		}
 
-		Iterator(const SegmentedList<DATA_T>& l)
-			: m_first(l.First()), m_last(l.Last()), m_index(0)
-		{
-			m_current = m_first;
-		}
-
-		operator bool() const { return m_current != nullptr; }
-#if 0
-		DATA_T* operator*() {
-			return m_current;
-		}
+		operator bool() const { return m_segment != nullptr; }
 
-		const DATA_T* operator*() const {
-			return m_current;
-		}
-#endif
-		//DATA_T* operator*() const { return &m_current->m_data; }
-		// return the current value and the index of the value in the list
-		std::pair<size_t, DATA_T&> operator*() {
-			return std::pair<size_t, DATA_T&> {m_index, *m_current.GetDataRef() };
+		DATA_T& operator*() {
+			return m_segment->Items()[m_offset];
 		}
 
-		constexpr std::pair<size_t, DATA_T&> operator*() const {
-			return std::pair<size_t, DATA_T&> {m_index, *m_current.GetDataRef() };
+		DATA_T* operator->() {
+			return m_segment->Items() + m_offset;
 		}
 
 		Iterator& operator++() {
-			m_current++;
-			m_index++;
+			if (++m_offset == m_segment->m_count) {
+				m_segment = m_segment->m_succ;
+				m_offset = 0;
+			}
+			++m_index;
 			return *this;
 		}
 
+		// stepping back from end() moves to the last item, like List's iterator does from the tail sentinel
 		Iterator& operator--() {
-			m_current--;
+			if (not m_segment) {
+				if (m_list and (m_segment = m_list->m_last))
+					m_offset = m_segment->m_count - 1;
+			}
+			else if (m_offset)
+				--m_offset;
+			else if ((m_segment = m_segment->m_pred))
+				m_offset = m_segment->m_count - 1;
+			--m_index;
 			return *this;
 		}
 
-		bool operator== (Iterator& other) {
-			return m_current == other.m_current;
+		bool operator==(const Iterator& other) const {
+			return (m_segment == other.m_segment) and (m_offset == other.m_offset);
 		}
 
-		bool operator!= (Iterator& other) {
-			return m_current != other.m_current;
+		bool operator!=(const Iterator& other) const {
+			return (m_segment != other.m_segment) or (m_offset != other.m_offset);
 		}
 
-		//Iterator& Start(void) {
-		constexpr Iterator& First(void) {
-			m_index = 0;
-			m_current = m_first;
-			return *this;
-		}
-
-		constexpr Iterator& Last(void) {
-			m_current = m_last;
-			return *this;
+		inline int32_t Index(void) {
+			return m_index;
 		}
 	};
 
-	// ----------------------------------------
-	// This list implementation uses two dummy entries as head and tail elements,
-	// as this makes many operations on the list much easier.
-	// Since the list can always store a DATA_T*, head and tail will be initialized 
-	// with a DATA_T*, which is quite memory efficient.
+	//----------------------------------------
 
 private:
-	size_t		m_segmentSize;
-	size_t		m_length;
+	Segment*	m_first;
+	Segment*	m_last;
+	int32_t		m_segmentSize;
+	int32_t		m_length;
 	bool		m_result;
 	DATA_T		m_none;
 
 public:
-	void Destroy(void) {
-		m_data.Destroy();
+	// segmentSize 0: as many items as fit in defaultSegmentBytes, but at least 4
+	SegmentedList(int32_t segmentSize = 0)
+		: m_first(nullptr), m_last(nullptr), m_segmentSize(segmentSize), m_length(0), m_result(true)
+	{
 		Init();
 	}
 
-	SegmentedList& Copy(const SegmentedList& other) {
-		m_data = other.m_data;
-		return *this;
+	SegmentedList(SegmentedList<DATA_T> const& other)
+		: m_first(nullptr), m_last(nullptr), m_segmentSize(other.m_segmentSize), m_length(0), m_result(true)
+	{
+		Init();
+		Copy(other);
 	}
 
-	inline void Init(void) {
-		m_data.Init();
-		m_length = 0;
-		memset(&m_none, 0, sizeof(m_none));
+	SegmentedList(SegmentedList<DATA_T>&& other) noexcept
+		: m_first(nullptr), m_last(nullptr), m_segmentSize(other.m_segmentSize), m_length(0), m_result(true)
+	{
+		Init();
+		Move(other);
 	}
 
-	ListDataPtr ListDataPtrAt(size_t i) {
-		return ListDataPtr(&m_data, m_segmentSize, i);
+	SegmentedList(std::initializer_list<DATA_T> data, int32_t segmentSize = 0)
+		: m_first(nullptr), m_last(nullptr), m_segmentSize(segmentSize), m_length(0), m_result(true)
+	{
+		Init();
+		for (auto const& d : data)
+			Append(d);
 	}
 
-	typename tSegmentList::ListNode* NodePtrAt(size_t i) {
-		return ListDataPtrAt(i).m_nodePtr.GetDataValue().GetRef();
+	~SegmentedList() {
+		Destroy();
 	}
 
-	DATA_T* NodeDataAt(size_t i) {
-		return *(m_data->NodePtrAt(i / m_segmentSize)) [i % m_segmentSize];
+	inline void Init(void) {
+		if (m_segmentSize <= 0)
+			m_segmentSize = std::max(int32_t(defaultSegmentBytes / sizeof(DATA_T)), int32_t(4));
+		InitializeAnyType(m_none);
 	}
 
-	Iterator begin() const {
-		return Iterator(*this).First();
+	void Destroy(void) {
+		for (Segment* segment = m_first; segment; ) {
+			Segment* succ = segment->m_succ;
+			DestroyItems(segment->Items(), segment->m_count);
+			free(segment);
+			segment = succ;
+		}
+		m_first =
+		m_last = nullptr;
+		m_length = 0;
 	}
 
-	Iterator end() const {
-		return Iterator(*this).Last();
+	SegmentedList<DATA_T>& Copy(const SegmentedList<DATA_T>& other) {
+		for (Segment* segment = other.m_first; segment; segment = segment->m_succ) {
+			DATA_T* items = segment->Items();
+			for (int32_t i = 0; i < segment->m_count; i++)
+				Append(items[i]);
+		}
+		return *this;
 	}
 
-	inline ListDataPtr First(void) const {
-		return ListDataPtr (&m_data, m_segmentSize, 0 );
-		//return p;
+	// move the other list to this list. current list content will be removed first.
+	// will leave other list empty
+	SegmentedList<DATA_T>& Move(SegmentedList<DATA_T>& other) {
+		if (&other != this) {
+			Destroy();
+			m_segmentSize = other.m_segmentSize;
+			*this += std::move(other);
+		}
+		return *this;
+	}
+
+	Iterator begin() const {
+		return Iterator(this, m_first);
 	}
 
-	inline ListDataPtr Last(void) const {
-		return ListDataPtr (&m_data, m_segmentSize, size_t(m_length - 1) );
-		//return p;
-		//return ListDataPtr(&m_data, m_segmentSize, 0); // size_t(m_length - 1));
+	Iterator end() const {
+		return Iterator(this, nullptr, m_length);
 	}
 
-	inline size_t Length(void) {
+	inline int32_t Length(void) const {
 		return m_length;
 	}
 
+	inline int32_t SegmentSize(void) const {
+		return m_segmentSize;
+	}
+
 	inline const bool IsEmpty(void) const {
 		return m_length == 0;
 	}
 
+	inline bool Result(void) {
+		return m_result;
+	}
+
 	inline DATA_T& operator[] (int i) {
-		DATA_T* data = ListDataPtr(&m_data, m_segmentSize, i).GetDataRef();
-		if (data) {
+		int32_t offset;
+		Segment* segment = Locate(i, offset);
+		if (segment) {
 			m_result = true;
-			return *data;
+			return segment->Items()[offset];
 		}
 		m_result = false;
 		return m_none;
 	}
 
 	inline SegmentedList<DATA_T>& operator= (SegmentedList<DATA_T> const& other) {
-		Copy(other);
+		if (&other != this) {
+			Destroy();
+			Copy(other);
+		}
 		return *this;
 	}
 
-	inline SegmentedList<DATA_T>& operator= (SegmentedList&& other) noexcept {
+	inline SegmentedList<DATA_T>& operator= (SegmentedList<DATA_T>&& other) noexcept {
 		return Move(other);
 	}
 
 	inline SegmentedList<DATA_T>& operator= (std::initializer_list<DATA_T> data) {
 		Destroy();
-		Init();
 		for (auto& d : data)
 			Append(d);
 		return *this;
 	}
 
-	SegmentedList<DATA_T>(size_t segmentSize = 1) 
-		: m_segmentSize(segmentSize), m_length(0), m_result(true)
-	{
-		Init();
-	}
-
-	SegmentedList<DATA_T>(SegmentedList<DATA_T> const& other) :
-		m_length(0), m_result(true) 
-	{
-		Copy(other);
-	}
+	//-----------------------------------------------------------------------------
 
-	SegmentedList<DATA_T>(SegmentedList<DATA_T>&& other) noexcept :
-		m_length(0), m_result(true) 
-	{
-		Init();
-		Move(other);
+private:
+	static void DestroyItems(DATA_T* items, int32_t count) {
+		if constexpr (not std::is_trivially_destructible_v<DATA_T>) {
+			for (int32_t i = 0; i < count; i++)
+				items[i].~DATA_T();
+		}
 	}
 
-	explicit SegmentedList<DATA_T>(DATA_T& data) :
-		m_length(0), m_result(true) {
-		Append(data);
+	// move count items to uninitialized storage and destroy the source items
+	static void MoveItems(DATA_T* dest, DATA_T* source, int32_t count) {
+		if constexpr (std::is_trivially_copyable_v<DATA_T>)
+			memcpy(dest, source, count * sizeof(DATA_T));
+		else {
+			for (int32_t i = 0; i < count; i++) {
+				new (dest + i) DATA_T(std::move(source[i]));
+				source[i].~DATA_T();
+			}
+		}
 	}
 
-	explicit SegmentedList<DATA_T>(Array<DATA_T>& data) :
-		m_length(0), m_result(true) {
-		Init();
-		for (auto const& v : data)
-			Append(*v);
+	// create an empty segment and link it behind pred (in front of the first segment if pred is nullptr)
+	Segment* NewSegment(Segment* pred) {
+		Segment* segment = static_cast<Segment*>(malloc(itemOffset + m_segmentSize * sizeof(DATA_T)));
+		if (not segment)
+			return nullptr;
+		segment->m_count = 0;
+		segment->m_pred = pred;
+		segment->m_succ = pred ? pred->m_succ : m_first;
+		if (segment->m_succ)
+			segment->m_succ->m_pred = segment;
+		else
+			m_last = segment;
+		if (pred)
+			pred->m_succ = segment;
+		else
+			m_first = segment;
+		return segment;
+	}
+
+	void DeleteSegment(Segment* segment) {
+		if (segment->m_pred)
+			segment->m_pred->m_succ = segment->m_succ;
+		else
+			m_first = segment->m_succ;
+		if (segment->m_succ)
+			segment->m_succ->m_pred = segment->m_pred;
+		else
+			m_last = segment->m_pred;
+		DestroyItems(segment->Items(), segment->m_count);
+		free(segment);
+	}
+
+	// move the upper half of a full segment to a new segment behind it
+	Segment* SplitSegment(Segment* segment) {
+		Segment* succ = NewSegment(segment);
+		if (not succ)
+			return nullptr;
+		int32_t count = segment->m_count / 2;
+		succ->m_count = segment->m_count - count;
+		segment->m_count = count;
+		MoveItems(succ->Items(), segment->Items() + count, succ->m_count);
+		return succ;
+	}
+
+	// append the items of segment's successor to segment and release the successor
+	void MergeSegment(Segment* segment) {
+		Segment* succ = segment->m_succ;
+		MoveItems(segment->Items() + segment->m_count, succ->Items(), succ->m_count);
+		segment->m_count += succ->m_count;
+		succ->m_count = 0;
+		DeleteSegment(succ);
+	}
+
+	// release a segment that has become empty, or merge a sparse segment with a neighbour
+	void Compact(Segment* segment) {
+		if (segment->m_count == 0)
+			DeleteSegment(segment);
+		else if (segment->m_pred and (segment->m_pred->m_count + segment->m_count <= m_segmentSize / 2))
+			MergeSegment(segment->m_pred);
+		else if (segment->m_succ and (segment->m_count + segment->m_succ->m_count <= m_segmentSize / 2))
+			MergeSegment(segment);
+	}
+
+	// find the segment holding item i (negative i count from the end of the list, -1 being the last item)
+	Segment* Locate(int i, int32_t& offset) const {
+		if (i < 0)
+			i += m_length;
+		if ((i < 0) or (i >= m_length))
+			return nullptr;
+		Segment* segment;
+		if (i < m_length / 2) {
+			for (segment = m_first; i >= segment->m_count; segment = segment->m_succ)
+				i -= segment->m_count;
+		}
+		else {
+			for (i = m_length - i, segment = m_last; i > segment->m_count; segment = segment->m_pred)
+				i -= segment->m_count;
+			i = segment->m_count - i;
+		}
+		offset = i;
+		return segment;
 	}
 
-	SegmentedList<DATA_T>(std::initializer_list<DATA_T> data), size_t segmentSize = 1) :
-		m_length(0), m_result(true) {
-		Init();
-		for (auto const& d : data)
-			Append(d);
+	template<typename T>
+	static DATA_T* InsertItem(Segment* segment, int32_t i, T&& data) {
+		DATA_T* items = segment->Items();
+		int32_t n = segment->m_count++;
+		if (i == n)
+			new (items + n) DATA_T(std::forward<T>(data));
+		else if constexpr (std::is_trivially_copyable_v<DATA_T>) {
+			memmove(items + i + 1, items + i, (n - i) * sizeof(DATA_T));
+			new (items + i) DATA_T(std::forward<T>(data));
+		}
+		else {
+			new (items + n) DATA_T(std::move(items[n - 1]));
+			std::move_backward(items + i, items + n - 1, items + n);
+			items[i] = std::forward<T>(data);
+		}
+		return items + i;
 	}
 
-	~SegmentedList() {
-		Destroy();
+	static void RemoveItem(Segment* segment, int32_t i) {
+		DATA_T* items = segment->Items();
+		int32_t n = --segment->m_count;
+		if constexpr (std::is_trivially_copyable_v<DATA_T>)
+			memmove(items + i, items + i + 1, (n - i) * sizeof(DATA_T));
+		else {
+			std::move(items + i + 1, items + n + 1, items + i);
+			items[n].~DATA_T();
+		}
 	}
 
 	//-----------------------------------------------------------------------------
+	// insert data in front of item i; i == Length() or -1 appends data
 
 public:
-	DATA_T* Add(int i, const DATA_T* data = nullptr) {
+	template<typename T>
+	DATA_T* Insert(int i, T&& data) {
 		if (i < 0)
-			i = int (m_length - i + 1);
-		if (i < m_length)
-			Add(int (m_length), &(*this)[i]); // move element at index i to end of list to free up its position
-		else {
-			int first = int (m_length / m_segmentSize);
-			int last = int ((m_length + i) / m_segmentSize);
-			for (int i = first; i < last; i++)
-				m_data.Insert(-1);
-		}
-		DATA_T* dataPtr = ListDataPtr(&m_data, m_segmentSize, i).GetDataRef();
-		if (data)
-			*dataPtr = *data;
-		else {
-			DATA_T d{};
-			*dataPtr = DATA_T{};
+			i += m_length + 1;
+		if ((i < 0) or (i > m_length)) {
+			m_result = false;
+			return nullptr;
+		}
+		Segment* segment;
+		if (i == m_length) { // no items move
+			segment = m_last;
+			if (not segment or (segment->m_count == m_segmentSize))
+				segment = NewSegment(m_last);
+			if (not segment) {
+				m_result = false;
+				return nullptr;
+			}
+			m_length++;
+			m_result = true;
+			return InsertItem(segment, segment->m_count, std::forward<T>(data));
+		}
+		DATA_T item(std::forward<T>(data)); // data may refer to an item that splitting or shifting moves
+		int32_t offset;
+		segment = Locate(i, offset);
+		if (segment->m_count == m_segmentSize) {
+			Segment* succ = SplitSegment(segment);
+			if (not succ) {
+				m_result = false;
+				return nullptr;
+			}
+			if (offset > segment->m_count) {
+				offset -= segment->m_count;
+				segment = succ;
+			}
 		}
 		m_length++;
-		return dataPtr;
-	}
-
-	//-----------------------------------------------------------------------------
-
-public:
-	bool Insert(int i, DATA_T* data) {
-		return Add(i, data) != nullptr;
+		m_result = true;
+		return InsertItem(segment, offset, std::move(item));
 	}
 
-
-	bool Insert(int i, DATA_T& data) {
-		return Add(i, &data) != nullptr;
+	inline DATA_T* Insert(int i) {
+		return Insert(i, DATA_T());
 	}
 
-
-	bool Insert(int i, const DATA_T& data) {
-		return Add(i, &data) != nullptr;
+	template<typename T>
+	inline DATA_T* Append(T&& data) {
+		return Insert(-1, std::forward<T>(data));
 	}
 
-
-	bool Insert(int i, DATA_T&& data) {
-		return Add(i, new DATA_T(std::move(data), true)) != nullptr;
+	inline DATA_T* Append(void) {
+		return Insert(-1);
 	}
 
 	//-----------------------------------------------------------------------------
 
 public:
 	DATA_T Extract(int i) {
-		m_result = false;
-		if (not m_length)
-			return m_none;
-
-		typename tSegmentList::ListNode* node = m_data.NodePtrAt(i / m_segmentSize);
-		if (not node)
+		DATA_T data;
+		if (not Extract(data, i))
 			return m_none;
-		DATA_T* data = node->GetDataValue().GetRef(i % m_segmentSize);
-		Discard(node);
-		m_result = true;
-		return *data;
-	}
-
-	//-----------------------------------------------------------------------------
-
-public:
-	bool Discard(int i) {
-		m_result = false;
-		if (not m_length)
-			return false;
-		return Discard(NodePtrAt(i));
+		return data;
 	}
 
 
-	bool Discard(typename tSegmentList::ListNode* node) {
-		if (not node)
+	bool Extract(DATA_T& data, int i) {
+		int32_t offset;
+		Segment* segment = Locate(i, offset);
+		if (not segment)
 			return m_result = false;
-		*node = *NodePtrAt(m_length - 1); // overwrite with last entry in list - fastest way to remove one list entry and keep the list without gaps
-		tDataBuffer& b = m_data[m_length / m_segmentSize]; // if the last list segment is empty now, discard it
-		if (not b.Shrink())
-			m_data.Discard(m_length - 1);
+		data = std::move(segment->Items()[offset]);
+		RemoveItem(segment, offset);
+		Compact(segment);
 		m_length--;
 		return m_result = true;
 	}
 
-	//-----------------------------------------------------------------------------
-	// copy the other list to the end of this list
-	// will leave other list intact
-
-public:
-	SegmentedList<DATA_T>& operator+= (SegmentedList<DATA_T>& other) {
-		if (IsEmpty())
-			return *this;
-		for (auto& d : other)
-			Insert(-1, d);
-		return *this;
-	}
-
-	//-----------------------------------------------------------------------------
-
-	SegmentedList<DATA_T>& operator+= (List<DATA_T>& other) {
-		if (IsEmpty())
-			return *this;
-		for (auto& d : other)
-			Insert(-1, d);
-		return *this;
-	}
-
-	//-----------------------------------------------------------------------------
-	// move the other list to this list. current list content will be removed first.
-	// will leave other list empty
 
-public:
-	SegmentedList<DATA_T>& Move(SegmentedList<DATA_T>& other) {
-		Destroy();
-		m_data.Move(other.m_data);
-		m_length = other.m_length;
-		Init();
-		return *this;
-	}
-
-	//-----------------------------------------------------------------------------
-
-public:
-	SegmentedList<DATA_T> operator+ (const SegmentedList<DATA_T>& other) {
-		SegmentedList l;
-		if (IsEmpty())
-			return l = other;
-		if (IsEmpty())
-			return l = *this;
-		l = *this;
-		l += other;
-		return l;
+	bool Discard(int i) {
+		int32_t offset;
+		Segment* segment = Locate(i, offset);
+		if (not segment)
+			return m_result = false;
+		RemoveItem(segment, offset);
+		Compact(segment);
+		m_length--;
+		return m_result = true;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -490,76 +477,123 @@ public:
 	template<typename T>
 	int Find(T&& data) {
 		DATA_T pattern = std::forward<T>(data);
-#if 1
-		for (const auto p : *this)
-			if (p == pattern)
-				return int(i);
-#else
 		int i = 0;
-		for (ListDataPtr p(m_headPtr); p != m_tailPtr; p++, i++)
-			if (*p->GetDataValue() == pattern)
-				return int(i);
-#endif
+		for (Segment* segment = m_first; segment; segment = segment->m_succ) {
+			DATA_T* items = segment->Items();
+			for (int32_t j = 0; j < segment->m_count; j++, i++)
+				if (items[j] == pattern)
+					return i;
+		}
 		return -1;
 	}
 
+
+	template<typename T>
+	inline bool Remove(T&& data) {
+		int i = Find(std::forward<T>(data));
+		if (i < 0)
+			return (m_result = false);
+		return Discard(i);
+	}
+
+
+	// remove all items for which filter returns true
+	template<typename FILTER_T>
+	int32_t Filter(FILTER_T filter) {
+		int32_t deleted = 0;
+		for (Segment* segment = m_first; segment; ) {
+			Segment* succ = segment->m_succ;
+			DATA_T* items = segment->Items();
+			int32_t n = 0;
+			for (int32_t i = 0; i < segment->m_count; i++) {
+				if (filter(items[i]))
+					continue;
+				if (n < i)
+					items[n] = std::move(items[i]);
+				n++;
+			}
+			DestroyItems(items + n, segment->m_count - n);
+			deleted += segment->m_count - n;
+			if (not (segment->m_count = n))
+				DeleteSegment(segment);
+			segment = succ;
+		}
+		m_length -= deleted;
+		return deleted;
+	}
+
 	//-----------------------------------------------------------------------------
+	// return a copy of items [from, to); to == 0 copies up to the end of the list
 
 public:
-	SegmentedList<DATA_T> Splice(size_t from, size_t to = 0) {
-		ListDataPtr start = ListDataPtrAt(int(from));
-		ListDataPtr end = ListDataPtrAt(int(to ? to : m_length - 1));
-		SegmentedList l;
-		if ((start != nullptr) && (end != nullptr)) {
-			for (ListDataPtr current = start; current != end; current++) {
-				l.Append(new typename tSegmentList::ListNode(*current.GetDataRef()));
+	SegmentedList<DATA_T> Splice(int32_t from, int32_t to = 0) {
+		SegmentedList<DATA_T> l(m_segmentSize);
+		if (to <= 0)
+			to += m_length;
+		int32_t offset;
+		Segment* segment = Locate(from, offset);
+		for (int32_t i = from; segment and (i < to); i++) {
+			l.Append(segment->Items()[offset]);
+			if (++offset == segment->m_count) {
+				segment = segment->m_succ;
+				offset = 0;
 			}
 		}
 		return l;
 	}
 
 	//-----------------------------------------------------------------------------
+	// copy the other list to the end of this list
+	// will leave other list intact
 
 public:
-#if 1
-	template<typename T>
-	inline bool Append(T&& data) {
-		return Insert(-1, std::forward<T>(data));
-	}
-#else
-	inline bool Append(DATA_T* data) {
-		return Insert(-1, data);
+	SegmentedList<DATA_T>& operator+= (const SegmentedList<DATA_T>& other) {
+		if (&other == this) {
+			SegmentedList<DATA_T> l(other);
+			return *this += std::move(l);
+		}
+		return Copy(other);
 	}
 
-	inline bool Append(DATA_T& data) {
-		return Insert(-1, data);
-	}
 
-	inline bool Append(DATA_T&& data) {
-		return Insert(-1, data);
+	SegmentedList<DATA_T>& operator+= (List<DATA_T>& other) {
+		for (auto& d : other)
+			Append(d);
+		return *this;
 	}
-#endif
 
-	//-----------------------------------------------------------------------------
 
-public:
-	template<typename T>
-	inline bool Remove(T&& data) {
-		int i = Find(std::forward<T>(data));
-		if (i < 0)
-			return (m_result = false);
-		Extract(size_t(i));
-		return (m_result = true);
+	// move the segments of other to the end of this list; will leave other empty
+	SegmentedList<DATA_T>& operator+= (SegmentedList<DATA_T>&& other) {
+		if (other.IsEmpty() or (&other == this))
+			return *this;
+		if (other.m_segmentSize != m_segmentSize) {
+			for (auto& d : other)
+				Append(std::move(d));
+			other.Destroy();
+			return *this;
+		}
+		other.m_first->m_pred = m_last;
+		if (m_last)
+			m_last->m_succ = other.m_first;
+		else
+			m_first = other.m_first;
+		m_last = other.m_last;
+		m_length += other.m_length;
+		other.m_first =
+		other.m_last = nullptr;
+		other.m_length = 0;
+		return *this;
 	}
 
-	//-----------------------------------------------------------------------------
 
-public:
-	inline bool Result(void) {
-		return m_result;
+	SegmentedList<DATA_T> operator+ (const SegmentedList<DATA_T>& other) {
+		SegmentedList<DATA_T> l(*this);
+		l += other;
+		return l;
 	}
-
-	//-----------------------------------------------------------------------------
 };
 
 #endif
+
+// =================================================================================================
@@ -0,0 +1,175 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Checks SegmentedList against std::vector: random inserts, appends, extractions, lookups and
+// filters with several segment sizes, iteration in both directions, copies, moves and splices,
+// and inserting items of the list itself.
+// Returns 0 if all checks pass. Build e.g. with:
+//   c++ -O2 -std=c++20 segmentedlist_test.cpp
+
+#define USE_SEGMENTED_LISTS 1
+
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+
+#include "segmentedlist.hpp"
+
+// =================================================================================================
+
+static int failures = 0;
+
+static bool Check(bool condition, const char* what, int segmentSize) {
+    if (not condition) {
+        fprintf(stderr, "FAILED: %s (segment size %d)\n", what, segmentSize);
+        ++failures;
+    }
+    return condition;
+}
+
+//-----------------------------------------------------------------------------
+
+template <typename DATA_T>
+static bool Matches(SegmentedList<DATA_T>& l, const std::vector<DATA_T>& v) {
+    if (l.Length() != int32_t(v.size()))
+        return false;
+    size_t i = 0;
+    for (auto& d : l)
+        if (not (d == v[i++]))
+            return false;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+template <typename DATA_T, typename MAKE_T>
+static void TestRandomOps(int segmentSize, MAKE_T make)
+{
+    std::mt19937 rng(segmentSize);
+    SegmentedList<DATA_T> l(segmentSize);
+    std::vector<DATA_T> v;
+    for (int step = 0; step < 20000; step++) {
+        int op = rng() % 10, n = int(v.size());
+        if (op < 5) {
+            DATA_T d = make(rng());
+            if (rng() % 4 == 0) {
+                l.Append(d);
+                v.push_back(d);
+            }
+            else {
+                int i = n ? int(rng() % (n + 1)) : 0;
+                l.Insert(i, d);
+                v.insert(v.begin() + i, d);
+            }
+        }
+        else if ((op < 7) and n) {
+            int i = rng() % n;
+            if (rng() & 1)
+                l.Discard(i);
+            else if (not Check(l.Extract(i) == v[i], "Extract", segmentSize))
+                return;
+            v.erase(v.begin() + i);
+        }
+        else if ((op == 7) and n) {
+            int i = rng() % n;
+            if (not Check((l[i] == v[i]) and (l[i - n] == v[i]), "operator[]", segmentSize))
+                return;
+        }
+        else if ((op == 8) and n) {
+            DATA_T d = v[rng() % n];
+            if (not Check(l.Find(d) == int(std::find(v.begin(), v.end(), d) - v.begin()), "Find", segmentSize))
+                return;
+        }
+        else if ((op == 9) and n and (rng() % 2)) { // insert an item of the list itself
+            int i = rng() % (n + 1), j = rng() % n;
+            DATA_T d = v[j];
+            l.Insert(i, l[j]);
+            v.insert(v.begin() + i, d);
+        }
+        else if (rng() % 50 == 0) {
+            int k = 0;
+            l.Filter([&k](DATA_T&) { return (k++ % 3) == 0; });
+            std::vector<DATA_T> w;
+            for (size_t i = 0; i < v.size(); i++)
+                if (i % 3)
+                    w.push_back(v[i]);
+            v = w;
+        }
+        if (not Check(l.Length() == int32_t(v.size()), "Length", segmentSize))
+            return;
+    }
+    Check(Matches(l, v), "forward iteration", segmentSize);
+
+    // backwards from end(), which has no segment of its own
+    auto it = l.end();
+    bool backwardsOk = true;
+    for (size_t i = v.size(); i; ) {
+        --it;
+        if (not it or not (*it == v[--i]) or (it.Index() != int32_t(i)))
+            backwardsOk = false;
+    }
+    Check(backwardsOk, "backward iteration from end()", segmentSize);
+
+    SegmentedList<DATA_T> c(l), m(std::move(c)), s = l.Splice(3, 10);
+    Check((c.Length() == 0) and Matches(m, v), "copy and move", segmentSize);
+    Check(Matches(s, std::vector<DATA_T>(v.begin() + 3, v.begin() + 10)), "Splice", segmentSize);
+    m += std::move(s);
+    m += l;
+    Check(m.Length() == 2 * l.Length() + 7, "operator+=", segmentSize);
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestEmpty(void)
+{
+    SegmentedList<int> l;
+    Check(l.begin() == l.end(), "empty list iteration", 0);
+    auto it = l.end();
+    --it;
+    Check(not it, "stepping back from end() of an empty list", 0);
+    l.Append(1);
+    it = l.end();
+    --it;
+    Check(it and (*it == 1), "stepping back from end() to the only item", 0);
+}
+
+//-----------------------------------------------------------------------------
+
+// inserting an item of the list itself in front of it, which shifts (or splits off) the item
+static void TestSelfInsert(int segmentSize)
+{
+    SegmentedList<std::string> l(segmentSize);
+    std::vector<std::string> v;
+    for (int i = 0; i < 8; i++) {
+        l.Append(std::string(30, char('a' + i)));
+        v.push_back(std::string(30, char('a' + i)));
+    }
+    for (int i = 0; i < 40; i++) {
+        int32_t j = (i * 7) % int32_t(v.size());
+        std::string d = v[j];
+        l.Insert(j / 2, l[j]);
+        v.insert(v.begin() + j / 2, d);
+    }
+    l.Insert(0, l[1]);
+    v.insert(v.begin(), std::string(v[1]));
+    Check(Matches(l, v), "Insert of own items", segmentSize);
+}
+
+// =================================================================================================
+
+int main()
+{
+    TestEmpty();
+    for (int segmentSize : { 0, 1, 2, 4, 7 }) {
+        TestSelfInsert(segmentSize);
+        TestRandomOps<int>(segmentSize, [](unsigned r) { return int(r % 1000); });
+        TestRandomOps<std::string>(segmentSize, [](unsigned r) { return std::string(20, char('a' + r % 26)) + std::to_string(r % 1000); });
+    }
+    fprintf(stderr, "%s\n", failures ? "segmentedlist_test failed" : "segmentedlist_test passed");
+    return failures ? 1 : 0;
+}
+
+// =================================================================================================
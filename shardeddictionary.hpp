@@ -0,0 +1,247 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Dictionary for write heavy data shared between threads (counters, caches).
+// Keys are hashed into a power of two number of shards; each shard is an
+// AVLTree guarded by its own mutex, so writers only contend when their keys
+// fall into the same shard. Walk merges the shards in key order; WalkShards
+// visits the shards one after the other without any ordering across them.
+
+#pragma once
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+#include "avltree.hpp"
+
+// =================================================================================================
+
+template <typename KEY_T, typename DATA_T>
+class ShardedDictionary
+{
+public:
+    using Comparator = typename AVLTreeTraits<KEY_T, DATA_T>::Comparator;
+    using DataProcessor = typename AVLTreeTraits<KEY_T, DATA_T>::DataProcessor;
+    using HashFunction = size_t(*)(void*, const KEY_T&);
+    using Tree = AVLTree<KEY_T, DATA_T>;
+
+private:
+    struct alignas(64) Shard {
+        std::mutex  lock;
+        Tree        tree;
+    };
+
+    template <typename T, typename = void>
+    struct IsHashable : std::false_type {};
+
+    template <typename T>
+    struct IsHashable<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T&>()))>> : std::true_type {};
+
+    static size_t StdHash(void* /*context*/, const KEY_T& key) {
+        return std::hash<KEY_T>{}(key);
+    }
+
+private:
+    std::unique_ptr<Shard[]>    m_shards;
+    int                         m_shardCount;
+    int                         m_shardShift;   // shift to extract the shard index from the mixed hash value
+    HashFunction                m_hashKey;
+    Comparator                  m_compareNodes;
+    void*                       m_context;
+
+public:
+    // shardCount is rounded up to a power of two; 0 = twice the number of hardware threads
+    explicit ShardedDictionary(int shardCount = 0)
+        : m_shardCount(1), m_shardShift(64), m_hashKey(nullptr), m_compareNodes(nullptr), m_context(nullptr)
+    {
+        if (shardCount <= 0)
+            shardCount = std::max(2 * int(std::thread::hardware_concurrency()), 1);
+        while (m_shardCount < shardCount) {
+            m_shardCount <<= 1;
+            --m_shardShift;
+        }
+        m_shards.reset(new Shard[m_shardCount]);
+        if constexpr (IsHashable<KEY_T>::value)
+            m_hashKey = StdHash;
+    }
+
+
+    ~ShardedDictionary() = default;
+
+    ShardedDictionary(const ShardedDictionary&) = delete;
+    ShardedDictionary& operator=(const ShardedDictionary&) = delete;
+
+
+    // must be called before the dictionary is shared between threads
+    void SetComparator(Comparator compareNodes, void* context = nullptr) {
+        m_compareNodes = compareNodes;
+        m_context = context;
+        for (int i = 0; i < m_shardCount; i++)
+            m_shards[i].tree.SetComparator(compareNodes, context);
+    }
+
+
+    // must be called before the dictionary is shared between threads; required for key types without std::hash
+    inline void SetHashFunction(HashFunction hashKey) {
+        m_hashKey = hashKey;
+    }
+
+
+    inline int ShardCount(void) const {
+        return m_shardCount;
+    }
+
+//-----------------------------------------------------------------------------
+
+private:
+    inline Shard& ShardOf(const KEY_T& key) {
+        // Fibonacci hashing spreads weak hashes (e.g. std::hash<int> is the identity) over all shards
+        uint64_t h = uint64_t(m_hashKey(m_context, key)) * 0x9E3779B97F4A7C15ull;
+        return m_shards[(m_shardShift < 64) ? int(h >> m_shardShift) : 0];
+    }
+
+//-----------------------------------------------------------------------------
+
+public:
+    int Size(void)
+    {
+        int size = 0;
+        for (int i = 0; i < m_shardCount; i++) {
+            std::lock_guard<std::mutex> lock(m_shards[i].lock);
+            size += m_shards[i].tree.Size();
+        }
+        return size;
+    }
+
+
+    bool Insert(const KEY_T& key, const DATA_T& data, bool updateData = false)
+    {
+        Shard& shard = ShardOf(key);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        return shard.tree.Insert(key, data, updateData);
+    }
+
+
+    // Data is copied out, since another thread may remove the entry as soon as the shard is unlocked.
+    bool Find(const KEY_T& key, DATA_T& data)
+    {
+        Shard& shard = ShardOf(key);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        DATA_T* p = shard.tree.Find(key);
+        if (not p)
+            return false;
+        data = *p;
+        return true;
+    }
+
+
+    // Calls modify (DATA_T&) on the entry with key while its shard is locked. If there is no such
+    // entry and insert is set, a default constructed one is inserted first (e.g. for counters).
+    template <typename FUNC_T>
+    bool Modify(const KEY_T& key, FUNC_T modify, bool insert = true)
+    {
+        Shard& shard = ShardOf(key);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        DATA_T* p = shard.tree.Find(key);
+        if (not p) {
+            if (not (insert and shard.tree.Insert(key, DATA_T())))
+                return false;
+            if (not (p = shard.tree.Find(key)))
+                return false;
+        }
+        modify(*p);
+        return true;
+    }
+
+
+    bool Remove(const KEY_T& key)
+    {
+        Shard& shard = ShardOf(key);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        return shard.tree.Remove(key);
+    }
+
+
+    bool Extract(const KEY_T& key, DATA_T& data)
+    {
+        Shard& shard = ShardOf(key);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        return shard.tree.Extract(key, data);
+    }
+
+
+    void Destroy(void)
+    {
+        for (int i = 0; i < m_shardCount; i++) {
+            std::lock_guard<std::mutex> lock(m_shards[i].lock);
+            m_shards[i].tree.Destroy();
+        }
+    }
+
+//-----------------------------------------------------------------------------
+// Walk locks all shards (in index order, so concurrent walks cannot deadlock) and
+// merges their in-order iterators through a heap, i.e. O(n log shardCount).
+// Writers are blocked for the duration of the walk; use WalkShards if the order
+// of the keys doesn't matter.
+
+public:
+    bool Walk(DataProcessor processNode, void* context = nullptr)
+    {
+        using Iterator = typename Tree::Iterator;
+
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(m_shardCount);
+        for (int i = 0; i < m_shardCount; i++)
+            locks.emplace_back(m_shards[i].lock);
+
+        // the heap holds shard indices rather than the (fairly large) iterators themselves;
+        // std heap functions build a max heap, so order by descending keys to get the smallest key on top
+        std::vector<Iterator> iterators;
+        std::vector<int> heap;
+        iterators.reserve(m_shardCount);
+        heap.reserve(m_shardCount);
+        for (int i = 0; i < m_shardCount; i++) {
+            iterators.push_back(m_shards[i].tree.begin());
+            if (iterators.back())
+                heap.push_back(i);
+        }
+        auto isGreater = [this, &iterators](int a, int b) {
+            return m_compareNodes(m_context, iterators[a].Key(), iterators[b].Key()) > 0;
+        };
+        std::make_heap(heap.begin(), heap.end(), isGreater);
+        while (not heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), isGreater);
+            Iterator& it = iterators[heap.back()];
+            if (not processNode(context, it.Key(), it.Data()))
+                return false;
+            if (++it)
+                std::push_heap(heap.begin(), heap.end(), isGreater);
+            else
+                heap.pop_back();
+        }
+        return true;
+    }
+
+
+    // visits each shard in key order while holding only that shard's lock
+    bool WalkShards(DataProcessor processNode, void* context = nullptr)
+    {
+        for (int i = 0; i < m_shardCount; i++) {
+            std::lock_guard<std::mutex> lock(m_shards[i].lock);
+            for (auto [key, data] : m_shards[i].tree)
+                if (not processNode(context, key, data))
+                    return false;
+        }
+        return true;
+    }
+};
+
+// =================================================================================================
@@ -0,0 +1,370 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+#pragma once
+
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include <stdint.h>
+#include <string.h>
+
+// =================================================================================================
+// Growable array that keeps up to N items inside the object itself and only moves them to the
+// heap when more are added. Most arrays hold a handful of items, which then cost no allocation.
+// The interface follows the std::vector based ManagedArray (Length, Capacity, Append, Push, Pop,
+// Resize, Reserve, ...). Only the items [0, Length()) are constructed.
+// Moving a SmallArray moves its items one by one while they are stored inline, so pointers to
+// items don't survive a move in that case.
+
+template <typename DATA_T, int32_t N = 8>
+class SmallArray {
+	static_assert(N > 0, "SmallArray needs room for at least one inline item");
+
+private:
+	alignas(DATA_T) unsigned char	m_inline[N * sizeof(DATA_T)];
+	DATA_T*							m_data;
+	int32_t							m_length;
+	int32_t							m_capacity;
+	DATA_T							m_none;
+
+	inline DATA_T* InlineData(void) {
+		return std::launder(reinterpret_cast<DATA_T*>(m_inline));
+	}
+
+
+	static void MoveItems(DATA_T* dest, DATA_T* source, int32_t count) {
+		if constexpr (std::is_trivially_copyable_v<DATA_T>)
+			memcpy(static_cast<void*>(dest), source, count * sizeof(DATA_T));
+		else {
+			for (int32_t i = 0; i < count; i++) {
+				new (dest + i) DATA_T(std::move(source[i]));
+				source[i].~DATA_T();
+			}
+		}
+	}
+
+
+	static void DestroyItems(DATA_T* items, int32_t count) {
+		if constexpr (not std::is_trivially_destructible_v<DATA_T>) {
+			for (int32_t i = 0; i < count; i++)
+				items[i].~DATA_T();
+		}
+	}
+
+
+	static inline void FreeData(DATA_T* data) {
+		::operator delete(static_cast<void*>(data), std::align_val_t(alignof(DATA_T)));
+	}
+
+
+	// move the items to a heap buffer for capacity items
+	bool Relocate(int32_t capacity) {
+		DATA_T* data = static_cast<DATA_T*>(::operator new(capacity * sizeof(DATA_T), std::align_val_t(alignof(DATA_T)), std::nothrow));
+		if (not data)
+			return false;
+		MoveItems(data, m_data, m_length);
+		if (not IsInline())
+			FreeData(m_data);
+		m_data = data;
+		m_capacity = capacity;
+		return true;
+	}
+
+
+	inline bool Grow(int32_t length) {
+		return (length <= m_capacity) or Relocate(std::max(length, 2 * m_capacity));
+	}
+
+	//----------------------------------------
+
+public:
+	SmallArray()
+		: m_data(InlineData()), m_length(0), m_capacity(N), m_none(DATA_T())
+	{
+	}
+
+
+	SmallArray(std::initializer_list<DATA_T> data)
+		: SmallArray()
+	{
+		Reserve(int32_t(data.size()));
+		for (auto& v : data)
+			Append(v);
+	}
+
+
+	SmallArray(const SmallArray& other)
+		: SmallArray()
+	{
+		Copy(other);
+	}
+
+
+	SmallArray(SmallArray&& other) noexcept
+		: SmallArray()
+	{
+		Move(other);
+	}
+
+
+	~SmallArray() {
+		Destroy();
+	}
+
+
+	SmallArray& operator=(const SmallArray& other) {
+		if (&other != this) {
+			Reset();
+			Copy(other);
+		}
+		return *this;
+	}
+
+
+	SmallArray& operator=(SmallArray&& other) noexcept {
+		if (&other != this) {
+			Destroy();
+			Move(other);
+		}
+		return *this;
+	}
+
+
+	SmallArray& operator=(std::initializer_list<DATA_T> data) {
+		Reset();
+		Reserve(int32_t(data.size()));
+		for (auto& v : data)
+			Append(v);
+		return *this;
+	}
+
+	//----------------------------------------
+
+private:
+	void Copy(const SmallArray& other) {
+		if (Grow(other.m_length)) {
+			for (int32_t i = 0; i < other.m_length; i++)
+				new (m_data + i) DATA_T(other.m_data[i]);
+			m_length = other.m_length;
+		}
+	}
+
+
+	// this array must be empty and inline
+	void Move(SmallArray& other) {
+		if (other.IsInline()) {
+			MoveItems(m_data, other.m_data, other.m_length);
+			m_length = other.m_length;
+			other.m_length = 0;
+		}
+		else {
+			m_data = other.m_data;
+			m_length = other.m_length;
+			m_capacity = other.m_capacity;
+			other.m_data = other.InlineData();
+			other.m_length = 0;
+			other.m_capacity = N;
+		}
+	}
+
+	//----------------------------------------
+
+public:
+	inline int32_t Length(void) const {
+		return m_length;
+	}
+
+
+	inline int32_t Capacity(void) const {
+		return m_capacity;
+	}
+
+
+	inline bool IsEmpty(void) const {
+		return m_length == 0;
+	}
+
+
+	// true while the items are stored in the object itself
+	inline bool IsInline(void) const {
+		return m_data == reinterpret_cast<const DATA_T*>(m_inline);
+	}
+
+
+	inline int32_t DataSize(void) const {
+		return m_length * int32_t(sizeof(DATA_T));
+	}
+
+
+	inline bool IsValidIndex(int32_t i) const {
+		return (i >= 0) and (i < m_length);
+	}
+
+
+	inline DATA_T* Data(int32_t i = 0) {
+		return m_data + i;
+	}
+
+
+	inline const DATA_T* Data(int32_t i = 0) const {
+		return m_data + i;
+	}
+
+
+	inline DATA_T& operator[](int32_t i) {
+		return m_data[i];
+	}
+
+
+	inline const DATA_T& operator[](int32_t i) const {
+		return m_data[i];
+	}
+
+
+	inline DATA_T* begin() {
+		return m_data;
+	}
+
+
+	inline DATA_T* end() {
+		return m_data + m_length;
+	}
+
+
+	inline const DATA_T* begin() const {
+		return m_data;
+	}
+
+
+	inline const DATA_T* end() const {
+		return m_data + m_length;
+	}
+
+	//----------------------------------------
+
+public:
+	// make room for capacity items, keeping the current ones
+	inline bool Reserve(int32_t capacity) {
+		return (capacity <= m_capacity) or Relocate(capacity);
+	}
+
+
+	// change the number of items; new items are default constructed
+	DATA_T* Resize(int32_t length) {
+		if (length < m_length) {
+			DestroyItems(m_data + length, m_length - length);
+			m_length = length;
+		}
+		else if (length > m_length) {
+			if (not Reserve(length))
+				return nullptr;
+			for (; m_length < length; m_length++)
+				new (m_data + m_length) DATA_T();
+		}
+		return m_data;
+	}
+
+
+	// remove all items, keeping the buffer
+	inline void Reset(void) {
+		DestroyItems(m_data, m_length);
+		m_length = 0;
+	}
+
+
+	// remove all items and return to the inline buffer
+	void Destroy(void) {
+		Reset();
+		if (not IsInline()) {
+			FreeData(m_data);
+			m_data = InlineData();
+			m_capacity = N;
+		}
+	}
+
+
+	void Fill(const DATA_T& value) {
+		std::fill(m_data, m_data + m_length, value);
+	}
+
+	//----------------------------------------
+
+public:
+	template <typename... ARGS>
+	DATA_T* Append(ARGS&&... args) {
+		if (m_length < m_capacity)
+			return new (m_data + m_length++) DATA_T(std::forward<ARGS>(args)...);
+		DATA_T item(std::forward<ARGS>(args)...); // args may refer to an item that growing moves
+		if (not Grow(m_length + 1))
+			return nullptr;
+		return new (m_data + m_length++) DATA_T(std::move(item));
+	}
+
+
+	template <typename T>
+	inline bool Push(T&& data) {
+		return Append(std::forward<T>(data)) != nullptr;
+	}
+
+
+	DATA_T Pop(void) {
+		if (not m_length)
+			return m_none;
+		DATA_T data = std::move(m_data[--m_length]);
+		DestroyItems(m_data + m_length, 1);
+		return data;
+	}
+
+
+	bool Pop(DATA_T& data) {
+		if (not m_length)
+			return false;
+		data = std::move(m_data[--m_length]);
+		DestroyItems(m_data + m_length, 1);
+		return true;
+	}
+
+
+	// insert data in front of item i (i == Length() appends)
+	template <typename T>
+	DATA_T* Insert(int32_t i, T&& data) {
+		if ((i < 0) or (i > m_length))
+			return nullptr;
+		if (i == m_length)
+			return Append(std::forward<T>(data));
+		DATA_T item(std::forward<T>(data)); // data may refer to an item of this array
+		if (not Grow(m_length + 1))
+			return nullptr;
+		new (m_data + m_length) DATA_T(std::move(m_data[m_length - 1]));
+		std::move_backward(m_data + i, m_data + m_length - 1, m_data + m_length);
+		m_length++;
+		m_data[i] = std::move(item);
+		return m_data + i;
+	}
+
+
+	// remove item i, keeping the order of the others
+	bool Delete(int32_t i) {
+		if ((i < 0) or (i >= m_length))
+			return false;
+		std::move(m_data + i + 1, m_data + m_length, m_data + i);
+		DestroyItems(m_data + --m_length, 1);
+		return true;
+	}
+
+
+	// index of the first item equal to data, or -1
+	int32_t Find(const DATA_T& data) const {
+		for (int32_t i = 0; i < m_length; i++)
+			if (m_data[i] == data)
+				return i;
+		return -1;
+	}
+};
+
+// =================================================================================================
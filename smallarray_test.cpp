@@ -0,0 +1,179 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Checks SmallArray and SmallList against std::vector for several inline sizes: random inserts,
+// appends, extractions, copies, moves, splices and filters, move only items, and appending or
+// inserting an item of the array itself while the storage moves from inline to the heap.
+// Returns 0 if all checks pass. Build e.g. with:
+//   c++ -O2 -std=c++20 smallarray_test.cpp
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+
+#include "list.hpp"
+
+// =================================================================================================
+
+static int failures = 0;
+
+static bool Check(bool condition, const char* what, int n) {
+    if (not condition) {
+        fprintf(stderr, "FAILED: %s (N = %d)\n", what, n);
+        ++failures;
+    }
+    return condition;
+}
+
+//-----------------------------------------------------------------------------
+
+template <int32_t N>
+static void TestSmallList(unsigned seed)
+{
+    std::mt19937 rng(seed);
+    SmallList<std::string, N> l;
+    std::vector<std::string> v;
+    for (int step = 0; step < 20000; step++) {
+        int op = rng() % 10, n = int(v.size());
+        std::string s = std::to_string(rng() % 50) + std::string((rng() % 2) ? 30 : 1, 'x');
+        if ((op < 3) and (n < 40)) {
+            int i = rng() % (n + 1);
+            l.Insert(i, s);
+            v.insert(v.begin() + i, s);
+        }
+        else if ((op < 4) and (n < 40)) {
+            l.Append(s);
+            v.push_back(s);
+        }
+        else if ((op < 5) and n) {
+            int i = rng() % n;
+            if (not Check(l.Extract(i) == v[i], "SmallList::Extract", N))
+                return;
+            v.erase(v.begin() + i);
+        }
+        else if ((op < 6) and n) {
+            int i = -1 - int(rng() % n);
+            l.Discard(i);
+            v.erase(v.end() + i);
+        }
+        else if (op < 7) {
+            auto it = std::find(v.begin(), v.end(), s);
+            if (not Check(l.Remove(s) == (it != v.end()), "SmallList::Remove", N))
+                return;
+            if (it != v.end())
+                v.erase(it);
+        }
+        else if (op < 8) {
+            auto c = l;
+            c += c;
+            auto d = std::move(c);
+            SmallList<std::string, N> e;
+            e += std::move(d);
+            if (not Check((e.Length() == 2 * n) and (d.Length() == 0), "SmallList copy, move and +=", N))
+                return;
+            l = e.Splice(0, n);
+        }
+        else if (op < 9) {
+            char c = char('0' + rng() % 10);
+            l.Filter([c](std::string& s) { return s[0] == c; });
+            v.erase(std::remove_if(v.begin(), v.end(), [c](std::string& s) { return s[0] == c; }), v.end());
+        }
+        else if (n) {
+            int i = rng() % n;
+            if (not Check((l[i] == v[i]) and (l[-1] == v.back()), "SmallList::operator[]", N))
+                return;
+        }
+        if (not Check(l.Length() == int32_t(v.size()), "SmallList::Length", N))
+            return;
+        int k = 0;
+        for (auto& d : l)
+            if (not Check(d == v[k++], "SmallList iteration", N))
+                return;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+template <int32_t N>
+static void TestSmallArray(void)
+{
+    SmallArray<std::unique_ptr<int>, N> a;
+    for (int i = 0; i < 20; i++)
+        a.Append(new int(i));
+    a.Insert(3, std::make_unique<int>(99));
+    a.Delete(0);
+    Check((*a[2] == 99) and (a.Length() == 20) and not a.IsInline(), "SmallArray with move only items", N);
+    SmallArray<std::unique_ptr<int>, N> b(std::move(a));
+    a = std::move(b);
+    a.Resize(2);
+    a.Destroy();
+    Check(a.IsInline(), "SmallArray::Destroy returns to inline storage", N);
+
+    SmallArray<int, N> c{ 1, 2, 3 };
+    c.Resize(5);
+    Check((c[4] == 0) and (c.Find(3) == 2) and (c.Pop() == 0), "SmallArray::Resize, Find and Pop", N);
+}
+
+//-----------------------------------------------------------------------------
+
+// appending or inserting an item of the array itself when the array is full: the item must be
+// copied before growing moves (and destroys) the source
+template <int32_t N>
+static void TestSelfReference(void)
+{
+    SmallArray<std::string, N> a;
+    std::vector<std::string> v;
+    for (int i = 0; i < 4 * N + 1; i++) {
+        std::string s = std::string(40, char('a' + i % 26)); // too long for the small string buffer
+        if (i == 0) {
+            a.Append(s);
+            v.push_back(s);
+        }
+        else if (i % 2) {
+            a.Append(a[0]);
+            v.push_back(v[0]);
+        }
+        else {
+            a.Insert(a.Length(), a[a.Length() - 1]);
+            v.push_back(v.back());
+        }
+    }
+    bool same = (a.Length() == int32_t(v.size()));
+    for (int32_t i = 0; same and (i < a.Length()); i++)
+        same = (a[i] == v[i]);
+    Check(same, "SmallArray::Append and Insert of own items while growing", N);
+
+    SmallList<std::string, N> l;
+    l.Append(std::string(40, 'z'));
+    for (int i = 0; i < 2 * N; i++)
+        l.Append(l[0]);
+    bool allZ = (l.Length() == 2 * N + 1);
+    for (auto& s : l)
+        allZ = allZ and (s == std::string(40, 'z'));
+    Check(allZ, "SmallList::Append of own items while growing", N);
+}
+
+// =================================================================================================
+
+int main()
+{
+    for (unsigned seed = 1; seed < 4; seed++) {
+        TestSmallList<1>(seed);
+        TestSmallList<4>(seed);
+        TestSmallList<16>(seed);
+    }
+    TestSmallArray<1>();
+    TestSmallArray<4>();
+    TestSmallArray<16>();
+    TestSelfReference<1>();
+    TestSelfReference<4>();
+    TestSelfReference<8>();
+    fprintf(stderr, "%s\n", failures ? "smallarray_test failed" : "smallarray_test passed");
+    return failures ? 1 : 0;
+}
+
+// =================================================================================================
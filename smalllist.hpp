@@ -0,0 +1,269 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+#pragma once
+
+#include <utility>
+#include <initializer_list>
+
+#include <stdint.h>
+
+#include "smallarray.hpp"
+
+// =================================================================================================
+// List for short sequences: it has the item interface of List and SegmentedList (Insert, Append,
+// Extract, Discard, Find, Remove, Filter, Splice, +=, negative indices counting from the end),
+// but keeps its items contiguously in a SmallArray. The first N items are stored in the object
+// itself, so a list that never exceeds N items doesn't allocate at all. Inserting and removing in
+// the middle shifts the following items, which for a few items is cheaper than following node
+// links. Pointers to items are invalidated by inserting and removing items.
+
+template <typename DATA_T, int32_t N = 8>
+class SmallList {
+private:
+	SmallArray<DATA_T, N>	m_items;
+	DATA_T					m_none;
+	bool					m_result;
+
+	// translate a negative index (counting from the end); last is the highest valid index
+	inline int Position(int i, int32_t last) const {
+		return (i < 0) ? i + last + 1 : i;
+	}
+
+public:
+	using Iterator = DATA_T*;
+
+	SmallList()
+		: m_none(DATA_T()), m_result(true)
+	{
+	}
+
+
+	SmallList(std::initializer_list<DATA_T> data)
+		: m_items(data), m_none(DATA_T()), m_result(true)
+	{
+	}
+
+
+	SmallList(const SmallList& other) = default;
+
+
+	SmallList(SmallList&& other) noexcept
+		: m_items(std::move(other.m_items)), m_none(DATA_T()), m_result(true)
+	{
+	}
+
+
+	SmallList& operator= (const SmallList& other) = default;
+
+
+	SmallList& operator= (SmallList&& other) noexcept {
+		m_items = std::move(other.m_items);
+		return *this;
+	}
+
+
+	SmallList& operator= (std::initializer_list<DATA_T> data) {
+		m_items = data;
+		return *this;
+	}
+
+
+	inline void Clear(void) {
+		m_items.Reset();
+	}
+
+
+	inline void Destroy(void) {
+		m_items.Destroy();
+	}
+
+
+	inline DATA_T* begin() {
+		return m_items.begin();
+	}
+
+
+	inline DATA_T* end() {
+		return m_items.end();
+	}
+
+
+	inline const DATA_T* begin() const {
+		return m_items.begin();
+	}
+
+
+	inline const DATA_T* end() const {
+		return m_items.end();
+	}
+
+
+	inline int32_t Length(void) const {
+		return m_items.Length();
+	}
+
+
+	inline bool IsEmpty(void) const {
+		return m_items.IsEmpty();
+	}
+
+
+	inline bool IsInline(void) const {
+		return m_items.IsInline();
+	}
+
+
+	inline bool Result(void) {
+		return m_result;
+	}
+
+
+	inline DATA_T& operator[] (int i) {
+		i = Position(i, Length() - 1);
+		if (not (m_result = m_items.IsValidIndex(i)))
+			return m_none;
+		return m_items[i];
+	}
+
+	//-----------------------------------------------------------------------------
+	// insert data in front of item i; i == Length() or -1 appends data
+
+public:
+	template<typename T>
+	DATA_T* Insert(int i, T&& data) {
+		DATA_T* item = m_items.Insert(Position(i, Length()), std::forward<T>(data));
+		m_result = (item != nullptr);
+		return item;
+	}
+
+	inline DATA_T* Insert(int i) {
+		return Insert(i, DATA_T());
+	}
+
+	template<typename T>
+	inline DATA_T* Append(T&& data) {
+		DATA_T* item = m_items.Append(std::forward<T>(data));
+		m_result = (item != nullptr);
+		return item;
+	}
+
+	inline DATA_T* Append(void) {
+		return Append(DATA_T());
+	}
+
+	//-----------------------------------------------------------------------------
+
+public:
+	DATA_T Extract(int i) {
+		DATA_T data;
+		if (not Extract(data, i))
+			return m_none;
+		return data;
+	}
+
+
+	bool Extract(DATA_T& data, int i) {
+		i = Position(i, Length() - 1);
+		if (not m_items.IsValidIndex(i))
+			return m_result = false;
+		data = std::move(m_items[i]);
+		m_items.Delete(i);
+		return m_result = true;
+	}
+
+
+	bool Discard(int i) {
+		return m_result = m_items.Delete(Position(i, Length() - 1));
+	}
+
+	//-----------------------------------------------------------------------------
+
+public:
+	template<typename T>
+	int Find(T&& data) {
+		DATA_T pattern = std::forward<T>(data);
+		return m_items.Find(pattern);
+	}
+
+
+	template<typename T>
+	inline bool Remove(T&& data) {
+		int i = Find(std::forward<T>(data));
+		if (i < 0)
+			return (m_result = false);
+		return Discard(i);
+	}
+
+
+	// remove all items for which filter returns true
+	template<typename FILTER_T>
+	int32_t Filter(FILTER_T filter) {
+		int32_t length = Length();
+		int32_t n = 0;
+		for (int32_t i = 0; i < length; i++) {
+			if (filter(m_items[i]))
+				continue;
+			if (n < i)
+				m_items[n] = std::move(m_items[i]);
+			n++;
+		}
+		m_items.Resize(n);
+		return length - n;
+	}
+
+	//-----------------------------------------------------------------------------
+	// return a copy of items [from, to); to == 0 copies up to the end of the list
+
+public:
+	SmallList Splice(int32_t from, int32_t to = 0) {
+		SmallList l;
+		if (to <= 0)
+			to += Length();
+		if ((from >= 0) and (from < to) and (to <= Length())) {
+			l.m_items.Reserve(to - from);
+			for (int32_t i = from; i < to; i++)
+				l.Append(m_items[i]);
+		}
+		return l;
+	}
+
+	//-----------------------------------------------------------------------------
+	// copy the other list to the end of this list
+	// will leave other list intact
+
+public:
+	SmallList& operator+= (const SmallList& other) {
+		int32_t length = other.Length(); // other may be this list
+		if (m_items.Reserve(Length() + length)) {
+			for (int32_t i = 0; i < length; i++)
+				m_items.Append(other.m_items[i]);
+		}
+		return *this;
+	}
+
+
+	// move the items of other to the end of this list; will leave other empty
+	SmallList& operator+= (SmallList&& other) {
+		if (&other == this)
+			return *this;
+		if (IsEmpty())
+			m_items = std::move(other.m_items);
+		else if (m_items.Reserve(Length() + other.Length())) {
+			for (auto& d : other.m_items)
+				m_items.Append(std::move(d));
+			other.Clear();
+		}
+		return *this;
+	}
+
+
+	SmallList operator+ (const SmallList& other) {
+		SmallList l(*this);
+		l += other;
+		return l;
+	}
+};
+
+// =================================================================================================
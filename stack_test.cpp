@@ -0,0 +1,111 @@
+// Copyright (c) 2025 Dietfrid Mali
+// This software is licensed under the MIT License.
+// See the LICENSE file for more details.
+
+// Checks Stack against std::vector: pushes, pops, deletions with and without reordering while the
+// stack grows, and pushing an item of the stack itself when it has to grow. Stack requires the
+// custom ManagedArray. Returns 0 if all checks pass. Build e.g. with:
+//   c++ -O2 -std=c++20 stack_test.cpp
+
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+
+#include "stack.hpp"
+
+// =================================================================================================
+
+static int failures = 0;
+
+static bool Check(bool condition, const char* what) {
+    if (not condition) {
+        fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+    return condition;
+}
+
+//-----------------------------------------------------------------------------
+
+static bool Matches(Stack<std::string>& s, const std::vector<std::string>& v) {
+    if (s.ToS() != int32_t(v.size()))
+        return false;
+    for (int32_t i = 0; i < s.ToS(); i++)
+        if (*s.GetRef(i) != v[i])
+            return false;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestRandomOps(bool reorder)
+{
+    std::mt19937 rng(reorder ? 2 : 1);
+    Stack<std::string> s(4, 4, reorder);
+    std::vector<std::string> v;
+    for (int step = 0; step < 20000; step++) {
+        int op = rng() % 8;
+        if ((op < 4) and (v.size() < 500)) {
+            std::string item = std::to_string(rng() % 100) + std::string(30, 'x');
+            s.Push(item);
+            v.push_back(item);
+        }
+        else if ((op < 6) and not v.empty()) {
+            if (not Check(s.Pop() == v.back(), "Pop"))
+                return;
+            v.pop_back();
+        }
+        else if (not v.empty()) {
+            int32_t i = int32_t(rng() % v.size());
+            if (not Check(s.Find(v[i]) == int32_t(std::find(v.begin(), v.end(), v[i]) - v.begin()), "Find"))
+                return;
+            s.Delete(i);
+            if (not reorder)
+                v.erase(v.begin() + i);
+            else { // the top item takes the place of the deleted one
+                v[i] = v.back();
+                v.pop_back();
+            }
+        }
+        if (not Check(Matches(s, v), reorder ? "random operations with reordering" : "random operations"))
+            return;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+// pushing an item of the stack itself when the stack is full: the item must be copied before
+// growing moves (and releases) the source
+static void TestSelfReference(void)
+{
+    Stack<std::string> s(2, 2);
+    std::vector<std::string> v;
+    s.Push(std::string(40, 'a'));
+    v.push_back(std::string(40, 'a'));
+    for (int i = 0; i < 100; i++) {
+        if (i % 2) {
+            s.Push(*s.Data(0));
+            v.push_back(v[0]);
+        }
+        else {
+            s.Push(*s.Top());
+            v.push_back(v.back());
+        }
+    }
+    Check(Matches(s, v), "Push of own items while growing");
+}
+
+// =================================================================================================
+
+int main()
+{
+    TestRandomOps(false);
+    TestRandomOps(true);
+    TestSelfReference();
+    fprintf(stderr, "%s\n", failures ? "stack_test failed" : "stack_test passed");
+    return failures ? 1 : 0;
+}
+
+// =================================================================================================
@@ -4,6 +4,11 @@
 #include <cstdint>
 #include <cassert>
 #include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+
+#include "arraykernels.hpp"
+#include "gridlayout.hpp"
 
 // =================================================================================================
 
@@ -13,6 +18,43 @@ private:
     std::vector<DATA_T> m_array;
     int32_t m_width = 0;
     int32_t m_height = 0;
+    GridLayout m_grid; // storage order of width x height grids
+
+    static void FillItems(DATA_T* items, int32_t count, const DATA_T& value) {
+        if constexpr (std::is_arithmetic_v<DATA_T>)
+            ArrayKernels<DATA_T>::Fill(items, count, value);
+        else
+            std::fill_n(items, count, value);
+    }
+
+    static int32_t FindItem(const DATA_T* items, int32_t count, const DATA_T& value) {
+        if constexpr (std::is_arithmetic_v<DATA_T>)
+            return ArrayKernels<DATA_T>::Find(items, count, value);
+        else {
+            const DATA_T* item = std::find(items, items + count, value);
+            return (item == items + count) ? -1 : static_cast<int32_t>(item - items);
+        }
+    }
+
+    static bool MinMaxItems(const DATA_T* items, int32_t count, DATA_T& minValue, DATA_T& maxValue) {
+        if constexpr (std::is_arithmetic_v<DATA_T>)
+            return ArrayKernels<DATA_T>::MinMax(items, count, minValue, maxValue);
+        else {
+            if (not count)
+                return false;
+            auto range = std::minmax_element(items, items + count);
+            minValue = *range.first;
+            maxValue = *range.second;
+            return true;
+        }
+    }
+
+    static bool EqualItems(const DATA_T* a, const DATA_T* b, int32_t count) {
+        if constexpr (std::is_arithmetic_v<DATA_T>)
+            return ArrayKernels<DATA_T>::Equal(a, b, count);
+        else
+            return std::equal(a, a + count, b);
+    }
 
 public:
     // Konstruktor fr 1D-ManagedArray
@@ -29,6 +71,7 @@ public:
         : m_array(static_cast<size_t>(width)* static_cast<size_t>(height)),
         m_width(width), m_height(height) {
         assert(width * height > 0 && "Width and height must be > 0");
+        m_grid.Resize(width, height);
 #if defined(_DEBUG)
         if (width * height <= 0)
             throw std::invalid_argument("ManagedArray: invalid width or height arguments (must both be > 0)");
@@ -36,25 +79,33 @@ public:
     }
 
     ManagedArray(const ManagedArray& other)
-        : m_array(other.m_array) {
+        : m_array(other.m_array), m_width(other.m_width), m_height(other.m_height), m_grid(other.m_grid) {
     }
 
     // Move-Konstruktor
     ManagedArray(ManagedArray&& other) noexcept
-        : m_array(std::move(other.m_array)) 
+        : m_array(std::move(other.m_array)), m_width(other.m_width), m_height(other.m_height), m_grid(other.m_grid)
     { }
 
     // Copy-Zuweisungsoperator
     ManagedArray& operator=(const ManagedArray& other) {
-        if (this != &other)
+        if (this != &other) {
             m_array = other.m_array;
+            m_width = other.m_width;
+            m_height = other.m_height;
+            m_grid = other.m_grid;
+        }
         return *this;
     }
 
     // Move-Zuweisungsoperator
     ManagedArray& operator=(ManagedArray&& other) noexcept {
-        if (this != &other)
+        if (this != &other) {
             m_array = std::move(other.m_array);
+            m_width = other.m_width;
+            m_height = other.m_height;
+            m_grid = other.m_grid;
+        }
         return *this;
     }
 
@@ -93,9 +144,9 @@ public:
     inline DATA_T& operator()(int32_t x, int32_t y) {
         assert(m_width > 0 && m_height > 0);
 #if defined(_DEBUG)
-        return m_array.at(static_cast<size_t>(y) * static_cast<size_t>(m_width) + static_cast<size_t>(x));
+        return m_array.at(static_cast<size_t>(m_grid.Index(x, y)));
 #else
-        return m_array[static_cast<size_t>(y) * static_cast<size_t>(m_width) + static_cast<size_t>(x)];
+        return m_array[static_cast<size_t>(m_grid.Index(x, y))];
 #endif
     }
 
@@ -103,7 +154,7 @@ public:
 
     inline bool IsValidIndex(int32_t x, int32_t y) { return (x >= 0) and (x < m_width) and (y >= 0) and (y < m_height); }
 
-    inline int GetCheckedIndex(int32_t x, int32_t y) { return IsValidIndex(x, y) ?int(y * m_width + x) : -1; }
+    inline int GetCheckedIndex(int32_t x, int32_t y) { return IsValidIndex(x, y) ? int(m_grid.Index(x, y)) : -1; }
 
     inline DATA_T* operator()(int32_t x, int32_t y, bool rangeCheck) { // always checks range; parameter only to distinguish from other operator()
         int i = GetCheckedIndex(x, y);
@@ -113,16 +164,94 @@ public:
     inline const DATA_T& operator()(int32_t x, int32_t y) const {
         assert(m_width > 0 && m_height > 0);
 #if defined(_DEBUG)
-        return m_array.at(static_cast<size_t>(y) * static_cast<size_t>(m_width) + static_cast<size_t>(x));
+        return m_array.at(static_cast<size_t>(m_grid.Index(x, y)));
 #else
-        return m_array[static_cast<size_t>(y) * static_cast<size_t>(m_width) + static_cast<size_t>(x)];
+        return m_array[static_cast<size_t>(m_grid.Index(x, y))];
 #endif
     }
 
     void Append(const DATA_T& data) { m_array.push_back(data); }
 
+    // Fill, Find, MinMax, Sum and operator== skip the padding of tiled grids (see GridLayout::ForEachRun)
     void Fill(DATA_T value) {
-        std::fill(m_array.begin(), m_array.end(), value);
+        m_grid.ForEachRun(Length(), [&](int32_t i, int32_t n) { FillItems(Data(i), n, value); return true; });
+    }
+
+    // index of the first item equal to value, or -1
+    int32_t Find(const DATA_T& value) const {
+        int32_t found = -1;
+        m_grid.ForEachRun(Length(), [&](int32_t i, int32_t n) {
+            int32_t j = FindItem(Data(i), n, value);
+            if (j < 0)
+                return true;
+            found = i + j;
+            return false;
+        });
+        return found;
+    }
+
+    // false if the array is empty
+    bool MinMax(DATA_T& minValue, DATA_T& maxValue) const {
+        bool found = false;
+        m_grid.ForEachRun(Length(), [&](int32_t i, int32_t n) {
+            DATA_T runMin, runMax;
+            if (MinMaxItems(Data(i), n, runMin, runMax)) {
+                if (not found) {
+                    minValue = runMin;
+                    maxValue = runMax;
+                    found = true;
+                }
+                else {
+                    if (runMin < minValue)
+                        minValue = runMin;
+                    if (maxValue < runMax)
+                        maxValue = runMax;
+                }
+            }
+            return true;
+        });
+        return found;
+    }
+
+    DATA_T Min(void) const {
+        DATA_T minValue, maxValue;
+        return MinMax(minValue, maxValue) ? minValue : DATA_T();
+    }
+
+    DATA_T Max(void) const {
+        DATA_T minValue, maxValue;
+        return MinMax(minValue, maxValue) ? maxValue : DATA_T();
+    }
+
+    // 64 bit sum for integers, double for float
+    auto Sum(void) const {
+        typename ArrayKernels<DATA_T>::SUM_T sum = 0;
+        m_grid.ForEachRun(Length(), [&](int32_t i, int32_t n) { sum += ArrayKernels<DATA_T>::Sum(Data(i), n); return true; });
+        return sum;
+    }
+
+    // tiled grids are equal if their cells (and the items beyond the grid) are, whatever their storage order
+    bool operator==(const ManagedArray& other) const {
+        bool isGrid = m_grid.IsTiled() and m_grid.HoldsGrid(Length());
+        bool otherIsGrid = other.m_grid.IsTiled() and other.m_grid.HoldsGrid(other.Length());
+        if ((isGrid or otherIsGrid) and not (m_grid == other.m_grid)) {
+            if ((m_width != other.m_width) or (m_height != other.m_height)
+                or not m_grid.HoldsGrid(Length()) or not other.m_grid.HoldsGrid(other.Length())
+                or (Length() - m_grid.Size() != other.Length() - other.m_grid.Size()))
+                return false;
+            for (int32_t y = 0; y < m_height; y++)
+                for (int32_t x = 0; x < m_width; x++)
+                    if (not (m_array[m_grid.Index(x, y)] == other.m_array[other.m_grid.Index(x, y)]))
+                        return false;
+            return EqualItems(Data(m_grid.Size()), other.Data(other.m_grid.Size()), Length() - m_grid.Size());
+        }
+        if (Length() != other.Length())
+            return false;
+        return m_grid.ForEachRun(Length(), [&](int32_t i, int32_t n) { return EqualItems(Data(i), other.Data(i), n); });
+    }
+
+    bool operator!=(const ManagedArray& other) const {
+        return not (*this == other);
     }
 
     DATA_T* Append(void) { 
@@ -151,18 +280,23 @@ public:
 
     inline const DATA_T* Data(int32_t i = 0) const { return m_array.data() + i; }
 
+    // rows are only contiguous in row major order; nullptr for tiled grids (see TileRow)
     DATA_T* DataRow(int32_t y) {
 #if defined(_DEBUG)
         if (m_width * m_height <= 0)
             throw std::invalid_argument("ManagedArray: invalid width or height arguments (must both be > 0)");
 #endif    
-        return Data(y * m_width);
+        return m_grid.IsTiled() ? nullptr : Data(y * m_width);
     }
 
     inline void Reserve(int32_t capacity) {
         m_array.reserve(static_cast<size_t>(capacity));
     }
 
+    inline void ShrinkToFit(void) {
+        m_array.shrink_to_fit();
+    }
+
     // Resize-Methoden
     inline DATA_T* Resize(int32_t newSize) {
         m_array.resize(static_cast<size_t>(newSize));
@@ -170,12 +304,39 @@ public:
     }
 
     inline DATA_T* Resize(int32_t width, int32_t height) {
-        m_array.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
         m_width = width; 
         m_height = height; 
+        m_grid.Resize(width, height);
+        m_array.resize(static_cast<size_t>(m_grid.Size()));
         return Data();
     }
 
+    // store the width x height grid in the given order (see gridlayout.hpp), rearranging the cells it holds
+    bool SetLayout(GridOrder order, int32_t tileShift = GridLayout::defaultTileShift) {
+        GridLayout layout(order, tileShift);
+        layout.Resize(m_width, m_height);
+        bool holdsGrid = (m_width * m_height > 0) and (Length() >= m_grid.Size());
+        if (holdsGrid and ((layout.order != m_grid.order) or (layout.tileShift != m_grid.tileShift))) {
+            std::vector<DATA_T> cells(static_cast<size_t>(layout.Size()));
+            for (int32_t y = 0; y < m_height; y++)
+                for (int32_t x = 0; x < m_width; x++)
+                    cells[layout.Index(x, y)] = std::move(m_array[m_grid.Index(x, y)]);
+            m_array = std::move(cells);
+        }
+        m_grid = layout;
+        return true;
+    }
+
+    inline const GridLayout& Layout(void) const { return m_grid; }
+
+    inline GridTiles Tiles(void) const { return GridTiles(m_grid); }
+
+    // the cells [tile.x0, tile.x1) of row y, which are contiguous unless the grid has Morton order (nullptr then)
+    inline DATA_T* TileRow(const GridTile& tile, int32_t y) {
+        int32_t i = m_grid.RowIndex(tile, y);
+        return (i < 0) ? nullptr : Data(i);
+    }
+
     inline void Reset(void) {
         m_array.clear();
     }
@@ -207,6 +368,7 @@ public:
     inline operator const std::vector<DATA_T>& () const { return m_array; }
 
     template <typename Predicate>
+        requires std::is_invocable_v<Predicate, DATA_T&>
     auto Find(Predicate compare) {
         return std::find_if(m_array.begin(), m_array.end(), compare);
     }
@@ -1,6 +1,7 @@
 #include <map>
 #include <initializer_list>
 #include <utility>
+#include <iterator>
 
 template <typename KEY_T, typename DATA_T>
 class StdMap
@@ -44,6 +45,56 @@ public:
         return m_map.end();
     }
 
+    using Iterator = typename std::map<KEY_T, DATA_T>::iterator;
+
+    struct IteratorRange {
+        Iterator first;
+        Iterator last;
+
+        inline Iterator begin() const { return first; }
+        inline Iterator end() const { return last; }
+    };
+
+    inline Iterator begin() { return m_map.begin(); }
+
+    inline Iterator end() { return m_map.end(); }
+
+    inline Iterator LowerBound(const KEY_T& key) { return m_map.lower_bound(key); }
+
+    inline Iterator UpperBound(const KEY_T& key) { return m_map.upper_bound(key); }
+
+    inline IteratorRange EqualRange(const KEY_T& key) {
+        auto range = m_map.equal_range(key);
+        return IteratorRange{ range.first, range.second };
+    }
+
+    IteratorRange Range(const KEY_T& lo, const KEY_T& hi) {
+        Iterator first = m_map.lower_bound(lo);
+        return IteratorRange{ first, (lo < hi) ? m_map.lower_bound(hi) : first };
+    }
+
+    // std::map has no subtree sizes, so these are linear in the number of keys
+    DATA_T* Select(int k) {
+        if ((k < 0) or (k >= Size()))
+            return nullptr;
+        return &std::next(m_map.begin(), k)->second;
+    }
+
+    const KEY_T* SelectKey(int k) {
+        if ((k < 0) or (k >= Size()))
+            return nullptr;
+        return &std::next(m_map.begin(), k)->first;
+    }
+
+    int Rank(const KEY_T& key) {
+        return static_cast<int>(std::distance(m_map.begin(), m_map.lower_bound(key)));
+    }
+
+    inline int CountRange(const KEY_T& lo, const KEY_T& hi) {
+        int count = Rank(hi) - Rank(lo);
+        return (count > 0) ? count : 0;
+    }
+
     bool Extract(const KEY_T& key, DATA_T& data) {
         auto it = m_map.find(key);
         if (it == m_map.end())
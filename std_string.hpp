@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <list>
 #include <initializer_list>
 #include <sstream>
@@ -139,9 +140,18 @@ public:
 
     static String Concat(std::initializer_list<String> values);
 
-    static int Compare(void* context, const String& s1, const String& s2) {
+    static int Compare(void* /*context*/, const String& s1, const String& s2) {
         return (s1.Length() or s2.Length()) ? strcmp(static_cast<const char*>(s1), static_cast<const char*>(s2)) : 0;
     }
+
+    // Heterogeneous comparison, lets String keyed AVLTrees be searched without building a temporary String
+    static int Compare(void* /*context*/, const char* const& s1, const String& s2) {
+        return strcmp(s1 ? s1 : "", static_cast<const char*>(s2));
+    }
+
+    static int Compare(void* /*context*/, const std::string_view& s1, const String& s2) {
+        return s1.compare(std::string_view(static_cast<const char*>(s2), size_t(s2.Length())));
+    }
 };
 
 // ---------- Inline-Funktionen (kurze Operatoren & Zuweisungen) ----------
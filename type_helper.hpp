@@ -6,6 +6,15 @@
 template <auto Member>
 constexpr bool is_static_member_v = !std::is_member_object_pointer_v<decltype(Member)>;
 
+// Types whose objects may be moved to another address by copying their bytes, without running
+// their move constructor and destructor. Trivially copyable types qualify; specialize the template
+// for other types that do (e.g. types that only hold pointers to heap memory they own).
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
 template<typename T>
 void InitializeAnyType(T& v) {
     if constexpr (std::is_array_v<T>) {